@@ -0,0 +1,78 @@
+// BLE links: the Meshtastic ToRadio/FromRadio service and MeshCore's Nordic UART service
+#ifndef BLE_TRANSPORT_H
+#define BLE_TRANSPORT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <NimBLEClient.h>
+#include <NimBLERemoteCharacteristic.h>
+#include "transport.h"
+
+// One FromRadio payload per characteristic read, no stream framing. The
+// FromNum notify only says data is waiting; poll() reads until it's drained.
+class BleMeshtasticTransport : public ITransport {
+public:
+    TransportKind kind() const override { return TRANSPORT_BLE_MESHTASTIC; }
+    const char *name() const override { return "BLE"; }
+    TransportState state() const override;
+
+    // Write-with-response; a failed write retries once after securing the link,
+    // which is what prompts for a PIN on first use
+    bool send(uint8_t *frame, size_t payloadLen) override;
+    size_t poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) override;
+    bool signalsRx() const override { return true; }  // FromNum notify
+
+    void attach(NimBLEClient *client, NimBLERemoteCharacteristic *toRadio, NimBLERemoteCharacteristic *fromRadio);
+    void detach();
+
+private:
+    NimBLEClient *client = nullptr;
+    NimBLERemoteCharacteristic *toRadio = nullptr;
+    NimBLERemoteCharacteristic *fromRadio = nullptr;
+};
+
+// MeshCore companion protocol: each write is one command frame, responses
+// arrive as TX notifications. The notify callback runs on the NimBLE host
+// task and only copies the payload into a preallocated single-producer /
+// single-consumer ring; poll() hands the frames to the main loop, which
+// decodes them (see MeshtasticClient::onMeshCoreFrame).
+class BleMeshCoreTransport : public ITransport {
+public:
+    static constexpr size_t NOTIFY_SLOTS = 32;       // Power of two; covers a contact list burst
+    static constexpr size_t NOTIFY_SLOT_SIZE = 256;  // Companion frames are at most 172 bytes
+
+    TransportKind kind() const override { return TRANSPORT_BLE_MESHCORE; }
+    const char *name() const override { return "BLE"; }
+    TransportState state() const override;
+
+    bool send(uint8_t *frame, size_t payloadLen) override;
+    size_t poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) override;
+    bool signalsRx() const override { return true; }  // Every notification is a frame
+
+    void attach(NimBLEClient *client, NimBLERemoteCharacteristic *rx);
+    void detach();
+    // NimBLE host task only: copies one notification in, never blocks or
+    // allocates. False if the ring is full or the frame is too large.
+    bool pushNotify(const uint8_t *data, size_t length);
+    // Notifications lost to a full ring or oversize frames
+    uint32_t droppedNotifies() const { return notifyDropped.load(std::memory_order_relaxed); }
+    // Notifications waiting to be polled
+    size_t queuedNotifies() const {
+        return notifyHead.load(std::memory_order_acquire) - notifyTail.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct NotifySlot {
+        uint16_t len;
+        uint8_t data[NOTIFY_SLOT_SIZE];
+    };
+
+    NimBLEClient *client = nullptr;
+    NimBLERemoteCharacteristic *rx = nullptr;
+    NotifySlot notifyRing[NOTIFY_SLOTS];
+    std::atomic<uint32_t> notifyHead{0};  // Next slot to fill; written by the producer only
+    std::atomic<uint32_t> notifyTail{0};  // Next slot to read; written by the consumer only
+    std::atomic<uint32_t> notifyDropped{0};
+};
+
+#endif // BLE_TRANSPORT_H
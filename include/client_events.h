@@ -0,0 +1,181 @@
+#ifndef CLIENT_EVENTS_H
+#define CLIENT_EVENTS_H
+
+#include <Arduino.h>
+#include <vector>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+enum ClientEventType : uint8_t {
+    EVT_NODE_CHANGED = 0,         // One node: id and NODE_CHANGE_* mask
+    EVT_NODE_LIST_CHANGED,        // Whole list: node DB progress/completion, own node info
+    EVT_MESSAGE_ADDED,            // A message went into the history
+    EVT_ACK_UPDATED,              // Delivery status of one of our messages changed
+    EVT_TRACE_ROUTE_RESULT,
+    EVT_CONNECTION_STATE_CHANGED,
+    EVT_NOTICE,                   // One-line status text for the header
+    EVT_UI_REQUEST                // The link flows need a dialog: UI_REQ_* kind
+};
+
+// EVT_MESSAGE_ADDED flags
+enum : uint8_t {
+    MSG_EVENT_ALERT = 1 << 0,      // Popup and ringtone
+    MSG_EVENT_BROADCAST = 1 << 1,  // Channel ringtone rather than the DM one
+    MSG_EVENT_TOAST = 1 << 2       // Header line when the Messages tab isn't showing
+};
+
+enum NoticeLevel : uint8_t {
+    NOTICE_INFO = 0,
+    NOTICE_SUCCESS,
+    NOTICE_ERROR
+};
+
+// EVT_UI_REQUEST kinds, from the BLE connect, scan and pairing flows. These
+// run on the NimBLE host and connect tasks, so the UI does its own modal work
+// when it drains them instead of having its fields written underneath it.
+enum UiRequestKind : uint8_t {
+    UI_REQ_CLOSE_MODAL = 0,     // Clear the way for a pairing dialog
+    UI_REQ_BLE_PIN_ENTRY,       // The radio wants its PIN typed in
+    UI_REQ_BLE_TARGET           // text: address to offer for the next connect
+};
+
+// Meshtastic caps a RouteDiscovery at 8 hops each way
+#define MAX_TRACE_HOPS 8
+#define MAX_NOTICE_TEXT 48
+
+struct ClientEvent {
+    ClientEventType type;
+    union {
+        struct {
+            uint32_t id;
+            uint8_t mask;
+        } node;
+        struct {
+            uint32_t historySeq;  // See MeshtasticClient::addMessageToHistory
+            uint8_t flags;
+        } message;
+        struct {
+            uint32_t packetId;
+            uint8_t status;       // MessageStatus
+            uint8_t failReason;
+        } ack;
+        struct {
+            uint32_t target;
+            uint8_t hops;
+            uint8_t hopsBack;
+            uint32_t route[MAX_TRACE_HOPS];
+            float snr[MAX_TRACE_HOPS + 1];  // One more than hops: the last leg
+            uint32_t routeBack[MAX_TRACE_HOPS];
+            float snrBack[MAX_TRACE_HOPS + 1];
+            uint8_t snrCount;
+            uint8_t snrBackCount;
+        } trace;
+        struct {
+            uint8_t state;        // ConnectionState
+            uint8_t link;         // TransportKind
+        } connection;
+        struct {
+            uint8_t level;        // NoticeLevel
+            char text[MAX_NOTICE_TEXT];
+        } notice;
+        struct {
+            uint8_t kind;         // UiRequestKind
+            char text[MAX_NOTICE_TEXT];
+        } request;
+    };
+};
+
+// Fixed-capacity broadcast ring from the client to its consumers (the UI,
+// notifications). Posting never blocks or allocates; each consumer keeps
+// its own read position and drains at its own cadence, so a burst of events
+// is handled in one pass. A consumer that falls more than CAPACITY behind
+// loses the oldest events and is told so through takeMissed(). Most events
+// are hints with the state itself in the client snapshot, but the one-shots
+// (a dialog request, a message popup, a trace route result) have nothing
+// behind them: the newest of each kind is also kept in a latch that ring
+// traffic can't overwrite, and a consumer that lost one to the ring gets it
+// from the latch, in posting order, before the events it didn't lose.
+class ClientEventBus {
+public:
+    static constexpr uint32_t CAPACITY = 32;  // Power of two
+
+    enum LatchSlot : uint8_t {
+        LATCH_CLOSE_MODAL = 0,
+        LATCH_BLE_PIN_ENTRY,
+        LATCH_BLE_TARGET,
+        LATCH_MESSAGE_ALERT,     // EVT_MESSAGE_ADDED with a popup or header toast
+        LATCH_TRACE_ROUTE,
+        LATCH_COUNT
+    };
+
+    class Subscriber {
+    public:
+        Subscriber() = default;
+        // Copies out the next event; false once caught up
+        bool next(ClientEvent &out);
+        // Events overwritten before this consumer read them, since the last call
+        uint32_t takeMissed() {
+            uint32_t m = missed;
+            missed = 0;
+            return m;
+        }
+        bool attached() const { return bus != nullptr; }
+
+    private:
+        friend class ClientEventBus;
+        ClientEventBus *bus = nullptr;
+        uint32_t tail = 0;
+        uint32_t missed = 0;
+        // Overwritten stretch of the ring whose latched events are still to be replayed
+        uint32_t replayFrom = 0;
+        uint32_t replayTo = 0;
+    };
+
+    // Starts at the current head: only events posted from now on are seen
+    Subscriber subscribe();
+
+    void post(const ClientEvent &event);
+    void postNodeChanged(uint32_t id, uint8_t mask);
+    void postNodeListChanged();
+    void postMessageAdded(uint32_t historySeq, uint8_t flags);
+    void postAckUpdated(uint32_t packetId, uint8_t status, uint8_t failReason);
+    void postTraceRoute(uint32_t target, const std::vector<uint32_t> &route, const std::vector<float> &snr,
+                        const std::vector<uint32_t> &routeBack, const std::vector<float> &snrBack);
+    void postConnectionState(uint8_t state, uint8_t link);
+    void postNotice(NoticeLevel level, const char *text);
+    void postNotice(NoticeLevel level, const String &text) { postNotice(level, text.c_str()); }
+    void postUiRequest(UiRequestKind kind, const char *text = nullptr);
+
+    // Events ever posted
+    uint32_t posted() const { return head; }
+
+    // Bits set in group after every post (and on wake()), so a consumer can
+    // sleep until there is something to drain
+    void setWake(EventGroupHandle_t group, EventBits_t bits) {
+        wakeGroup = group;
+        wakeBits = bits;
+    }
+    void wake() const {
+        if (wakeGroup) xEventGroupSetBits(wakeGroup, wakeBits);
+    }
+
+private:
+    // The latch an event is kept in, or -1 for a hint
+    static int latchSlot(const ClientEvent &event);
+    // Oldest latched event posted in [from, to); advances from past it
+    bool takeLatched(uint32_t &from, uint32_t to, ClientEvent &out) const;
+
+    ClientEvent ring[CAPACITY];
+    uint32_t head = 0;
+    ClientEvent latches[LATCH_COUNT];
+    uint32_t latchSeq[LATCH_COUNT] = {};  // Ring position each latch was posted at
+    uint8_t latchValid = 0;               // Bit per LatchSlot
+    // Producers are the protocol task, the BLE connect task and the NimBLE
+    // host callbacks (and the UI task, if it runs loop() for want of a
+    // protocol task)
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    EventGroupHandle_t wakeGroup = nullptr;
+    EventBits_t wakeBits = 0;
+};
+
+#endif // CLIENT_EVENTS_H
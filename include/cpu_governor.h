@@ -0,0 +1,49 @@
+#ifndef CPU_GOVERNOR_H
+#define CPU_GOVERNOR_H
+
+#include <Arduino.h>
+
+// Two-step CPU clock: LOW_MHZ while idle or with the screen off, HIGH_MHZ
+// while there is a burst to get through (config download, a backlog on the
+// link, typing, scrolling, a modal being drawn). A burst boosts at once;
+// the clock only drops after HOLD_MS without one, so a burst that pauses
+// between frames doesn't toggle it. The APB clock stays at 80 MHz at either
+// step, so UART baud rates and timers are unaffected.
+//
+// Only the task that calls update() changes the clock. Time at each step
+// is kept, with an estimate of what it saves against running flat out.
+class CpuGovernor {
+public:
+    static constexpr uint32_t LOW_MHZ = 80;
+    static constexpr uint32_t HIGH_MHZ = 240;
+    static constexpr uint32_t HOLD_MS = 1000;
+    // Nominal chip draw with the CPU busy at each step; estimates only
+    static constexpr float LOW_MA = 22.0f;
+    static constexpr float HIGH_MA = 42.0f;
+
+    void begin();
+    // Call once per loop with whether anything wants the fast clock now
+    void update(uint32_t nowMs, bool burst);
+
+    uint32_t currentMhz() const { return high ? HIGH_MHZ : LOW_MHZ; }
+    uint32_t switches() const { return switchCount; }
+    // Share of time at HIGH_MHZ since begin(), 0-100
+    uint8_t highPercent() const;
+    // Estimated average draw of the chip, and the same fixed at HIGH_MHZ
+    float estimatedMa() const;
+    float fixedHighMa() const { return HIGH_MA; }
+
+private:
+    void setHigh(bool on, uint32_t nowMs);
+    void account(uint32_t nowMs);
+
+    bool high = true;  // Boot clock
+    uint32_t lastBurstMs = 0;
+    uint32_t lastAccountMs = 0;
+    uint64_t msAt[2] = {};  // [0] low, [1] high
+    uint32_t switchCount = 0;
+};
+
+extern CpuGovernor *g_cpuGovernor;
+
+#endif // CPU_GOVERNOR_H
@@ -0,0 +1,30 @@
+#ifndef DEADLINE_TIMERS_H
+#define DEADLINE_TIMERS_H
+
+#include <Arduino.h>
+
+// Per-subsystem deadlines for a task that otherwise sleeps until signalled.
+// Each timer is a fixed slot addressed by a small id; arming an armed timer
+// moves its deadline. With this few timers a flat table beats a hashed
+// wheel: arming is a store and the next deadline is one pass over the slots.
+// Times are millis() values and compare with wraparound.
+class DeadlineTimers {
+public:
+    static constexpr uint8_t MAX_TIMERS = 16;
+
+    void arm(uint8_t id, uint32_t atMs);
+    void disarm(uint8_t id);
+    void clear() { armedMask = 0; }
+    bool armed(uint8_t id) const { return id < MAX_TIMERS && (armedMask & (1u << id)); }
+    bool isDue(uint8_t id, uint32_t nowMs) const;
+    // Milliseconds until the earliest armed deadline, 0 if one has passed,
+    // capped at maxWaitMs (also the answer when nothing is armed)
+    uint32_t msUntilNext(uint32_t nowMs, uint32_t maxWaitMs) const;
+    uint32_t deadline(uint8_t id) const { return id < MAX_TIMERS ? at[id] : 0; }
+
+private:
+    uint32_t at[MAX_TIMERS] = {};
+    uint32_t armedMask = 0;
+};
+
+#endif // DEADLINE_TIMERS_H
@@ -0,0 +1,53 @@
+#ifndef DRAIN_SCHEDULER_H
+#define DRAIN_SCHEDULER_H
+
+#include <Arduino.h>
+
+// Paces reads from the radio link by what it has been delivering. An
+// exponential moving average of the arrival rate sets how often a link that
+// can't signal input is polled and how many frames one read may take: under
+// load the interval shrinks and the budget grows, an idle line is polled
+// less and less often. Whatever the budget, a read stops at the first
+// time check after TICK_CAP_US: it can overrun the cap by one poll() of
+// CHUNK_FRAMES, or of a single frame on BLE Meshtastic, where every frame
+// is its own GATT read and can take milliseconds.
+class DrainScheduler {
+public:
+    static constexpr uint32_t MIN_INTERVAL_MS = 2;     // Input left behind by the last read
+    static constexpr uint32_t MAX_INTERVAL_MS = 100;   // Idle line
+    static constexpr size_t MIN_BUDGET = 4;
+    static constexpr size_t MAX_BUDGET = 64;
+    static constexpr size_t CHUNK_FRAMES = 4;          // Frames per poll() between time checks, off BLE
+    static constexpr uint32_t TICK_CAP_US = 8000;
+    static constexpr uint32_t RATE_TAU_MS = 1000;      // Averaging time constant
+    static constexpr uint32_t FRAMES_PER_POLL = 4;     // Arrivals one poll interval aims to collect
+
+    // Frames this read may take: what the rate says arrived since the last
+    // read, with headroom, or what the link says is waiting if that's more.
+    // pendingBytes is converted with the average frame size seen so far.
+    size_t frameBudget(size_t pendingFrames, size_t pendingBytes);
+    // After a read. leftOver: it stopped at the budget or the time cap with
+    // input still waiting.
+    void record(uint32_t nowMs, size_t frames, size_t bytes, uint32_t elapsedUs, bool leftOver);
+    // Delay before the next poll of a link that can't signal input
+    uint32_t intervalMs() const;
+    // New link: forget the old one's rate
+    void reset();
+
+    float rate() const { return rateEma; }  // Frames per second
+    uint32_t lastBudget() const { return budget; }
+    uint32_t maxTickUs() const { return tickUsMax; }
+    uint32_t cappedTicks() const { return ticksLeftOver; }
+
+private:
+    float rateEma = 0;
+    float frameBytesEma = 64;
+    uint32_t lastTickMs = 0;
+    bool started = false;
+    bool pendingLeft = false;
+    uint32_t budget = MIN_BUDGET;
+    uint32_t tickUsMax = 0;
+    uint32_t ticksLeftOver = 0;
+};
+
+#endif // DRAIN_SCHEDULER_H
@@ -0,0 +1,22 @@
+// Millisecond clock for the link layer: millis() on the device, a steady
+// clock in host builds, so the transports that don't touch hardware build
+// and run off-target (see test/host).
+#ifndef LINK_CLOCK_H
+#define LINK_CLOCK_H
+
+#include <cstdint>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+
+inline uint32_t linkMillis() { return millis(); }
+#else
+#include <chrono>
+
+inline uint32_t linkMillis() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#endif // LINK_CLOCK_H
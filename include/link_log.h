@@ -0,0 +1,16 @@
+// Logging for the link layer: the USB serial console on the device, stdout
+// in host builds (see link_clock.h)
+#ifndef LINK_LOG_H
+#define LINK_LOG_H
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+
+#define LINK_LOGF(...) Serial.printf(__VA_ARGS__)
+#else
+#include <cstdio>
+
+#define LINK_LOGF(...) std::printf(__VA_ARGS__)
+#endif
+
+#endif // LINK_LOG_H
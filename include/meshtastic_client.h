@@ -2,29 +2,43 @@
 #define MESHTASTIC_CLIENT_H
 
 #include "globals.h"
+#include "client_events.h"
+#include "deadline_timers.h"
+#include "drain_scheduler.h"
 #include "meshtastic_protocol.h"
 #include "meshcore_protocol.h"
+#include "packet_filter.h"
+#include "pending_ack.h"
+#include "radio_log.h"
+#include "snapshot_buffer.h"
+#include "task_load.h"
+#include "transport.h"
+#include "uart_transport.h"
+#include "ble_transport.h"
+#include "tcp_transport.h"
 #include <NimBLEAdvertisedDevice.h>
 #include <NimBLEClient.h>
 #include <NimBLEDevice.h>
 #include <NimBLERemoteCharacteristic.h>
 #include <NimBLERemoteService.h>
 #include <NimBLEScan.h>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <vector>
 // Persistence for ESP32
 #include <Preferences.h>
+// FreeRTOS primitives for the background TX queue
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 
 // Forward declarations
 class MeshtasticUI;
 class MeshtasticBLEScanCallbacks;
 
-// Streaming protocol constants
-#define STREAM_START1 0x94
-#define STREAM_START2 0xC3
-#define MAX_PACKET_SIZE 512
-
 // Message types
 #define MSG_TYPE_TEXT 0
 #define MSG_TYPE_POSITION 1
@@ -46,6 +60,19 @@ struct MeshtasticNode {
     float longitude = 0.0f;
     int altitude = 0;
     float batteryLevel = -1.0f;
+    uint32_t nameHash = 0;  // Of the raw names last applied; see upsertNode()
+};
+
+// upsertNode() result: which parts of the stored node changed
+enum NodeChange : uint8_t {
+    NODE_CHANGE_NONE = 0,
+    NODE_CHANGE_ADDED = 1 << 0,
+    NODE_CHANGE_NAME = 1 << 1,
+    NODE_CHANGE_SIGNAL = 1 << 2,  // SNR or hops away
+    NODE_CHANGE_LAST_HEARD = 1 << 3,
+    NODE_CHANGE_POSITION = 1 << 4,
+    NODE_CHANGE_BATTERY = 1 << 5,
+    NODE_CHANGE_CHANNEL = 1 << 6
 };
 
 enum MessageStatus {
@@ -94,6 +121,8 @@ struct MeshtasticMessage {
     std::vector<uint32_t> routePath;
     MessageStatus status = MSG_STATUS_SENDING;
     uint32_t packetId = 0;
+    uint32_t historySeq = 0;  // Assigned by addMessageToHistory, consecutive across the history
+    uint8_t failReason = 0;   // RoutingError from the mesh when status is FAILED
 };
 
 struct MeshtasticChannel {
@@ -107,6 +136,87 @@ struct MeshtasticChannel {
     uint32_t role = 0;
 };
 
+// BLE scan results as the UI lists them; the three vectors run in parallel
+struct BleScanList {
+    std::vector<String> names;
+    std::vector<String> addresses;
+    std::vector<bool> paired;
+};
+
+// Settings and link flags the UI shows, copied whole on every publish
+struct ClientStatus {
+    bool uartAvailable = false;
+    bool tcpConnecting = false;
+    bool uartUpgradeActive = false;
+    bool bleScanning = false;
+    MessageMode messageMode = MODE_PROTOBUFS;
+    uint8_t currentChannel = 0;
+    uint8_t brightness = 0;
+    uint32_t screenTimeoutMs = 0;
+    uint32_t uartBaud = 0;
+    int uartTxPin = -1;
+    int uartRxPin = -1;
+    String wifiSsid;
+    bool hasWifiPassword = false;
+    String tcpHost;
+    uint32_t radioLogLines = 0;  // Held in the radio log, not ever added
+
+    bool operator==(const ClientStatus &o) const {
+        return uartAvailable == o.uartAvailable && tcpConnecting == o.tcpConnecting &&
+               uartUpgradeActive == o.uartUpgradeActive && bleScanning == o.bleScanning &&
+               messageMode == o.messageMode && currentChannel == o.currentChannel && brightness == o.brightness &&
+               screenTimeoutMs == o.screenTimeoutMs && uartBaud == o.uartBaud && uartTxPin == o.uartTxPin &&
+               uartRxPin == o.uartRxPin && wifiSsid == o.wifiSsid && hasWifiPassword == o.hasWifiPassword &&
+               tcpHost == o.tcpHost && radioLogLines == o.radioLogLines;
+    }
+    bool operator!=(const ClientStatus &o) const { return !(*this == o); }
+};
+
+// What the Radio Log and Diagnostics dialogs show. Too big to copy on every
+// publish, so it is built only when the UI asks (CMD_REPORT).
+struct ClientReport {
+    RadioLog radioLog;
+    String linkName = "None";
+    bool haveLink = false;
+    bool linkUp = false;
+    TransportStats linkStats;
+    uint16_t radioQueueFree = 0;
+    uint16_t radioQueueMax = 0;  // 0 until the radio reports its queue
+    uint32_t radioQueueRejects = 0;
+    size_t pendingAcks = 0;
+    PacketFilterStats duplicates;
+};
+
+// Read-only view of client state for the UI, published by the protocol task
+// after a loop() pass that changed something. Node, message and scan lists
+// are shared between consecutive snapshots until they change, so a new
+// message doesn't copy the node list. Each part carries the client's change
+// counter as of the copy, so readers can tell what moved since their last
+// look. The UI draws from this alone and never takes the state lock: what
+// it wants changed goes to the protocol task as a ClientCommand, and shows
+// up here a pass later.
+struct ClientSnapshot {
+    uint32_t version = 0;  // Bumped on every publish
+    uint32_t nodesVersion = 0;
+    uint32_t messagesVersion = 0;
+    std::shared_ptr<const std::vector<MeshtasticNode>> nodes;
+    std::shared_ptr<const std::vector<MeshtasticMessage>> messages;
+    ConnectionState connectionState = CONN_DISCONNECTED;
+    bool connected = false;
+    TransportKind link = TRANSPORT_NONE;
+    bool linkUp = false;
+    DeviceType deviceType = DEVICE_MESHTASTIC;
+    uint32_t myNodeId = 0;
+    String primaryChannelName;
+    bool nodeSyncInProgress = false;
+    uint32_t nodeSyncCount = 0;
+    ClientStatus status;
+    uint32_t scanListVersion = 0;
+    std::shared_ptr<const BleScanList> scanList;
+    uint32_t reportVersion = 0;  // Bumped each time a requested report lands
+    std::shared_ptr<const ClientReport> report;
+};
+
 class MeshtasticClient {
 public:
     MeshtasticClient();
@@ -115,6 +225,88 @@ public:
     void begin();
     void loop();
 
+    // Protocol task: runs loop() on core 0. It sleeps on protoEvents until
+    // the link, the TX task or a posted command has work for it, or until
+    // the nearest deadline in protoTimers; there is no fixed polling tick.
+    // Until it is started (or if it fails to start) the caller runs loop().
+    bool startProtocolTask();
+    bool isProtocolTaskRunning() const { return protoTaskHandle != nullptr; }
+    // Client state (node list, history, connection flags, settings). The
+    // protocol task holds this around each loop() pass and its commands,
+    // except where it waits on the link (frame reads, BLE subscribes,
+    // opening and probing the UART), which runs under the link lock alone,
+    // and takes it back to apply what it read. The UI never takes it: it
+    // reads snapshots and posts commands. Only the light sleep path in the
+    // Arduino loop holds it, so no pass starts mid-sleep. Recursive.
+    void lockState();
+    void unlockState();
+    // Everything the UI asks of the client: run on the protocol task, under
+    // the state lock, in the order posted. Results come back as notices and
+    // in the next snapshot.
+    enum ClientCommandType : uint8_t {
+        CMD_CONNECT_GROVE = 0,
+        CMD_REQUEST_NODES,
+        CMD_TRACE_ROUTE,          // nodeId, arg: hop limit
+        CMD_SEND_TEXT,            // nodeId (0xFFFFFFFF: broadcast on the current channel), text
+        CMD_MESHCORE_PING,        // nodeId
+        CMD_CLEAR_HISTORY,
+        CMD_SET_UART_BAUD,        // value
+        CMD_SET_UART_TX_PIN,      // value
+        CMD_SET_UART_RX_PIN,      // value
+        CMD_UART_SPEED_UPGRADE,   // value: target baud
+        CMD_SET_BRIGHTNESS,       // value; the UI drives the panel itself
+        CMD_SET_SCREEN_TIMEOUT,   // value: ms, 0 = never
+        CMD_SET_MESSAGE_MODE,     // value: MessageMode
+        CMD_SET_TEXT_MODE,        // value: 0/1
+        CMD_SET_WIFI_SSID,        // text; the password is kept only for the same network
+        CMD_SET_WIFI_PASSWORD,    // text
+        CMD_SET_TCP_HOST,         // text
+        CMD_CONNECT_TCP,
+        CMD_SET_PREFERENCE,       // value: UserConnectionPreference
+        CMD_DISCONNECT,
+        CMD_BLE_CONNECT_NAME,     // text; async, on the connect task
+        CMD_BLE_CONNECT_ADDRESS,  // text; async, on the connect task
+        CMD_BLE_SCAN_START,       // Clears the scan list first, restarts a running scan
+        CMD_BLE_SCAN_STOP,
+        CMD_BLE_CLEAR_PAIRED,
+        CMD_BLE_PIN,              // value: passkey for the pairing waiting on it
+        CMD_PRINT_CONFIG,
+        CMD_REPORT                // Publish a fresh ClientReport
+    };
+    bool postCommand(ClientCommandType type, uint32_t nodeId = 0, uint8_t arg = 0);
+    // A command with one number: a setting, a baud rate, a passkey
+    bool postValue(ClientCommandType type, uint32_t value);
+    // A command with text (message, name, address, host); cut at COMMAND_TEXT_MAX
+    bool postText(ClientCommandType type, const String &text, uint32_t nodeId = 0);
+    static constexpr size_t COMMAND_TEXT_MAX = 200;  // The UI's input limit
+    // Copies what changed since the last publish into the snapshot buffer;
+    // runs after each loop() pass on whichever task runs loop()
+    void publishSnapshot();
+    // Pins the latest snapshot; never blocks, and the pin must not be held
+    // across frames or the writer stalls on that slot
+    SnapshotBuffer<ClientSnapshot>::Ref acquireSnapshot() const { return snapshots.acquire(); }
+    // Live change counters; a snapshot part with the same value has the same contents
+    uint32_t getNodesVersion() const { return nodesVersion; }
+    uint32_t getMessagesVersion() const { return messagesVersion; }
+    // What changed, for the UI and notifications; see ClientEventBus
+    ClientEventBus &eventBus() { return events; }
+    // How long the protocol side can do without the CPU, for light sleep:
+    // 0 with work pending, a transmit in progress, a connected UART radio,
+    // or a BLE or WiFi link (or a scan or connect) that needs the radio
+    // awake; otherwise the time to the nearest deadline. -1 in uartWakePort
+    // unless the UART is open with no radio found on it yet, else the port
+    // to wake on. Caller holds the state lock.
+    uint32_t lightSleepBudgetMs(uint32_t now, int &uartWakePort);
+    // Ticks may have stood still while asleep: the protocol task rechecks
+    // its deadlines
+    void onLightSleepWake() { wakeProtocolTask(PROTO_EVT_RESUME); }
+    // A burst the fast CPU clock helps with: config or node DB download, a
+    // backlog on the link, heavy inbound traffic, or queued commands and
+    // transmissions. Safe without the state lock: the client state part is
+    // sampled by publishSnapshot() into an atomic, the queues are counted
+    // through FreeRTOS.
+    bool wantsFullSpeed() const;
+
     bool scanForDevices();
     bool scanForDevices(bool connect, const String &targetName);
     bool scanForDevicesOnly();
@@ -133,16 +325,34 @@ public:
     bool startBleScan();           // Start BLE scanning for UI
     void stopBleScan();            // Stop BLE scanning
     bool isBleScanning() const;    // Check if BLE scan is active
-    std::vector<String> getScannedDeviceNames() const;
-    std::vector<String> getScannedDeviceAddresses() const; 
-    std::vector<bool> getScannedDevicePairedStatus() const;
     bool connectToDeviceWithPin(const String &deviceAddress, const String &pin);
     bool isDevicePaired(const String &deviceAddress) const;
     void clearPairedDevices(); // Clear all paired BLE devices
     
     // Grove/UART connection control
     bool startGroveConnection();   // Start Grove/UART connection attempt (manual trigger)
-    void setUARTConfig(uint32_t baud, int txPin, int rxPin, bool enable = true);
+    // detectBaud = false reopens at exactly baud, without probing other rates
+    void setUARTConfig(uint32_t baud, int txPin, int rxPin, bool enable = true, bool detectBaud = true);
+    // Reconfigure the radio's serial module to targetBaud over admin, then follow it
+    bool requestUARTSpeedUpgrade(uint32_t targetBaud);
+    bool isUARTSpeedUpgradeActive() const {
+        return uartUpgrade.state != UART_UPGRADE_IDLE && uartUpgrade.state != UART_UPGRADE_DONE &&
+               uartUpgrade.state != UART_UPGRADE_FAILED;
+    }
+
+    // WiFi/TCP connection control: join the saved network, then open the
+    // radio's TCP API (port 4403). Progress is driven from loop().
+    bool startTcpConnection();
+    void stopTcpConnection();
+    bool isTcpConnecting() const { return tcpStage != TCP_STAGE_IDLE; }
+    void setWifiCredentials(const String &ssid, const String &password);
+    // The radio's IPv4 address or hostname (e.g. meshtastic.local); names
+    // are looked up on the async connect task once WiFi is up
+    void setTcpHost(const String &host);
+    const String &getWifiSsid() const { return wifiSsid; }
+    const String &getWifiPassword() const { return wifiPassword; }
+    bool hasWifiPassword() const { return !wifiPassword.isEmpty(); }
+    const String &getTcpHost() const { return tcpHost; }
 
     bool sendMessage(uint32_t nodeId, const String &message, uint8_t channel = 0);
     bool sendTextMessage(const String &message, uint32_t nodeId);
@@ -160,7 +370,10 @@ public:
     void disconnectBLE();
     void showMessageHistory();
     void clearMessageHistory(); // Clear all messages from history
-    String formatLastHeard(uint32_t seconds);
+    static String formatLastHeard(uint32_t seconds);
+    // Settings-row text, shared with the UI's snapshot-driven settings tab
+    static String formatMessageMode(MessageMode mode);
+    static String formatScreenTimeout(uint32_t timeoutMs);
     void printStartupConfig(); // Print current configuration on startup
 
     bool isDeviceConnected() const { return isConnected; }
@@ -172,14 +385,24 @@ public:
     int getMessageCountForDestination(uint32_t nodeId) const;
     String getPrimaryChannelName() const { return primaryChannelName; }
     uint32_t getMyNodeId() const { return myNodeId; }
-    String getConnectionType() const { return connectionType; }
+    String getConnectionType() const { return transport ? transport->name() : "None"; }
+    TransportKind getTransportKind() const { return transport ? transport->kind() : TRANSPORT_NONE; }
+    bool isBleLink() const {
+        return transport && (transport->kind() == TRANSPORT_BLE_MESHTASTIC || transport->kind() == TRANSPORT_BLE_MESHCORE);
+    }
+    const ITransport *getTransport() const { return transport; }
     DeviceType getDeviceType() const { return deviceType; }
     uint8_t getCurrentChannel() const { return currentChannel; }
-    const std::vector<String> &getLastScanDevices() const { return lastScanDevicesNames; }
     uint32_t getUARTBaud() const { return uartBaud; }
     int getUARTTxPin() const { return uartTxPin; }
     int getUARTRxPin() const { return uartRxPin; }
     uint32_t getLastRequestId() const { return lastRequestId; }
+    // Background node DB download (second config phase)
+    bool isNodeSyncInProgress() const { return configSessionActive() && configSession.phase == CFG_PHASE_NODES; }
+    uint32_t getNodeSyncCount() const { return configSession.nodes; }
+    bool isLinkAlive() const { return linkAlive; }
+    uint32_t getRxBytesPerMinute() const { return rxBytesLastMinute; }
+    uint32_t getTxBytesPerMinute() const { return txBytesLastMinute; }
     const MeshtasticNode *findNode(uint32_t nodeId) const;
     MeshtasticNode *getNodeById(uint32_t nodeId);
     bool isUARTAvailable() const { return uartAvailable; }
@@ -190,10 +413,12 @@ public:
     String getMessageModeString() const;
     bool hasActiveTransport() const;
     
-    // Screen & UI helpers
+    // Screen & UI helpers. The timeout, activity time and brightness are
+    // atomics: the UI and the BLE host task touch them without the state lock.
     bool isScreenTimedOut() const;
     void wakeScreen();
     int getBrightness() const;
+    // Stores and saves; the caller sets the panel
     void setBrightness(uint8_t brightness);
     uint32_t getScreenTimeout() const;
     String getScreenTimeoutString() const;
@@ -213,11 +438,16 @@ public:
     uint16_t pendingPairingConnHandle = 0;
     
     // UI State members
-    uint8_t brightness = 128;
-    uint32_t lastScreenActivity = 0;
+    std::atomic<uint8_t> brightness{128};
+    std::atomic<uint32_t> lastScreenActivity{0};
 
-    // Scanning members
+    // Scanning members. The scan list is written by the BLE host task and
+    // read by the protocol and connect tasks: hold scanListMutex, and call
+    // onScanListChanged() after changing it.
     bool bleUiScanActive = false;
+    SemaphoreHandle_t scanListMutex = nullptr;
+    std::atomic<uint32_t> scanListVersion{0};
+    void onScanListChanged();
     std::vector<String> scannedDeviceAddresses;
     std::vector<String> scannedDeviceNames;
     std::vector<bool> scannedDevicePaired;
@@ -234,21 +464,21 @@ public:
         Serial.printf("[DEBUG] userConnectionPreference set to: %d\n", (int)userConnectionPreference);
         // If user explicitly selects Bluetooth, tear down any active UART usage so
         // we don't keep consuming Grove data or populating nodes via UART.
-        if (userConnectionPreference == PREFER_BLUETOOTH) {
-            if (connectionType == "UART") {
+        if (userConnectionPreference != PREFER_WIFI && (isTcpConnecting() || tcpTransport.isOpen())) {
+            stopTcpConnection();
+        }
+        if (userConnectionPreference == PREFER_BLUETOOTH || userConnectionPreference == PREFER_WIFI) {
+            if (transportIs(TRANSPORT_UART)) {
                 // Gracefully disconnect UART transport without affecting BLE state
-                Serial.println("[Pref] Switching to Bluetooth-only: disabling UART connection");
+                Serial.println("[Pref] Switching away from Grove: disabling UART connection");
                 isConnected = false; // Only if UART was sole connection
-                connectionType = "None"; // Await BLE connect
+                selectTransport(nullptr); // Await BLE connect
                 updateConnectionState(CONN_DISCONNECTED);
             }
             if (uartAvailable) {
-                Serial.println("[Pref] Disabling UART availability under Bluetooth preference");
-                if (uartPort) { uartPort->end(); uartPort = nullptr; }
-                uartAvailable = false;
-                uartInited = false;
-                // Clear buffers to avoid stale packets influencing UI
-                uartRxBuffer.clear();
+                Serial.println("[Pref] Disabling UART availability under non-Grove preference");
+                // Closing also drops any partial frame so stale packets can't reach the UI
+                closeUART();
             }
         }
     }
@@ -257,6 +487,7 @@ public:
         switch (userConnectionPreference) {
             case PREFER_GROVE: return "Grove";
             case PREFER_BLUETOOTH: return "Bluetooth"; 
+            case PREFER_WIFI: return "WiFi TCP";
             case PREFER_AUTO:
             default: return "Auto";
         }
@@ -266,7 +497,10 @@ public:
     void onFromNumNotify(uint8_t *pData, size_t length); // Overload for direct call
     
     // MeshCore notification handler
+    // BLE host task: queues the notification for the main loop
     void onMeshCoreNotify(uint8_t *data, size_t length);
+    // Main loop: decodes one MeshCore companion frame
+    void onMeshCoreFrame(uint8_t *data, size_t length);
     
     // MeshCore send methods
     bool sendMeshCoreText(const String& text, const std::vector<uint8_t>& pubKeyPrefix);
@@ -279,8 +513,18 @@ public:
     const MeshtasticNode* findNodeByPubKeyPrefix(const uint8_t *prefix, size_t len) const;
     uint32_t deriveNodeIdFromPrefix(const uint8_t *prefix, size_t len) const;
 
-    void updateMessageStatus(uint32_t packetId, MessageStatus newStatus);
-    void upsertNode(const ParsedNodeInfo &parsed);
+    void updateMessageStatus(uint32_t packetId, MessageStatus newStatus, uint8_t failReason = ROUTING_ERROR_NONE);
+    MeshtasticMessage *findMessageBySeq(uint32_t historySeq);
+    const PendingAckTable &getPendingAcks() const { return pendingAcks; }
+    // Recent debug output from the attached radio (serial console and log_record)
+    const RadioLog &getRadioLog() const { return radioLog; }
+    const PacketFilterStats &getDuplicateFilterStats() const { return recentPackets.stats(); }
+    // Radio TX queue as of its last QueueStatus; max is 0 until one arrives
+    uint16_t getRadioQueueFree() const { return radioQueue.free; }
+    uint16_t getRadioQueueMax() const { return radioQueue.known ? radioQueue.maxlen : 0; }
+    uint32_t getRadioQueueRejects() const { return radioQueueRejects; }
+    // Returns a NodeChange mask; an unchanged update allocates nothing
+    uint8_t upsertNode(const ParsedNodeInfo &parsed);
     void updateChannel(const ParsedChannelInfo &parsed);
     uint32_t allocateRequestId();
     
@@ -291,8 +535,8 @@ public:
     void logCurrentScanSummary() const;
 
     bool uartAvailable = false;
-    HardwareSerial *uartPort = nullptr;
     bool uartInited = false;
+    bool uartProbing = false;  // Baud detection running with the state lock dropped
     uint32_t uartBaud = MESHTASTIC_UART_BAUD;
     int uartTxPin = MESHTASTIC_TXD_PIN;
     int uartRxPin = MESHTASTIC_RXD_PIN;
@@ -320,6 +564,58 @@ public:
     uint32_t configRequestTime = 0;
     uint32_t configRequestId = 0;
     bool configReceived = false;
+
+    // want_config handshake: one request, tracked until the radio echoes its
+    // nonce in config_complete_id; re-sent only on a stall. Startup runs two
+    // sessions: config-only so the UI is usable at once, then the node DB.
+    enum ConfigSessionState : uint8_t { CFG_IDLE = 0, CFG_REQUESTED, CFG_STREAMING, CFG_COMPLETE, CFG_FAILED };
+    enum ConfigPhase : uint8_t {
+        CFG_PHASE_FULL = 0,   // Random nonce: config and node DB in one dump
+        CFG_PHASE_CONFIG,     // WANT_CONFIG_ONLY_CONFIG
+        CFG_PHASE_NODES       // WANT_CONFIG_ONLY_NODES
+    };
+    struct ConfigSession {
+        ConfigSessionState state = CFG_IDLE;
+        ConfigPhase phase = CFG_PHASE_FULL;
+        uint32_t nonce = 0;
+        uint8_t attempts = 0;
+        uint32_t startTime = 0;
+        uint32_t lastRequestTime = 0;
+        uint32_t lastProgressTime = 0;  // Last FromRadio frame while the session was open
+        uint32_t frames = 0;
+        uint32_t nodes = 0;
+        uint32_t rxBytesAtStart = 0;
+        uint32_t txBytesAtStart = 0;
+        uint32_t rxBytes = 0;           // Wire bytes for the whole session, filled in when it ends
+        uint32_t txBytes = 0;
+        uint32_t durationMs = 0;
+    };
+    ConfigSession configSession;
+    static constexpr uint32_t CONFIG_STALL_TIMEOUT_MS = 8000;  // No frames for this long = retry
+    static constexpr uint8_t CONFIG_MAX_ATTEMPTS = 3;
+    static constexpr uint32_t NODE_SYNC_REDRAW_MS = 1000;  // Progress repaint cadence during the node phase
+    uint32_t lastNodeSyncRedraw = 0;
+    // Raw link byte counters (framing included), for measuring what each exchange
+    // costs. Summed over every backend so deltas survive a transport switch.
+    uint32_t linkRxBytes() const;
+    uint32_t linkTxBytes() const;
+
+    // Keepalive: a ToRadio heartbeat once we've sent nothing for a while, in
+    // place of want_config probes. The link counts as alive while any bytes
+    // arrive from the radio.
+    static constexpr uint32_t HEARTBEAT_INTERVAL_MS = 60000;
+    static constexpr uint32_t LINK_SILENT_MS = 3 * HEARTBEAT_INTERVAL_MS;
+    uint32_t lastHeartbeatTime = 0;
+    uint32_t lastLinkRxTime() const { return transport ? transport->stats().lastRxMs : 0; }
+    uint32_t lastLinkTxTime() const { return transport ? transport->stats().lastTxMs : 0; }
+    uint32_t heartbeatsSent = 0;
+    bool linkAlive = false;
+    // Traffic over the last complete minute, rolled over from the raw counters
+    uint32_t rxBytesLastMinute = 0;
+    uint32_t txBytesLastMinute = 0;
+    uint32_t minuteStartTime = 0;
+    uint32_t minuteStartRxBytes = 0;
+    uint32_t minuteStartTxBytes = 0;
     bool fastDeviceInfoReceived = false;  // Track if we got device info via NODELESS request
     bool autoNodeDiscoveryRequested = false;
     uint32_t lastNodeRequestTime = 0;  // Track last node request time
@@ -340,24 +636,30 @@ public:
     std::vector<String> lastScanDevicesNames;
     std::vector<std::unique_ptr<NimBLEAdvertisedDevice>> lastScanDevices;
     uint32_t lastRequestId = 0;
-    std::vector<uint8_t> uartRxBuffer;
     uint32_t lastUARTProbeMillis = 0;
     uint32_t lastDrainMillis = 0;
     bool textMessageMode = false;  // Deprecated - use messageMode instead
     MessageMode messageMode = MODE_PROTOBUFS;
     String textRxBuffer;
     uint8_t displayBrightness = 200;  // Default brightness (0-255)
-    String connectionType = "None";  // Track connection type: "BLE", "UART", or "None"
+    // Active link; every send/receive goes through it. Null when disconnected.
+    ITransport *transport = nullptr;
+    UartTransport uartTransport;
+    BleMeshtasticTransport bleTransport;
+    BleMeshCoreTransport meshCoreTransport;
+    TcpTransport tcpTransport;
+    bool transportIs(TransportKind kind) const { return transport && transport->kind() == kind; }
+    void selectTransport(ITransport *t);
     
     // User connection preference (from UI)
-    enum UserConnectionPreference { PREFER_AUTO = 0, PREFER_GROVE = 1, PREFER_BLUETOOTH = 2 };
+    enum UserConnectionPreference { PREFER_AUTO = 0, PREFER_GROVE = 1, PREFER_BLUETOOTH = 2, PREFER_WIFI = 3 };
     UserConnectionPreference userConnectionPreference = PREFER_AUTO;  // Default to auto mode
     
     // Grove connection control - require manual trigger like BLE
     bool groveConnectionManuallyTriggered = false;  // Set to true when user selects "Connect to Grove"
     
     // Screen timeout settings
-    uint32_t screenTimeoutMs = 120000;  // Default 2 minutes (0 = never)
+    std::atomic<uint32_t> screenTimeoutMs{120000};  // Default 2 minutes (0 = never)
     uint32_t lastActivityTime = 0;
     bool screenTimedOut = false;
     
@@ -372,12 +674,60 @@ public:
     // within a fallback window we send it anyway.
     bool uartDeferredConfig = false;
     uint32_t uartDeferredStartTime = 0;
+
+    // WiFi/TCP link bring-up: join the network, look tcpHost up if it's a
+    // name, then connect to it
+    enum TcpStage : uint8_t { TCP_STAGE_IDLE = 0, TCP_STAGE_WIFI, TCP_STAGE_RESOLVING, TCP_STAGE_CONNECTING };
+    TcpStage tcpStage = TCP_STAGE_IDLE;
+    uint32_t tcpStageStart = 0;
+    static constexpr uint32_t WIFI_JOIN_TIMEOUT_MS = 15000;
+    static constexpr uint32_t TCP_RESOLVE_TIMEOUT_MS = 10000;
+    void openTcpLink(const char *ip, uint32_t now);
+    String wifiSsid;
+    String wifiPassword;
+    String tcpHost;
+
+    // Scratch frame (header headroom + payload) for sends that don't come
+    // from a TX queue slot
+    uint8_t txFrame[STREAM_HEADER_SIZE + MAX_PACKET_SIZE];
+
+    // Baud detection: the saved rate is tried first, then these, most common
+    // first. A rate counts once a complete frame arrives at it: traffic the
+    // radio was sending anyway, or an answer to a heartbeat sent after
+    // UART_PROBE_PASSIVE_MS of silence. Nothing that changes radio state is sent.
+    static constexpr uint32_t UART_BAUD_CANDIDATES[] = {115200, 921600, 38400, 57600, 19200, 9600, 230400};
+    static constexpr uint32_t UART_PROBE_LISTEN_MS = 500;
+    static constexpr uint32_t UART_PROBE_PASSIVE_MS = 200;
+
+    // Link speed upgrade: read the radio's SerialConfig, write it back with a
+    // new baud, wait out the reboot, then reopen at that rate and time the
+    // node DB download again for comparison.
+    enum UartUpgradeState : uint8_t {
+        UART_UPGRADE_IDLE = 0,
+        UART_UPGRADE_QUERY,    // get_module_config_request sent
+        UART_UPGRADE_REBOOT,   // set_module_config sent, radio restarting
+        UART_UPGRADE_VERIFY,   // Reopened at the new rate, waiting for a full download
+        UART_UPGRADE_DONE,
+        UART_UPGRADE_FAILED
+    };
+    struct UartUpgrade {
+        UartUpgradeState state = UART_UPGRADE_IDLE;
+        uint32_t targetBaud = 0;
+        uint32_t fromBaud = 0;
+        uint32_t startTime = 0;
+        uint32_t bpsBefore = 0;  // Node DB download rate at fromBaud (0 = not measured)
+        uint32_t bpsAfter = 0;
+    };
+    UartUpgrade uartUpgrade;
+    static constexpr uint32_t UART_UPGRADE_QUERY_TIMEOUT_MS = 10000;
+    static constexpr uint32_t UART_UPGRADE_REBOOT_MS = 12000;  // Firmware reboots ~5 s after a module config set
+    uint32_t lastNodeSyncBps = 0;  // Receive rate of the last config session that carried the node DB
     
     // Internal state for subscription retries
     bool needsSubscriptionRetry = false;
     uint32_t subscriptionRetryStartTime = 0;
     uint32_t subscriptionRetryCount = 0;
-    bool fromNumNotifyPending = false;
+    uint32_t meshCoreDroppedLogged = 0;
     
     // Async connect state
     bool asyncConnectInProgress = false;
@@ -387,24 +737,185 @@ public:
         MeshtasticClient* self;
         String name;
         String address;
+        String host;  // TCP radio host to look up instead of a BLE connect
+    };
+    // Hostname lookups for the TCP link, run on the async connect task
+    bool beginAsyncResolve(const String &host);
+    enum TcpResolve : uint8_t { TCP_RESOLVE_PENDING = 0, TCP_RESOLVE_DONE, TCP_RESOLVE_FAILED };
+    std::atomic<uint8_t> tcpResolve{TCP_RESOLVE_PENDING};
+    char tcpResolvedIp[16] = {};  // Written by the task before tcpResolve turns DONE
+
+    // Outgoing TX queue: UI-facing sends only encode into a preallocated slot
+    // and return; TxTask paces and transmits, retrying transient transport
+    // failures, and loop() applies the results to MessageStatus.
+    static constexpr size_t TX_QUEUE_DEPTH = 8;
+    static constexpr uint32_t TX_PACING_MS = 1000;        // Spacing between our packets (LoRa airtime)
+    static constexpr uint8_t TX_MAX_ATTEMPTS = 3;
+    static constexpr uint32_t TX_RETRY_BACKOFF_MS = 250;  // Doubled on each retry
+    enum TxKind : uint8_t { TX_KIND_TEXT = 0, TX_KIND_TRACEROUTE = 1, TX_KIND_HEARTBEAT = 2, TX_KIND_ADMIN = 3 };
+    struct TxRequest {
+        uint8_t frame[STREAM_HEADER_SIZE + MAX_PACKET_SIZE];
+        size_t len = 0;
+        uint32_t packetId = 0;
+        TxKind kind = TX_KIND_TEXT;
+    };
+    struct TxResult {
+        uint32_t packetId;
+        TxKind kind;
+        bool ok;
+        uint8_t attempts;
+        bool radioSlot;  // A mesh packet went out and took a slot in the radio's TX queue
     };
+    TxRequest txSlots[TX_QUEUE_DEPTH];
+    QueueHandle_t txFreeSlots = nullptr;     // Indices of idle slots
+    QueueHandle_t txPendingSlots = nullptr;  // Indices waiting for TxTask, in send order
+    QueueHandle_t txResults = nullptr;
+    TaskHandle_t txTaskHandle = nullptr;
+    SemaphoreHandle_t linkMutex = nullptr;   // Recursive; serializes transport I/O between loop() and TxTask
+    uint32_t txLastSendTime = 0;
+
+    // The radio's own TX queue, as last reported by FromRadio.queueStatus.
+    // TxTask holds mesh packets while it has no free slots; loop() updates it
+    // and notifies TxTask when a slot frees up. Unknown until the first
+    // QueueStatus on a link, and firmware that never sends one is not held.
+    // Only loop() writes it, under linkMutex; TxTask reports the slots it
+    // took through txResults and reads it under linkMutex too.
+    static constexpr uint32_t RADIO_QUEUE_STALL_MS = 15000;  // Send anyway if no slot is reported free by then
+    struct RadioQueueState {
+        bool known = false;
+        uint16_t free = 0;
+        uint16_t maxlen = 0;
+        uint32_t updatedMs = 0;
+    };
+    RadioQueueState radioQueue;
+    bool radioQueueFull();
+    uint32_t radioQueueRejects = 0;  // Packets the radio refused (QueueStatus.res)
+
+    // Protocol task and the UI->protocol command queue
+    static constexpr uint32_t PROTO_MAX_SLEEP_MS = 1000;   // Longest the task sleeps with nothing armed
+    static constexpr uint32_t LINK_SAFETY_POLL_MS = 1000;  // Occasional poll of links that can
+    static constexpr uint32_t TX_DONE_POLL_MS = 5;         // While a stream link's TX ring drains
+    static constexpr uint32_t HOUSEKEEPING_MS = 100;       // Config, upgrade and connect state machines
+    static constexpr size_t COMMAND_QUEUE_DEPTH = 8;
+    static constexpr uint32_t LOAD_REPORT_MS = 60000;    // Serial CPU load report cadence
+    static constexpr float FULL_SPEED_RX_FPS = 10.0f;     // Inbound frame rate that counts as a burst
+    struct ClientCommand {
+        ClientCommandType type;
+        uint32_t nodeId;
+        uint8_t arg;
+        uint32_t value;
+        char text[COMMAND_TEXT_MAX + 1];
+    };
+    // protoEvents bits: why the protocol task was woken
+    static constexpr EventBits_t PROTO_EVT_RX = 1 << 0;       // UART driver data, BLE notify
+    static constexpr EventBits_t PROTO_EVT_COMMAND = 1 << 1;  // postCommand()
+    static constexpr EventBits_t PROTO_EVT_TX_DONE = 1 << 2;  // TxTask posted a result
+    static constexpr EventBits_t PROTO_EVT_LINK = 1 << 3;     // BLE callbacks: disconnect, auto-connect, scan results
+    static constexpr EventBits_t PROTO_EVT_RESUME = 1 << 4;   // Back from light sleep
+    static constexpr EventBits_t PROTO_EVT_ALL = 0x1F;
+    enum ProtoTimer : uint8_t {
+        PT_LINK_POLL = 0,
+        PT_TX_DONE,
+        PT_ACK_SWEEP,
+        PT_TRACE_ROUTE,
+        PT_HOUSEKEEPING,
+        PT_KEEPALIVE,
+        PT_LOAD_REPORT
+    };
+    QueueHandle_t commandQueue = nullptr;
+    TaskHandle_t protoTaskHandle = nullptr;
+    EventGroupHandle_t protoEvents = nullptr;
+    DeadlineTimers protoTimers;
+    bool rxBacklog = false;  // The last poll stopped at its frame cap or found the link busy
+    DrainScheduler drainSched;
+    const ITransport *drainSchedLink = nullptr;  // The link drainSched's averages belong to
+    std::atomic<bool> stateWantsFullSpeed{false};  // Sampled under the state lock, see wantsFullSpeed()
+    std::atomic<uint32_t> fromNumNotifies{0};  // FromNum notifies since the last read; one frame each
+    uint32_t drainFrameBytes = 0;              // Payload bytes handled by the current drainLink()
+    SemaphoreHandle_t stateMutex = nullptr;
+    TaskLoad protoLoad{"proto"};
+    TaskLoad txLoad{"tx"};
+    uint32_t lastLoadReport = 0;
+
+    // Bumped on every change to nodeList / messageHistory
+    uint32_t nodesVersion = 0;
+    uint32_t messagesVersion = 0;
+    SnapshotBuffer<ClientSnapshot> snapshots;
+    uint32_t lastNodesPublish = 0;  // Node list copies are rate limited while the node DB downloads
+    bool reportRequested = false;   // CMD_REPORT seen; the next publish carries a ClientReport
+    ClientEventBus events;
+
+    RadioLog radioLog;
+    // MeshPackets already handled, so repeats are dropped before decoding
+    RecentPacketFilter recentPackets;
+
+    // Outgoing packets awaiting a routing ack; resolves acks without scanning history
+    PendingAckTable pendingAcks;
+    uint32_t nextHistorySeq = 1;
+    uint32_t lastAckSweepTime = 0;
+    static constexpr uint32_t ACK_TIMEOUT_MS = 60000;       // Covers the radio's own retransmissions
+    static constexpr uint32_t ACK_SWEEP_INTERVAL_MS = 1000;
 
     // Private helper methods
     void loadSettings();
     void saveSettings();
-    void addMessageToHistory(const MeshtasticMessage &msg);
+    // eventFlags: MSG_EVENT_* for the EVT_MESSAGE_ADDED it posts
+    void addMessageToHistory(const MeshtasticMessage &msg, uint8_t eventFlags = 0);
     void updateScreenTimeout();
     void handleConfigTimeout();
-    bool tryInitUART();
-    bool probeUARTOnce();
-    void drainIncoming(bool processAll, bool fastMode);
+    bool configSessionActive() const {
+        return configSession.state == CFG_REQUESTED || configSession.state == CFG_STREAMING;
+    }
+    bool startConfigSession(ConfigPhase phase);
+    bool sendConfigRequest();
+    void onConfigFrame(const ParsedFromRadio &parsed);
+    void finishConfigSession(ConfigSessionState result);
+    bool tryInitUART(bool detectBaud = true);
+    // Closes the Grove port under the link lock and clears its flags
+    void closeUART();
+    uint32_t detectUARTBaud();
+    bool probeUARTBaud(uint32_t baud, uint32_t saved);
+    void onSerialConfig(const ParsedFromRadio &parsed);
+    void serviceUARTUpgrade(uint32_t now);
+    void failUARTUpgrade(const char *reason);
+    void serviceKeepalive(uint32_t now);
+    void serviceTcpLink(uint32_t now);
+    void onTcpLinkDown(const char *reason);
+    void drainLink(uint32_t now);
+    size_t drainIncoming(size_t maxFrames);
     void processTextMessage();
     bool connectToBLE(const NimBLEAdvertisedDevice *device, const String &addressOrName = "");
     static void AsyncConnectTask(void *param);
-    bool sendProtobuf(const uint8_t *data, size_t length, bool preferResponse = false);
-    std::vector<uint8_t> receiveProtobuf();
-    std::vector<uint8_t> receiveProtobufUART();
-    bool sendProtobufUART(const uint8_t *data, size_t len, bool allowWhenUnavailable);
+    bool startTxQueue();
+    int acquireTxSlot();
+    // Queues a filled slot for TxTask; on failure the slot is released
+    bool submitTxSlot(int slot);
+    // Hands back a slot that won't be submitted (e.g. the frame didn't build)
+    void releaseTxSlot(int slot);
+    static void TxTask(void *param);
+    static void ProtocolTask(void *param);
+    void wakeProtocolTask(EventBits_t bits);
+    // One protocol pass: everything loop() does, given what woke it
+    void runPass(uint32_t now, EventBits_t wake);
+    // Re-arms protoTimers from the current state after each pass
+    void armTimers(uint32_t now);
+    bool queueCommand(const ClientCommand &cmd);
+    void runCommand(const ClientCommand &cmd);
+    ClientStatus currentStatus() const;
+    // Scan list lookups, under scanListMutex
+    String scannedAddressFor(const String &name) const;
+    int scannedAddrTypeFor(const String &address) const;  // -1 if not in the list
+    void clearScanList();
+    void processTxResults();
+    void onQueueStatus(const ParsedQueueStatus &qs);
+    void onRoutingAck(const ParsedRoutingAck &ack);
+    void sweepPendingAcks(uint32_t now);
+    bool sendProtobuf(const uint8_t *data, size_t length);
+    // frame must hold STREAM_HEADER_SIZE bytes of headroom followed by payloadLen bytes
+    bool sendFrame(uint8_t *frame, size_t payloadLen);
+    bool sendMeshCoreFrame(const std::vector<uint8_t> &frame);
+    size_t receiveFrames(std::vector<std::vector<uint8_t>> &out, size_t maxFrames);
+    void serviceDeferredUARTConfig();
 
 };
 
@@ -39,6 +39,28 @@ enum PortNum {
     MAX = 511
 };
 
+// Routing.Error - why the mesh could not deliver a packet (NONE is an ack)
+enum RoutingError {
+    ROUTING_ERROR_NONE = 0,
+    ROUTING_ERROR_NO_ROUTE = 1,
+    ROUTING_ERROR_GOT_NAK = 2,
+    ROUTING_ERROR_TIMEOUT = 3,
+    ROUTING_ERROR_NO_INTERFACE = 4,
+    ROUTING_ERROR_MAX_RETRANSMIT = 5,
+    ROUTING_ERROR_NO_CHANNEL = 6,
+    ROUTING_ERROR_TOO_LARGE = 7,
+    ROUTING_ERROR_NO_RESPONSE = 8,
+    ROUTING_ERROR_DUTY_CYCLE_LIMIT = 9,
+    ROUTING_ERROR_BAD_REQUEST = 32,
+    ROUTING_ERROR_NOT_AUTHORIZED = 33,
+    ROUTING_ERROR_PKI_FAILED = 34,
+    ROUTING_ERROR_PKI_UNKNOWN_PUBKEY = 35,
+    ROUTING_ERROR_ADMIN_BAD_SESSION_KEY = 36,
+    ROUTING_ERROR_ADMIN_PUBLIC_KEY_UNAUTHORIZED = 37,
+    ROUTING_ERROR_RATE_LIMIT_EXCEEDED = 38
+};
+const char *routingErrorName(uint32_t error);
+
 namespace mini_pb {
 enum WT { VARINT = 0, LEN = 2, I32 = 5 };
 void add_varint(std::vector<uint8_t> &out, uint32_t field, uint64_t v);
@@ -59,14 +81,56 @@ struct Reader {
     bool get_fixed32(uint32_t &v);
     void skip(WT wt);
 };
+
+// Serializes straight into a caller-owned buffer. Nested messages reserve a
+// fixed-width length prefix that end_message() back-patches, so a complete
+// ToRadio is built in one pass with no heap allocation. The prefix is written
+// as a padded two-byte varint, which protobuf decoders accept and which covers
+// anything up to MAX_PACKET_SIZE.
+class Writer {
+public:
+    static constexpr size_t kLenBytes = 2;
+    static constexpr size_t kMaxNestedLen = (1u << (7 * kLenBytes)) - 1;
+
+    Writer(uint8_t *buf, size_t cap) : buf(buf), cap(cap), pos(0), overflow(false) {}
+
+    void varint(uint32_t field, uint64_t v);
+    void fixed32(uint32_t field, uint32_t v);
+    void bytes(uint32_t field, const uint8_t *p, size_t n);
+    // Returns a mark to hand back to end_message() once the body is written
+    size_t begin_message(uint32_t field);
+    void end_message(size_t mark);
+
+    bool ok() const { return !overflow; }
+    // Encoded length, or 0 if the buffer was too small
+    size_t size() const { return overflow ? 0 : pos; }
+    const uint8_t *data() const { return buf; }
+
+private:
+    void put(uint8_t b);
+    void put_varint(uint64_t v);
+    void put_tag(uint32_t field, WT wt) { put_varint((uint64_t(field) << 3) | (uint32_t)wt); }
+
+    uint8_t *buf;
+    size_t cap;
+    size_t pos;
+    bool overflow;
+};
 } // namespace mini_pb
 
+// want_config_id values the firmware treats specially: reply with only
+// config/channels/MyInfo, or with only the NodeInfo database
+constexpr uint32_t WANT_CONFIG_ONLY_CONFIG = 69420;
+constexpr uint32_t WANT_CONFIG_ONLY_NODES = 69421;
+
 std::vector<uint8_t> buildWantConfig(uint32_t nonce);
-std::vector<uint8_t> buildTextMessage(
-    uint32_t fromNodeId, uint32_t toNodeId, uint8_t channel, const String &text, uint32_t &packetIdOut,
-    bool wantAck
+// Builders below encode a ToRadio into out[0..cap) and return its length (0 on error)
+size_t buildTextMessage(
+    uint8_t *out, size_t cap, uint32_t fromNodeId, uint32_t toNodeId, uint8_t channel, const String &text,
+    uint32_t &packetIdOut, bool wantAck
 );
-std::vector<uint8_t> buildTraceRoute(uint32_t destinationNodeId, uint8_t hopLimit, uint32_t requestId);
+size_t buildTraceRoute(uint8_t *out, size_t cap, uint32_t destinationNodeId, uint8_t hopLimit, uint32_t requestId);
+size_t buildHeartbeat(uint8_t *out, size_t cap);
 
 struct ParsedUserInfo {
     String id;
@@ -111,8 +175,23 @@ struct ParsedMeshText {
     bool legacyAckFlag = false;
     String text;
 };
+// ROUTING_APP Routing.error_reason, matched to our packet by Data.request_id
 struct ParsedRoutingAck {
-    uint32_t packetId = 0;
+    uint32_t packetId = 0;     // request_id: the packet being acked or refused
+    uint32_t from = 0;         // Node that sent the ack; our own radio for implicit acks
+    uint32_t errorReason = ROUTING_ERROR_NONE;
+};
+
+// ModuleConfig.SerialConfig, kept whole so a set can round-trip every field
+struct ParsedSerialConfig {
+    bool enabled = false;
+    bool echo = false;
+    uint32_t rxd = 0;
+    uint32_t txd = 0;
+    uint32_t baud = 0;      // Serial_Baud enum value, not bits per second
+    uint32_t timeout = 0;
+    uint32_t mode = 0;      // 2 = PROTO
+    bool overrideConsole = false;
 };
 
 struct ParsedTraceRoute {
@@ -125,16 +204,56 @@ struct ParsedTraceRoute {
     std::vector<float> snrBack;        // Return SNR values
 };
 
+// FromRadio.queueStatus, sent after the radio takes (or refuses) a MeshPacket
+struct ParsedQueueStatus {
+    int32_t res = 0;            // Router error code for meshPacketId, 0 = queued
+    uint32_t free = 0;          // Free slots in the radio's TX queue
+    uint32_t maxlen = 0;
+    uint32_t meshPacketId = 0;  // Packet this is a reply to; 0 if none
+
+    // ERRNO_SHOULD_RELEASE (35) is the router's "handled locally" and not a failure
+    bool accepted() const { return res == 0 || res == 35; }
+};
+
+// FromRadio.log_record: one line of the radio's debug log
+struct ParsedLogRecord {
+    String message;
+    String source;        // Module that logged it, e.g. "Router"; may be empty
+    uint32_t time = 0;    // Radio's epoch seconds, 0 if it has no clock
+    uint32_t level = 0;   // LogRecord.Level: 50 CRITICAL .. 5 TRACE, 0 unset
+};
+
 struct ParsedFromRadio {
     std::vector<ParsedMeshText> texts;
     std::vector<ParsedRoutingAck> acks;
     std::vector<ParsedTraceRoute> traceRoutes;
     std::vector<ParsedNodeInfo> nodes;
     std::vector<ParsedChannelInfo> channels;
+    std::vector<ParsedLogRecord> logRecords;
     ParsedMyInfo myInfo;
     bool hasMyInfo = false;
     bool sawMyInfo = false;
     bool sawConfig = false;
     bool sawConfigComplete = false;
+    uint32_t configCompleteId = 0;  // Echo of the want_config_id nonce
+    bool hasQueueStatus = false;
+    ParsedQueueStatus queueStatus;
+    bool hasSerialConfig = false;   // AdminMessage get_module_config_response
+    ParsedSerialConfig serialConfig;
+    std::vector<uint8_t> adminPasskey;  // session_passkey to echo on the next set
 };
 bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint32_t myNodeId = 0);
+// Reads MeshPacket.from and .id out of a FromRadio.packet without decoding
+// or allocating anything; false for any other FromRadio variant
+bool peekMeshPacketKey(const std::vector<uint8_t> &raw, uint32_t &from, uint32_t &packetId);
+
+// Serial_Baud enum <-> bits per second; serialBaudToEnum returns 0 for rates
+// the serial module can't be set to
+uint32_t serialBaudToEnum(uint32_t bitsPerSecond);
+uint32_t serialBaudFromEnum(uint32_t baudEnum);
+// AdminMessage requests to the attached radio (to = myNodeId, ADMIN_APP)
+size_t buildGetSerialConfig(uint8_t *out, size_t cap, uint32_t myNodeId, uint32_t packetId);
+size_t buildSetSerialConfig(
+    uint8_t *out, size_t cap, uint32_t myNodeId, const ParsedSerialConfig &cfg,
+    const std::vector<uint8_t> &passkey, uint32_t packetId
+);
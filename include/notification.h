@@ -2,6 +2,7 @@
 #define NOTIFICATION_H
 
 #include <Arduino.h>
+#include "client_events.h"
 
 // Ringtone types
 enum RingtoneType {
@@ -29,6 +30,12 @@ public:
     void playRingtone(RingtoneType type);
     void playNotification(bool isBroadcast);
     void stopRingtone();
+
+    // Rings for alerting messages posted on the client's event bus. service()
+    // blocks while the tone plays, so it runs outside the client state lock;
+    // a burst of messages gets one ringtone, a DM taking precedence.
+    void listen(ClientEventBus &bus) { events = bus.subscribe(); }
+    void service();
     
     // Settings management
     void loadSettings();
@@ -41,6 +48,7 @@ public:
     
 private:
     NotificationSettings settings;
+    ClientEventBus::Subscriber events;
     bool speakerAvailable = false;  // True on CardPuter ADV
     
     // Audio generation using M5Cardputer.Speaker API (for CardPuter ADV)
@@ -0,0 +1,43 @@
+#ifndef PACKET_FILTER_H
+#define PACKET_FILTER_H
+
+#include <Arduino.h>
+
+// Counters for the recent-packet filter, cumulative since boot
+struct PacketFilterStats {
+    uint32_t lookups = 0;
+    uint32_t hits = 0;       // Duplicates dropped
+    uint32_t evictions = 0;  // Live entries pushed out before aging
+};
+
+// Fixed-size set of recently seen (from, packetId) pairs, used to drop
+// MeshPackets the radio hands us more than once. Each key hashes to a
+// window of PROBE consecutive slots; a miss takes an empty or expired slot
+// in the window, or else the oldest one, so nothing ever needs deleting and
+// memory is fixed.
+class RecentPacketFilter {
+public:
+    static constexpr size_t CAPACITY = 128;       // Power of two
+    static constexpr size_t PROBE = 4;
+    static constexpr uint32_t MAX_AGE_MS = 600000; // Matches the firmware's flood expiry
+
+    // True if (from, packetId) was seen within MAX_AGE_MS; otherwise records it
+    bool seen(uint32_t from, uint32_t packetId, uint32_t nowMs);
+    void clear();
+    const PacketFilterStats &stats() const { return st; }
+
+private:
+    struct Entry {
+        uint32_t from = 0;
+        uint32_t packetId = 0;  // 0 marks an empty slot
+        uint32_t seenMs = 0;
+    };
+    static size_t slotFor(uint32_t from, uint32_t packetId) {
+        return (((packetId ^ (from * 0x9E3779B1u)) * 2654435761u) >> 16) & (CAPACITY - 1);
+    }
+
+    Entry slots[CAPACITY];
+    PacketFilterStats st;
+};
+
+#endif // PACKET_FILTER_H
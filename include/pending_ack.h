@@ -0,0 +1,64 @@
+#ifndef PENDING_ACK_H
+#define PENDING_ACK_H
+
+#include <Arduino.h>
+
+// One outgoing packet awaiting a routing ack from the mesh
+struct PendingAck {
+    uint32_t packetId = 0;   // 0 marks an empty slot
+    uint32_t toNodeId = 0;
+    uint32_t historySeq = 0; // Handle to the MeshtasticMessage (see MeshtasticClient::findMessageBySeq)
+    uint32_t sentMs = 0;     // Queue time until the transport confirms the send, then TX time
+    uint8_t retries = 0;     // Transport attempts beyond the first
+    bool sent = false;       // Only sent packets are subject to the ack timeout
+    bool relayed = false;    // A DM heard rebroadcast (implicit ack) but not yet acked by its destination
+};
+
+// Round-trip statistics for acks from one destination
+struct AckRttStats {
+    uint32_t nodeId = 0;
+    uint32_t samples = 0;
+    uint32_t lastMs = 0;
+    uint32_t minMs = 0;
+    uint32_t maxMs = 0;
+    uint32_t avgMs = 0;      // EMA, 1/8 weight per sample
+    uint32_t timeouts = 0;
+    uint32_t updatedMs = 0;
+};
+
+// Fixed-size open-addressed table of packets awaiting acks, keyed by packetId.
+// Linear probing with backward-shift deletion, so lookups stay O(1) without
+// tombstones and nothing is allocated after construction.
+class PendingAckTable {
+public:
+    static constexpr size_t CAPACITY = 32;   // Power of two
+    static constexpr size_t RTT_SLOTS = 16;  // Destinations with RTT history
+
+    bool track(uint32_t packetId, uint32_t toNodeId, uint32_t historySeq, uint32_t nowMs);
+    PendingAck *find(uint32_t packetId);
+    // Transport confirmed the send: restart the clock from the actual TX time
+    void markSent(uint32_t packetId, uint8_t attempts, uint32_t nowMs);
+    // Removes the entry and copies it out; false if it was not tracked
+    bool take(uint32_t packetId, PendingAck &out);
+    // Removes up to maxOut sent entries older than timeoutMs, copying them to out
+    size_t sweep(uint32_t nowMs, uint32_t timeoutMs, PendingAck *out, size_t maxOut);
+    void clear();
+    size_t size() const { return count; }
+
+    void recordRtt(uint32_t nodeId, uint32_t rttMs, uint32_t nowMs);
+    void recordTimeout(uint32_t nodeId, uint32_t nowMs);
+    const AckRttStats *rttFor(uint32_t nodeId) const;
+    const AckRttStats *rttTable() const { return rtt; }
+
+private:
+    static size_t slotFor(uint32_t packetId) { return (packetId * 2654435761u) & (CAPACITY - 1); }
+    int indexOf(uint32_t packetId) const;
+    void removeAt(size_t i);
+    AckRttStats *rttSlot(uint32_t nodeId, uint32_t nowMs);
+
+    PendingAck slots[CAPACITY];
+    size_t count = 0;
+    AckRttStats rtt[RTT_SLOTS];
+};
+
+#endif // PENDING_ACK_H
@@ -0,0 +1,81 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+enum WakeSource : uint8_t {
+    WAKE_TIMER = 0,  // Deadline or key scan slice
+    WAKE_UART,       // Radio sent a byte
+    WAKE_BUTTON,     // G0
+    WAKE_OTHER,
+    WAKE_SOURCE_COUNT
+};
+
+// Idle light sleep for running on battery. With the screen off and neither
+// the UI nor the protocol task having anything to do before the next
+// deadline, the whole chip light-sleeps until that deadline, a byte from the
+// radio on the Grove UART, or G0. The key matrix has no interrupt line, so
+// sleep is cut into KEY_SCAN_SLICE_MS slices with a key scan between them;
+// the ADV's TCA8418 queues presses meanwhile, the original matrix only sees
+// keys still held.
+//
+// The UART drops the bytes that wake it, so the frame they begin is lost and
+// the framer resynchronises; USB serial also drops out while asleep. Both
+// are why this is a setting, off by default. The caller keeps BLE and WiFi
+// links awake (see MeshtasticClient::lightSleepBudgetMs).
+class PowerManager {
+public:
+    static constexpr uint32_t MIN_SLEEP_MS = 5;         // Shorter idles aren't worth the wake-up
+    static constexpr uint32_t KEY_SCAN_SLICE_MS = 50;
+    static constexpr int UART_WAKE_EDGES = 3;           // RX edges that wake; about the first byte
+    static constexpr uint32_t WAKE_SAMPLE_MAX_MS = 1000; // A wake nothing came of by then isn't timed
+    // Nominal draw for the estimate; the Cardputer can't measure its current
+    static constexpr float ACTIVE_MA = 45.0f;
+    static constexpr float SLEEP_MA = 3.0f;
+
+    void begin();
+    bool enabled() const { return sleepEnabled; }
+    void setEnabled(bool on);
+
+    // Light-sleeps for up to ms, waking early on a UART RX byte (if
+    // uartWake) or G0 going low. Call with interrupts that touch GPIO0
+    // attached as usual; they are parked for the sleep and restored.
+    WakeSource sleep(uint32_t ms, bool uartWake, int uartNum);
+    // The input a wake was for has been handled; times the wake
+    void noteProcessed();
+    // Counters restart, e.g. when the setting changes
+    void resetStats();
+
+    uint32_t sleeps() const { return sleepCount; }
+    uint32_t wakes(WakeSource source) const { return source < WAKE_SOURCE_COUNT ? wakeCount[source] : 0; }
+    // Share of wall time spent asleep since the counters restarted, 0-100
+    uint8_t sleepPercent() const;
+    // Average draw estimated from the sleep share and the nominal figures
+    float estimatedMa() const;
+    uint32_t lastWakeLatencyUs() const { return wakeLatencyLastUs; }
+    uint32_t maxWakeLatencyUs() const { return wakeLatencyMaxUs; }
+    uint32_t wakeSamples() const { return wakeLatencyCount; }
+    // Battery voltage now and its trend since the counters restarted, where
+    // the board can read it; the nearest thing to a measured drain
+    int16_t batteryMv() const;
+    int32_t batteryMvPerHour() const;
+
+private:
+    void loadSettings();
+    void saveSettings();
+
+    bool sleepEnabled = false;
+    uint32_t sleepCount = 0;
+    uint32_t wakeCount[WAKE_SOURCE_COUNT] = {};
+    uint64_t sleptUs = 0;
+    uint64_t statsStartUs = 0;
+    int16_t statsStartMv = 0;
+    uint64_t wakeAtUs = 0;  // Open wake sample; 0 if none
+    uint32_t wakeLatencyLastUs = 0;
+    uint32_t wakeLatencyMaxUs = 0;
+    uint32_t wakeLatencyCount = 0;
+};
+
+extern PowerManager *g_powerManager;
+
+#endif // POWER_MANAGER_H
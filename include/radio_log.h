@@ -0,0 +1,51 @@
+#ifndef RADIO_LOG_H
+#define RADIO_LOG_H
+
+#include <Arduino.h>
+
+// LogRecord.Level values; console lines are mapped onto the same scale
+enum RadioLogLevel : uint8_t {
+    RADIO_LOG_UNSET = 0,
+    RADIO_LOG_TRACE = 5,
+    RADIO_LOG_DEBUG = 10,
+    RADIO_LOG_INFO = 20,
+    RADIO_LOG_WARNING = 30,
+    RADIO_LOG_ERROR = 40,
+    RADIO_LOG_CRITICAL = 50
+};
+
+// One line of the attached radio's debug output
+struct RadioLogEntry {
+    uint32_t ms = 0;          // Local millis() when it arrived
+    uint8_t level = RADIO_LOG_UNSET;
+    char source[16] = {};     // LogRecord.source; empty for console text
+    char text[161] = {};
+};
+
+// Fixed-size ring of the most recent radio log lines, fed from both the
+// serial console text between frames and FromRadio.log_record. Once full,
+// each new line overwrites the oldest; nothing is allocated after construction.
+class RadioLog {
+public:
+    static constexpr size_t CAPACITY = 48;
+
+    void add(uint32_t nowMs, uint8_t level, const char *source, const char *text);
+    size_t size() const { return count; }
+    // 0 is the oldest line still held
+    const RadioLogEntry &at(size_t i) const { return entries[(start + i) % CAPACITY]; }
+    // Lines ever added, including those since overwritten
+    uint32_t total() const { return added; }
+    void clear();
+
+    // Reads the level from a console line's "DEBUG | ..." prefix
+    static uint8_t levelFromConsole(const char *line);
+    static const char *levelName(uint8_t level);
+
+private:
+    RadioLogEntry entries[CAPACITY];
+    size_t start = 0;
+    size_t count = 0;
+    uint32_t added = 0;
+};
+
+#endif // RADIO_LOG_H
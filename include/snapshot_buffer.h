@@ -0,0 +1,83 @@
+#ifndef SNAPSHOT_BUFFER_H
+#define SNAPSHOT_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Single-writer double buffer for handing a consistent copy of state to
+// another task. The buffer takes no lock of its own, but it doesn't make the
+// rest of the writer's state safe to touch. The writer fills the back slot
+// and flips it to the front; a reader pins the front slot for as long as it
+// looks at it and never waits. The writer never touches a pinned slot:
+// beginWrite() returns null instead and the writer tries again on its next
+// pass.
+template <typename T>
+class SnapshotBuffer {
+public:
+    // A pinned slot; the pin is dropped when the Ref goes away
+    class Ref {
+    public:
+        Ref() = default;
+        Ref(Ref &&o) : owner(o.owner), idx(o.idx) { o.owner = nullptr; }
+        Ref &operator=(Ref &&o) {
+            if (this != &o) {
+                release();
+                owner = o.owner;
+                idx = o.idx;
+                o.owner = nullptr;
+            }
+            return *this;
+        }
+        Ref(const Ref &) = delete;
+        Ref &operator=(const Ref &) = delete;
+        ~Ref() { release(); }
+
+        explicit operator bool() const { return owner != nullptr; }
+        const T &operator*() const { return owner->slots[idx]; }
+        const T *operator->() const { return &owner->slots[idx]; }
+        void release() {
+            if (owner) owner->readers[idx].fetch_sub(1);
+            owner = nullptr;
+        }
+
+    private:
+        friend class SnapshotBuffer;
+        Ref(const SnapshotBuffer *o, uint8_t i) : owner(o), idx(i) {}
+        const SnapshotBuffer *owner = nullptr;
+        uint8_t idx = 0;
+    };
+
+    SnapshotBuffer() {
+        readers[0].store(0);
+        readers[1].store(0);
+    }
+
+    // Reader side
+    Ref acquire() const {
+        for (;;) {
+            uint8_t i = front.load();
+            readers[i].fetch_add(1);
+            // Seq-cst pairs with publish(): if the front is still i, the
+            // writer can no longer pick this slot
+            if (front.load() == i) return Ref(this, i);
+            readers[i].fetch_sub(1);
+        }
+    }
+
+    // Writer side. The back slot still holds the snapshot from two
+    // publishes ago; the caller brings it up to date, then publish()es.
+    T *beginWrite() {
+        uint8_t back = front.load() ^ 1;
+        return readers[back].load() ? nullptr : &slots[back];
+    }
+    void publish() { front.store(front.load() ^ 1); }
+    // The current front, for the writer's own comparisons
+    const T &latest() const { return slots[front.load()]; }
+
+private:
+    T slots[2];
+    std::atomic<uint8_t> front{0};
+    mutable std::atomic<uint32_t> readers[2];
+};
+
+#endif // SNAPSHOT_BUFFER_H
@@ -0,0 +1,76 @@
+#ifndef STAGE_PROFILER_H
+#define STAGE_PROFILER_H
+
+#include <Arduino.h>
+
+// Stages of the UI loop and the protocol pass that get their own latency
+// histogram. LOCK_WAIT is the UI loop blocked on the client's state lock
+// before a light sleep, i.e. on a protocol pass. The client stages nest:
+// CLIENT_LOOP is the whole pass, DRAIN the link reads within it, PARSE and
+// UPSERT the decoding and node DB work within DRAIN.
+enum ProfileStage : uint8_t {
+    STAGE_INPUT_SCAN = 0,  // M5Cardputer.update()
+    STAGE_HANDLE_INPUT,    // ui->handleInput()
+    STAGE_UI_UPDATE,       // ui->update(), drawing included
+    STAGE_LOCK_WAIT,       // UI loop waiting in client->lockState()
+    STAGE_CLIENT_LOOP,     // client->loop()
+    STAGE_PROBE,           // Link service, pairing, UART probe, TCP and keepalive
+    STAGE_DRAIN,           // Reading and handling frames
+    STAGE_PARSE,           // Decoding one frame
+    STAGE_UPSERT,          // Node DB updates from one frame
+    STAGE_COUNT
+};
+
+// Log-bucketed latency histograms, one per stage, for finding what stalls
+// the loops. Bucket i counts samples of [2^i, 2^(i+1)) us, bucket 0 also
+// takes anything shorter and the last bucket anything longer; the maximum
+// is kept exactly. Each stage is only ever written by the task running it,
+// without locking; a reader may see a sample half counted, which is fine
+// for diagnostics.
+class StageProfiler {
+public:
+    static constexpr uint8_t BUCKETS = 20;  // The last one starts at ~524 ms
+
+    // Times the enclosing block, or up to end()
+    class Scope {
+    public:
+        explicit Scope(ProfileStage s) : stage(s), startUs(micros()) {}
+        ~Scope() { end(); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+        void end() {
+            if (done) return;
+            done = true;
+            record(stage, micros() - startUs);
+        }
+
+    private:
+        ProfileStage stage;
+        uint32_t startUs;
+        bool done = false;
+    };
+
+    static void record(ProfileStage stage, uint32_t us);
+    static void reset();
+
+    static const char *name(ProfileStage stage);
+    static uint32_t count(ProfileStage stage);
+    static uint32_t maxUs(ProfileStage stage);
+    // Upper edge of the bucket holding the given percentile (0-100), capped
+    // at the maximum
+    static uint32_t percentileUs(ProfileStage stage, uint8_t pct);
+    // Every stage's histogram to Serial
+    static void dump();
+    // Each stage's p99 and max on one line, for the periodic load report
+    static void printSummary();
+
+private:
+    struct Histogram {
+        uint32_t buckets[BUCKETS];
+        uint32_t count;
+        uint32_t maxUs;
+    };
+    static Histogram stages[STAGE_COUNT];
+};
+
+#endif // STAGE_PROFILER_H
@@ -0,0 +1,48 @@
+#ifndef TASK_LOAD_H
+#define TASK_LOAD_H
+
+#include <Arduino.h>
+
+// Busy-time meter for one task. The task brackets each unit of work with
+// begin()/end(); percent() is the share of wall time spent inside over the
+// last complete window. Meters register themselves by name so diagnostics
+// can list every task without knowing who owns them. Only the owning task
+// writes; other tasks just read the published results.
+class TaskLoad {
+public:
+    static constexpr uint32_t WINDOW_US = 1000000;
+    static constexpr size_t MAX_METERS = 4;
+
+    explicit TaskLoad(const char *name);
+
+    void begin();
+    void end();
+
+    const char *name() const { return taskName; }
+    // Busy share of the last window, 0-100; 0 once the task has gone quiet
+    uint8_t percent() const;
+    // Longest single unit of work in the last window
+    uint32_t maxBusyUs() const { return lastMaxUs; }
+
+    static size_t count() { return registered; }
+    static const TaskLoad *at(size_t i) { return i < registered ? registry[i] : nullptr; }
+    // One line per meter, e.g. for a periodic serial report
+    static void printAll();
+
+private:
+    void roll(uint32_t now);
+
+    const char *taskName;
+    uint32_t windowStart = 0;
+    uint32_t busyStart = 0;
+    uint32_t busyUs = 0;
+    uint32_t maxUs = 0;
+    volatile uint32_t lastEnd = 0;
+    volatile uint8_t lastPercent = 0;
+    volatile uint32_t lastMaxUs = 0;
+
+    static TaskLoad *registry[MAX_METERS];
+    static size_t registered;
+};
+
+#endif // TASK_LOAD_H
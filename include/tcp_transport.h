@@ -0,0 +1,65 @@
+// Meshtastic TCP API: the serial stream protocol (0x94 0xC3 <len16>) on a
+// plain socket, served by WiFi-enabled nodes on port 4403
+#ifndef TCP_TRANSPORT_H
+#define TCP_TRANSPORT_H
+
+#include "transport.h"
+
+#define MESHTASTIC_TCP_PORT 4403
+
+// Uses BSD sockets, which lwIP provides on the ESP32 and the OS provides on a
+// host build, so the same code runs against a local stand-in server in
+// test/host.
+class TcpTransport : public ITransport {
+public:
+    ~TcpTransport() override { close(); }
+
+    TransportKind kind() const override { return TRANSPORT_TCP; }
+    const char *name() const override { return "TCP"; }
+    TransportState state() const override;
+
+    // Never blocks: a frame the socket can't take at all returns false, a
+    // partially written one is finished from service()
+    bool send(uint8_t *frame, size_t payloadLen) override;
+    // Reads whatever the socket has, then hands out up to maxFrames. When the
+    // peer closes or the socket fails, frames already received are still
+    // handed out; the link goes to ERROR once none is left.
+    size_t poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) override;
+    // Completes a pending connect and flushes the unsent tail of a frame
+    void service() override;
+    bool txBusy() const override { return txPendingOff < txPending.size(); }
+    bool nextLogLine(std::string &out) override { return framer.nextLine(out); }
+    // Only what's already been read off the socket
+    size_t rxPendingBytes() const override { return framer.buffered(); }
+
+    // Starts a non-blocking connect; state() turns UP once service() sees it
+    // complete, or ERROR on refusal or after CONNECT_TIMEOUT_MS. host must be
+    // a dotted-quad IPv4 address: a DNS lookup would block the caller, so
+    // names go through resolveHost() first.
+    bool open(const char *host, uint16_t port = MESHTASTIC_TCP_PORT);
+    static bool isNumericHost(const char *host);
+    // Looks host up (DNS, or mDNS for .local names where the stack does it)
+    // and writes its IPv4 address as a dotted quad; a numeric host is copied.
+    // Blocks for as long as the lookup takes, so only from a task that can wait.
+    static bool resolveHost(const char *host, char *ip, size_t ipLen);
+    void close();
+    bool isOpen() const { return sock >= 0; }
+    bool isConnecting() const { return sock >= 0 && connecting; }
+
+    static constexpr uint32_t CONNECT_TIMEOUT_MS = 5000;
+
+private:
+    void fail(const char *what, int err);
+    bool flushPending();
+
+    int sock = -1;
+    bool connecting = false;
+    bool failed = false;
+    int readErr = 0;  // Peer closed or recv failed; set until the buffered frames are out
+    uint32_t connectStart = 0;
+    StreamFramer framer;
+    std::vector<uint8_t> txPending;  // Tail of a frame the socket only partly took
+    size_t txPendingOff = 0;
+};
+
+#endif // TCP_TRANSPORT_H
@@ -0,0 +1,157 @@
+// Link-level transports between the client and a radio. Each backend moves
+// whole FromRadio/ToRadio payloads and does its own byte-level batching;
+// MeshtasticClient only ever talks to the active ITransport.
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// Streaming protocol constants
+#define STREAM_START1 0x94
+#define STREAM_START2 0xC3
+#define MAX_PACKET_SIZE 512
+#define STREAM_HEADER_SIZE 4  // START1, START2, length MSB, length LSB
+
+enum TransportKind : uint8_t {
+    TRANSPORT_NONE = 0,
+    TRANSPORT_UART,
+    TRANSPORT_BLE_MESHTASTIC,
+    TRANSPORT_BLE_MESHCORE,
+    TRANSPORT_TCP,
+    TRANSPORT_SIM
+};
+
+enum TransportState : uint8_t {
+    TRANSPORT_DOWN = 0,
+    TRANSPORT_UP,
+    TRANSPORT_ERROR
+};
+
+struct TransportStats {
+    uint32_t rxBytes = 0;      // On the wire, framing included
+    uint32_t txBytes = 0;
+    uint32_t rxFrames = 0;
+    uint32_t txFrames = 0;
+    uint32_t txErrors = 0;     // send() calls the link refused or failed
+    uint32_t rxDiscarded = 0;  // Bytes dropped while resynchronising on framing
+    uint32_t lastRxMs = 0;
+    uint32_t lastTxMs = 0;
+};
+
+class ITransport {
+public:
+    virtual ~ITransport() {}
+
+    virtual TransportKind kind() const = 0;
+    virtual const char *name() const = 0;
+    virtual TransportState state() const = 0;
+
+    // frame holds STREAM_HEADER_SIZE bytes of headroom followed by payloadLen
+    // payload bytes; stream links fill the header in place, packet links
+    // ignore it. False means not sent (busy or failed); the caller retries.
+    virtual bool send(uint8_t *frame, size_t payloadLen) = 0;
+    // Appends up to maxFrames complete payloads to out and returns how many
+    virtual size_t poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) = 0;
+    // Housekeeping between polls (e.g. noticing TX completion)
+    virtual void service() {}
+    // True while bytes handed to send() are still going out
+    virtual bool txBusy() const { return false; }
+    // True if the link raises a signal when input arrives, so the reader can
+    // sleep instead of polling (see UartTransport::setRxSignal)
+    virtual bool signalsRx() const { return false; }
+    // Bytes received but not yet handed out by poll(), where the link can
+    // tell; sizes the next read (see DrainScheduler)
+    virtual size_t rxPendingBytes() const { return 0; }
+    // Next line of radio console text seen between frames; stream links only
+    virtual bool nextLogLine(std::string &out) { (void)out; return false; }
+
+    bool isUp() const { return state() == TRANSPORT_UP; }
+    const TransportStats &stats() const { return st; }
+
+protected:
+    TransportStats st;
+};
+
+// Incremental decoder for the 0x94 0xC3 <len16> stream framing used over
+// serial and TCP. Bytes go in as they arrive; complete payloads come out.
+// Bytes between frames are the radio's debug console when its serial logging
+// is on: printable runs are assembled into lines (ANSI colour codes stripped)
+// and queued for nextLine(), anything else counts as discarded.
+class StreamFramer {
+public:
+    static constexpr size_t MAX_LINE = 160;       // Longer console lines are split
+    static constexpr size_t MAX_QUEUED_LINES = 16; // Oldest lines drop first
+
+    StreamFramer() { buf.reserve(2 * (STREAM_HEADER_SIZE + MAX_PACKET_SIZE)); }
+
+    void push(const uint8_t *data, size_t len);
+    // Extracts the next complete payload into out; false if none is ready yet
+    bool next(std::vector<uint8_t> &out);
+    // True if next() would return a payload; leaves it buffered
+    bool hasFrame();
+    // Pops the oldest completed console line; false if there is none
+    bool nextLine(std::string &out);
+    void reset();
+    bool empty() const { return head == buf.size(); }
+    size_t buffered() const { return buf.size() - head; }
+    // Bytes skipped looking for a frame start since the last call, not
+    // counting console text
+    size_t takeDiscarded() {
+        size_t d = discarded;
+        discarded = 0;
+        return d;
+    }
+    // Console lines dropped because nobody collected them in time
+    size_t droppedLines() const { return linesDropped; }
+
+    // Writes the header into frame[0..STREAM_HEADER_SIZE) for a payload of len
+    static void writeHeader(uint8_t *frame, size_t len);
+
+private:
+    // Skips to the next frame start; true with its payload length once the
+    // whole frame is buffered at head
+    bool sync(size_t &len);
+    void takeText(const uint8_t *p, size_t n);
+    void endLine();
+
+    std::vector<uint8_t> buf;
+    size_t head = 0;        // Read offset; consumed bytes are compacted away in push()
+    size_t discarded = 0;
+    std::string line;       // Console line being assembled
+    uint8_t escState = 0;   // 1 after ESC, 2 inside a CSI sequence
+    std::deque<std::string> lines;
+    size_t linesDropped = 0;
+};
+
+// In-memory loopback: frames injected with inject() come out of poll(),
+// frames passed to send() are kept for inspection. Lets the client and the
+// protocol code run against scripted traffic with no radio attached.
+class SimTransport : public ITransport {
+public:
+    TransportKind kind() const override { return TRANSPORT_SIM; }
+    const char *name() const override { return "SIM"; }
+    TransportState state() const override { return up ? TRANSPORT_UP : TRANSPORT_DOWN; }
+
+    bool send(uint8_t *frame, size_t payloadLen) override;
+    size_t poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) override;
+
+    void setUp(bool isUp) { up = isUp; }
+    void inject(const uint8_t *payload, size_t len) { inbound.emplace_back(payload, payload + len); }
+    void inject(const std::vector<uint8_t> &payload) { inbound.push_back(payload); }
+    // Fail the next n send() calls, to exercise retry paths
+    void failNextSends(uint32_t n) { failSends = n; }
+
+    std::vector<std::vector<uint8_t>> sent;
+
+private:
+    bool up = true;
+    uint32_t failSends = 0;
+    std::vector<std::vector<uint8_t>> inbound;
+    size_t inboundHead = 0;
+};
+
+#endif // TRANSPORT_H
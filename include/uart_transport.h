@@ -0,0 +1,91 @@
+// Grove UART link to a Meshtastic radio running its serial module in PROTO mode
+#ifndef UART_TRANSPORT_H
+#define UART_TRANSPORT_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "transport.h"
+
+// Use ESP-IDF UART driver instead of Arduino Serial1
+#define USE_ESP_IDF_UART 1
+
+class UartTransport : public ITransport {
+public:
+    TransportKind kind() const override { return TRANSPORT_UART; }
+    const char *name() const override { return "UART"; }
+    TransportState state() const override { return opened ? TRANSPORT_UP : TRANSPORT_DOWN; }
+
+    // Frames go to the driver's TX ring in one write; a frame that doesn't fit
+    // returns false instead of blocking
+    bool send(uint8_t *frame, size_t payloadLen) override;
+    // Reads everything the driver has buffered, then hands out up to maxFrames
+    size_t poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) override;
+    // Notices when the TX ring has drained
+    void service() override;
+    bool txBusy() const override { return txInFlight > 0; }
+    // Radio debug console lines the framer found between frames
+    bool nextLogLine(std::string &out) override { return framer.nextLine(out); }
+    // Driver RX ring plus whatever the framer holds
+    size_t rxPendingBytes() const override { return available() + framer.buffered(); }
+#ifdef USE_ESP_IDF_UART
+    bool signalsRx() const override { return rxEventTask != nullptr; }
+#else
+    bool signalsRx() const override { return opened && rxGroup; }
+#endif
+
+    // Bits to set in group whenever the driver reports received bytes; takes
+    // effect on the next open()
+    void setRxSignal(EventGroupHandle_t group, EventBits_t bits) {
+        rxGroup = group;
+        rxBits = bits;
+    }
+
+    bool open(uint32_t baud, int txPin, int rxPin);
+    void close();
+    bool isOpen() const { return opened; }
+    uint32_t baud() const { return currentBaud; }
+    // Changes the line rate in place, once anything queued has gone out
+    void setBaud(uint32_t baud);
+    // Discards unread input, including any partial frame
+    void flushInput();
+    // Reads what the driver holds and reports whether a complete frame is
+    // waiting; the frame stays for poll()
+    bool frameReady();
+
+    // Unframed access for TextMsg mode
+    size_t available() const;
+    int readRaw(uint8_t *buf, size_t cap, uint32_t timeoutMs);
+
+    uint32_t lastTxDurationMs() const { return txLastDurationMs; }
+    // Hardware UART behind the link, for light sleep wake-up
+    static constexpr int PORT = 1;
+#ifndef USE_ESP_IDF_UART
+    HardwareSerial *port() const { return serialPort; }
+#endif
+
+private:
+    // Moves everything the driver has buffered into the framer
+    void readInput();
+
+    bool opened = false;
+    uint32_t currentBaud = 0;
+    StreamFramer framer;
+    size_t txInFlight = 0;       // Bytes queued in the driver since it was last idle
+    uint32_t txStartTime = 0;
+    uint32_t txLastDurationMs = 0;
+    EventGroupHandle_t rxGroup = nullptr;
+    EventBits_t rxBits = 0;
+#ifdef USE_ESP_IDF_UART
+    // Driver event queue, forwarded to rxGroup by a small task
+    static void RxEventTask(void *param);
+    QueueHandle_t rxEvents = nullptr;
+    TaskHandle_t rxEventTask = nullptr;
+#else
+    HardwareSerial *serialPort = nullptr;
+#endif
+};
+
+#endif // UART_TRANSPORT_H
@@ -1,11 +1,9 @@
 #pragma once
 
 #include "globals.h"
+#include "meshtastic_client.h"
 #include <vector>
 
-// Forward declaration
-class MeshtasticClient;
-
 // UI Constants (heights are logical; width/height will be dynamically obtained from M5.Lcd)
 #define HEADER_HEIGHT 24
 #define TAB_BAR_HEIGHT 18
@@ -50,7 +48,10 @@ public:
         INPUT_SET_TX,
         INPUT_SET_RX,
         INPUT_SET_BRIGHTNESS,
-        INPUT_ENTER_BLE_PIN  // For BLE pairing PIN input
+        INPUT_ENTER_BLE_PIN,  // For BLE pairing PIN input
+        INPUT_SET_WIFI_SSID,
+        INPUT_SET_WIFI_PASSWORD,
+        INPUT_SET_TCP_HOST
     };
 
     enum MessageType : uint8_t {
@@ -86,7 +87,8 @@ public:
         MODAL_NOTIFICATION_MENU, // For notification settings menu (100)
         MODAL_NOTIFICATION_BC_RINGTONE, // Broadcast ringtone selection (101)
         MODAL_NOTIFICATION_DM_RINGTONE, // DM ringtone selection (102)
-        MODAL_NOTIFICATION_VOLUME  // Volume selection (103)
+        MODAL_NOTIFICATION_VOLUME, // Volume selection (103)
+        MODAL_UART_SPEED           // Grove link baud upgrade target
     };
 
     MeshtasticUI();
@@ -98,6 +100,11 @@ public:
     uint32_t splashDurationMs;
 
     void setClient(MeshtasticClient *client);
+    // Bracket one handleInput()/update()/draw() pass: pins the client's latest
+    // snapshot, which is all the UI reads of client state. Changes go the
+    // other way as client commands.
+    void beginFrame();
+    void endFrame();
     void handleInput();
     void update();
     void draw();
@@ -111,7 +118,7 @@ public:
 
     // Tab display methods
     void showMessagesTab();
-    void showNodesTab();
+    void showNodesTab(uint32_t onlyNodeId = 0);  // Non-zero: just that row, plus details if it is selected
     void showSettingsTab();
     void drawSettingsContentOnly();  // For partial redraw of settings content
 
@@ -129,6 +136,8 @@ public:
     void displayWarning(const String& message);
     void displayError(const String& message);
     void openAboutDialog();
+    void openRadioLogDialog();  // Recent radio debug output, newest at the bottom
+    void openDiagnosticsDialog();  // Link and protocol counters, as of a report taken at open
     void scrollToLatestMessage();  // Auto-scroll to the latest message
     
     // BLE pairing PIN display
@@ -136,6 +145,18 @@ public:
     bool confirmBlePinCode(const String& pinCode);
 
     void forceRedraw() { needsRedraw = true; }
+    // Display off: update() keeps its state machines going but draws
+    // nothing, and every kind of repaint request collapses into needsRedraw.
+    // Leaving headless repaints the whole screen from the current state.
+    void setHeadless(bool on);
+    bool isHeadless() const { return headless; }
+    // Headless loop pass: keeps up with the client's event bus so nothing
+    // waiting there is overwritten, without drawing. Events fold into one
+    // pending redraw, the newest message popup, the last trace route and
+    // the dialogs the client asked for; the first frame after wake shows them.
+    void drainEventsHeadless();
+    // A stored node changed (NodeChange mask); queues a row repaint if it shows
+    void onNodeChanged(uint32_t nodeId, uint8_t changeMask);
 
     // Menus & dialogs
     void openDeviceListMenu();
@@ -155,6 +176,9 @@ public:
     void openBleAutoConnectMenu();
     void openConnectionMenu();  // New connection menu for Messages tab
     void openNotificationMenu(); // Notification settings menu
+    void openUARTSpeedMenu();    // Radio serial baud upgrade
+    void startWifiConnection();  // Join WiFi and open the radio's TCP API
+    String connectionTypeLabel() const;
     
     // Connection settings management
     void saveConnectionSettings();
@@ -187,8 +211,10 @@ public:
     bool needsRedraw = false;
     bool needModalRedraw = false;
     bool needImmediateModalRedraw = false;  // For urgent modal display (like PIN input)
+    bool headless = false;  // See setHeadless()
     bool needSettingsRedraw = false;  // For settings partial redraw
     bool needContentOnlyRedraw = false;  // For content-only partial redraw
+    std::vector<uint32_t> dirtyNodeRows;  // Node rows to repaint, from onNodeChanged()
     String statusMessage;
     uint32_t statusMessageTime = 0;
     uint32_t statusMessageDuration = 2000;  // Default 2 seconds, can be customized
@@ -233,7 +259,15 @@ private:
         SETTING_BLE_DEVICES = 9,
         SETTING_BLE_AUTO_CONNECT = 10,
         SETTING_BLE_CLEAR_PAIRED = 11,
-        SETTING_NOTIFICATION = 12
+        SETTING_NOTIFICATION = 12,
+        SETTING_UART_SPEED = 13,
+        SETTING_WIFI_SSID = 14,
+        SETTING_WIFI_PASSWORD = 15,
+        SETTING_TCP_HOST = 16,
+        SETTING_TCP_CONNECT = 17,
+        SETTING_RADIO_LOG = 18,
+        SETTING_DIAGNOSTICS = 19,
+        SETTING_POWER_SAVE = 20
     };
 
     enum BleAutoConnectMode : uint8_t {
@@ -244,7 +278,8 @@ private:
 public:
     enum ConnectionType : uint8_t {
         CONNECTION_GROVE = 0,
-        CONNECTION_BLUETOOTH = 1
+        CONNECTION_BLUETOOTH = 1,
+        CONNECTION_WIFI = 2
     };
     
     // Connection type management
@@ -265,9 +300,6 @@ public:
     String modalTitle;
     String modalInfo;  // For displaying information in modals
     
-    // BLE PIN input (public for BLE pairing callbacks)
-    String blePinInput;
-    
     // Input state (public for BLE pairing)
     PendingInputAction pendingInputAction = INPUT_NONE;
     uint32_t pendingNodeId = 0xFFFFFFFF;
@@ -299,6 +331,7 @@ private:
     void drawModalList();
     void updateVisibleNodes();
     void updateVisibleMessages();
+    void fitVisibleMessages();  // Recomputes visibleMessageIndices from the history
     void updateVisibleSettings();
     void drawScrollbar(int x, int y, int width, int height, int totalItems, int visibleItems, int startIndex);
     void computeTextLines(const String& text, int maxWidth, bool useFont2 = false);
@@ -314,7 +347,33 @@ private:
     void showDestinationList();                // Show destination selection interface  
     void showMessagesForDestination();         // Show messages for current destination
     void selectDestination(int index);         // Select a destination by index
-    std::vector<struct MeshtasticMessage> getFilteredMessages(); // Get messages for current destination
+    const std::vector<MeshtasticMessage> &getFilteredMessages(); // Messages for current destination, cached
+
+    // Client state as of the snapshot pinned for this frame; everything the
+    // UI draws or decides on comes from here, never from the live client.
+    // Outside a frame, an empty snapshot.
+    const ClientSnapshot &snapshot() const;
+    const std::vector<MeshtasticNode> &nodes() const;
+    const std::vector<MeshtasticMessage> &messages() const;
+    const MeshtasticNode *findNode(uint32_t nodeId) const;
+    uint32_t myNodeId() const;
+    uint32_t nodesVersion() const;
+    uint32_t messagesVersion() const;
+    const MeshtasticMessage *findMessage(uint32_t historySeq) const;
+
+    // Client events since the last frame; drained from beginFrame()
+    ClientEventBus::Subscriber clientEvents;
+    void drainClientEvents();
+    // Set while headless, taken by the next drainClientEvents()
+    bool deferredRedraw = false;
+    uint32_t deferredAlertSeq = 0;     // historySeq of the newest popup message
+    bool deferredCloseModal = false;
+    bool deferredPinEntry = false;
+    bool haveDeferredTrace = false;
+    ClientEvent deferredTrace;         // EVT_TRACE_ROUTE_RESULT
+    void showTraceRouteEvent(const ClientEvent &e);
+    // Dialogs the BLE connect, scan and pairing flows ask for (EVT_UI_REQUEST)
+    void onUiRequest(uint8_t kind, const char *text);
 
     uint32_t lastClockSeconds = 0;
     String lastClockStr;
@@ -335,6 +394,35 @@ private:
     int settingsVisibleItems = 0;  // Number of settings items that can be displayed
     int settingsTotalItems = 0;    // Total number of settings items
 
+    SnapshotBuffer<ClientSnapshot>::Ref frameSnapshot;
+    uint32_t frameMessagesVersion = 0;  // Messages version the last frame saw
+    uint32_t frameScanListVersion = 0;
+    ClientStatus frameStatus;           // Settings the settings tab last showed
+
+    // Radio Log and Diagnostics wait for a ClientReport (CMD_REPORT); the
+    // text goes in once one newer than reportRequestVersion is published
+    enum ReportView : uint8_t { REPORT_NONE, REPORT_RADIO_LOG, REPORT_DIAGNOSTICS };
+    uint8_t reportView = REPORT_NONE;
+    uint32_t reportRequestVersion = 0;
+    void requestReport(uint8_t view);
+    void showRadioLog(const ClientReport *report);
+    void showDiagnostics(const ClientReport *report);
+
+    // Lists derived from client state, rebuilt only when the version they
+    // were built from (and the view they depend on) changes
+    std::vector<MeshtasticMessage> filteredMessages;
+    bool filteredValid = false;
+    uint32_t filteredVersion = 0;
+    uint32_t filteredDestination = 0;
+    uint32_t filteredMyNodeId = 0;
+    bool destinationsValid = false;
+    uint32_t destinationsVersion = 0;
+    uint32_t destinationsMyNodeId = 0;
+    bool visibleMessagesValid = false;
+    uint32_t visibleMessagesVersion = 0;
+    bool visibleNodesValid = false;
+    uint32_t visibleNodesVersion = 0;
+
     // Cached lists for selections
     std::vector<uint32_t> visibleNodeIds;
     std::vector<int> visibleMessageIndices;
@@ -357,6 +445,8 @@ private:
     std::vector<String> bleDeviceNames;
     std::vector<String> bleDeviceAddresses;
     std::vector<bool> bleDevicePaired;
+    uint32_t bleScanListVersion = 0;  // Snapshot scan list the copies above came from
+    void copyScanList();
     // 显示列表到原始扫描结果的索引映射（仅包含有名称的设备，排序后顺序）
     std::vector<int> bleDisplayIndices;
     int bleSelectedIndex = 0;
@@ -0,0 +1,133 @@
+#include "ble_transport.h"
+
+// ---------------- Meshtastic ----------------
+
+void BleMeshtasticTransport::attach(
+    NimBLEClient *bleClient, NimBLERemoteCharacteristic *toRadioChar, NimBLERemoteCharacteristic *fromRadioChar
+) {
+    client = bleClient;
+    toRadio = toRadioChar;
+    fromRadio = fromRadioChar;
+}
+
+void BleMeshtasticTransport::detach() {
+    client = nullptr;
+    toRadio = nullptr;
+    fromRadio = nullptr;
+}
+
+TransportState BleMeshtasticTransport::state() const {
+    if (!client || !toRadio || !fromRadio) return TRANSPORT_DOWN;
+    return client->isConnected() ? TRANSPORT_UP : TRANSPORT_ERROR;
+}
+
+bool BleMeshtasticTransport::send(uint8_t *frame, size_t payloadLen) {
+    if (!toRadio || !frame || payloadLen == 0 || payloadLen > MAX_PACKET_SIZE) {
+        st.txErrors++;
+        return false;
+    }
+    const uint8_t *payload = frame + STREAM_HEADER_SIZE;
+    // BLE TX: use write-with-response for reliability on ToRadio characteristic
+    bool success = toRadio->writeValue(payload, payloadLen, /*withResponse=*/true);
+    if (!success) {
+        // Retry after securing connection (lazy pairing trigger)
+        if (client && client->secureConnection()) {
+            success = toRadio->writeValue(payload, payloadLen, /*withResponse=*/true);
+            Serial.printf("[BLE-TX] retry write(withResponse) result=%d\n", success ? 1 : 0);
+        } else {
+            Serial.println("[BLE] Secure connection failed or unavailable");
+        }
+    }
+    if (!success) {
+        st.txErrors++;
+        return false;
+    }
+    st.txBytes += payloadLen;
+    st.txFrames++;
+    st.lastTxMs = millis();
+    return true;
+}
+
+size_t BleMeshtasticTransport::poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) {
+    if (!fromRadio) return 0;
+    size_t n = 0;
+    // An empty read means the radio's FromRadio queue is drained
+    while (n < maxFrames) {
+        std::string value = fromRadio->readValue();
+        if (value.empty()) break;
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(value.data());
+        out.emplace_back(p, p + value.size());
+        st.rxBytes += value.size();
+        st.rxFrames++;
+        n++;
+    }
+    if (n) st.lastRxMs = millis();
+    return n;
+}
+
+// ---------------- MeshCore ----------------
+
+void BleMeshCoreTransport::attach(NimBLEClient *bleClient, NimBLERemoteCharacteristic *rxChar) {
+    client = bleClient;
+    rx = rxChar;
+}
+
+void BleMeshCoreTransport::detach() {
+    client = nullptr;
+    rx = nullptr;
+    // Anything still queued belongs to the old link (consumer-side reset)
+    notifyTail.store(notifyHead.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+TransportState BleMeshCoreTransport::state() const {
+    if (!client || !rx) return TRANSPORT_DOWN;
+    return client->isConnected() ? TRANSPORT_UP : TRANSPORT_ERROR;
+}
+
+bool BleMeshCoreTransport::send(uint8_t *frame, size_t payloadLen) {
+    if (!rx || !frame || payloadLen == 0 || payloadLen > MAX_PACKET_SIZE) {
+        st.txErrors++;
+        return false;
+    }
+    if (!rx->writeValue(frame + STREAM_HEADER_SIZE, payloadLen, false)) {
+        st.txErrors++;
+        return false;
+    }
+    st.txBytes += payloadLen;
+    st.txFrames++;
+    st.lastTxMs = millis();
+    return true;
+}
+
+size_t BleMeshCoreTransport::poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) {
+    uint32_t tail = notifyTail.load(std::memory_order_relaxed);
+    uint32_t head = notifyHead.load(std::memory_order_acquire);
+    size_t n = 0;
+    while (tail != head && n < maxFrames) {
+        const NotifySlot &slot = notifyRing[tail & (NOTIFY_SLOTS - 1)];
+        out.emplace_back(slot.data, slot.data + slot.len);
+        st.rxBytes += slot.len;
+        st.rxFrames++;
+        tail++;
+        n++;
+    }
+    // Hands the slots back to the producer only after they've been copied out
+    notifyTail.store(tail, std::memory_order_release);
+    if (n) st.lastRxMs = millis();
+    return n;
+}
+
+bool BleMeshCoreTransport::pushNotify(const uint8_t *data, size_t length) {
+    if (!data || length == 0) return false;
+    uint32_t head = notifyHead.load(std::memory_order_relaxed);
+    uint32_t tail = notifyTail.load(std::memory_order_acquire);
+    if (length > NOTIFY_SLOT_SIZE || head - tail >= NOTIFY_SLOTS) {
+        notifyDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    NotifySlot &slot = notifyRing[head & (NOTIFY_SLOTS - 1)];
+    memcpy(slot.data, data, length);
+    slot.len = (uint16_t)length;
+    notifyHead.store(head + 1, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,149 @@
+#include "client_events.h"
+#include <algorithm>
+
+ClientEventBus::Subscriber ClientEventBus::subscribe() {
+    Subscriber sub;
+    portENTER_CRITICAL(&lock);
+    sub.bus = this;
+    sub.tail = head;
+    portEXIT_CRITICAL(&lock);
+    return sub;
+}
+
+bool ClientEventBus::Subscriber::next(ClientEvent &out) {
+    if (!bus) return false;
+    portENTER_CRITICAL(&bus->lock);
+    uint32_t head = bus->head;
+    if (head - tail > CAPACITY) {
+        uint32_t lostTo = head - CAPACITY;
+        missed += lostTo - tail;
+        // Still replaying an earlier loss: tail is where that stretch ends,
+        // so the two join up
+        if (replayFrom == replayTo) replayFrom = tail;
+        replayTo = lostTo;
+        tail = lostTo;
+    }
+    bool any = replayFrom != replayTo && bus->takeLatched(replayFrom, replayTo, out);
+    if (!any) {
+        replayFrom = replayTo;
+        any = tail != head;
+        if (any) out = bus->ring[tail++ & (CAPACITY - 1)];
+    }
+    portEXIT_CRITICAL(&bus->lock);
+    return any;
+}
+
+int ClientEventBus::latchSlot(const ClientEvent &event) {
+    switch (event.type) {
+        case EVT_UI_REQUEST:
+            if (event.request.kind == UI_REQ_CLOSE_MODAL) return LATCH_CLOSE_MODAL;
+            if (event.request.kind == UI_REQ_BLE_PIN_ENTRY) return LATCH_BLE_PIN_ENTRY;
+            if (event.request.kind == UI_REQ_BLE_TARGET) return LATCH_BLE_TARGET;
+            return -1;  // The scan list itself is in the client
+        case EVT_MESSAGE_ADDED:
+            return (event.message.flags & (MSG_EVENT_ALERT | MSG_EVENT_TOAST)) ? LATCH_MESSAGE_ALERT : -1;
+        case EVT_TRACE_ROUTE_RESULT:
+            return LATCH_TRACE_ROUTE;
+        default:
+            return -1;
+    }
+}
+
+bool ClientEventBus::takeLatched(uint32_t &from, uint32_t to, ClientEvent &out) const {
+    int oldest = -1;
+    for (uint8_t i = 0; i < LATCH_COUNT; i++) {
+        if (!(latchValid & (1 << i))) continue;
+        // Wrap-safe: a latch since overwritten by a newer post falls outside
+        if (latchSeq[i] - from >= to - from) continue;
+        if (oldest < 0 || latchSeq[i] - from < latchSeq[oldest] - from) oldest = i;
+    }
+    if (oldest < 0) return false;
+    out = latches[oldest];
+    from = latchSeq[oldest] + 1;
+    return true;
+}
+
+void ClientEventBus::post(const ClientEvent &event) {
+    int slot = latchSlot(event);
+    portENTER_CRITICAL(&lock);
+    ring[head & (CAPACITY - 1)] = event;
+    if (slot >= 0) {
+        latches[slot] = event;
+        latchSeq[slot] = head;
+        latchValid |= 1 << slot;
+    }
+    head++;
+    portEXIT_CRITICAL(&lock);
+    wake();
+}
+
+void ClientEventBus::postNodeChanged(uint32_t id, uint8_t mask) {
+    ClientEvent e;
+    e.type = EVT_NODE_CHANGED;
+    e.node.id = id;
+    e.node.mask = mask;
+    post(e);
+}
+
+void ClientEventBus::postNodeListChanged() {
+    ClientEvent e;
+    e.type = EVT_NODE_LIST_CHANGED;
+    post(e);
+}
+
+void ClientEventBus::postMessageAdded(uint32_t historySeq, uint8_t flags) {
+    ClientEvent e;
+    e.type = EVT_MESSAGE_ADDED;
+    e.message.historySeq = historySeq;
+    e.message.flags = flags;
+    post(e);
+}
+
+void ClientEventBus::postAckUpdated(uint32_t packetId, uint8_t status, uint8_t failReason) {
+    ClientEvent e;
+    e.type = EVT_ACK_UPDATED;
+    e.ack.packetId = packetId;
+    e.ack.status = status;
+    e.ack.failReason = failReason;
+    post(e);
+}
+
+void ClientEventBus::postTraceRoute(uint32_t target, const std::vector<uint32_t> &route, const std::vector<float> &snr,
+                                    const std::vector<uint32_t> &routeBack, const std::vector<float> &snrBack) {
+    ClientEvent e;
+    e.type = EVT_TRACE_ROUTE_RESULT;
+    e.trace.target = target;
+    e.trace.hops = (uint8_t)std::min<size_t>(route.size(), MAX_TRACE_HOPS);
+    e.trace.hopsBack = (uint8_t)std::min<size_t>(routeBack.size(), MAX_TRACE_HOPS);
+    e.trace.snrCount = (uint8_t)std::min<size_t>(snr.size(), MAX_TRACE_HOPS + 1);
+    e.trace.snrBackCount = (uint8_t)std::min<size_t>(snrBack.size(), MAX_TRACE_HOPS + 1);
+    for (uint8_t i = 0; i < e.trace.hops; i++) e.trace.route[i] = route[i];
+    for (uint8_t i = 0; i < e.trace.hopsBack; i++) e.trace.routeBack[i] = routeBack[i];
+    for (uint8_t i = 0; i < e.trace.snrCount; i++) e.trace.snr[i] = snr[i];
+    for (uint8_t i = 0; i < e.trace.snrBackCount; i++) e.trace.snrBack[i] = snrBack[i];
+    post(e);
+}
+
+void ClientEventBus::postConnectionState(uint8_t state, uint8_t link) {
+    ClientEvent e;
+    e.type = EVT_CONNECTION_STATE_CHANGED;
+    e.connection.state = state;
+    e.connection.link = link;
+    post(e);
+}
+
+void ClientEventBus::postNotice(NoticeLevel level, const char *text) {
+    ClientEvent e;
+    e.type = EVT_NOTICE;
+    e.notice.level = level;
+    strlcpy(e.notice.text, text ? text : "", sizeof(e.notice.text));
+    post(e);
+}
+
+void ClientEventBus::postUiRequest(UiRequestKind kind, const char *text) {
+    ClientEvent e;
+    e.type = EVT_UI_REQUEST;
+    e.request.kind = kind;
+    strlcpy(e.request.text, text ? text : "", sizeof(e.request.text));
+    post(e);
+}
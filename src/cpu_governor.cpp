@@ -0,0 +1,49 @@
+#include "cpu_governor.h"
+
+CpuGovernor *g_cpuGovernor = nullptr;
+
+void CpuGovernor::begin() {
+    uint32_t now = millis();
+    high = getCpuFrequencyMhz() >= HIGH_MHZ;
+    lastBurstMs = now;
+    lastAccountMs = now;
+    Serial.printf("[CPU] Clock governor: %lu/%lu MHz, now %lu MHz\n", (unsigned long)LOW_MHZ,
+                  (unsigned long)HIGH_MHZ, (unsigned long)getCpuFrequencyMhz());
+}
+
+void CpuGovernor::update(uint32_t nowMs, bool burst) {
+    account(nowMs);
+    if (burst) {
+        lastBurstMs = nowMs;
+        if (!high) setHigh(true, nowMs);
+    } else if (high && nowMs - lastBurstMs >= HOLD_MS) {
+        setHigh(false, nowMs);
+    }
+}
+
+void CpuGovernor::setHigh(bool on, uint32_t nowMs) {
+    if (!setCpuFrequencyMhz(on ? HIGH_MHZ : LOW_MHZ)) {
+        // Stay at this step and try again later
+        Serial.printf("[CPU] Could not switch to %lu MHz\n", (unsigned long)(on ? HIGH_MHZ : LOW_MHZ));
+        lastBurstMs = nowMs;
+        return;
+    }
+    high = on;
+    switchCount++;
+}
+
+void CpuGovernor::account(uint32_t nowMs) {
+    msAt[high ? 1 : 0] += nowMs - lastAccountMs;
+    lastAccountMs = nowMs;
+}
+
+uint8_t CpuGovernor::highPercent() const {
+    uint64_t total = msAt[0] + msAt[1];
+    return total ? (uint8_t)(msAt[1] * 100 / total) : 0;
+}
+
+float CpuGovernor::estimatedMa() const {
+    uint64_t total = msAt[0] + msAt[1];
+    if (!total) return currentMhz() == HIGH_MHZ ? HIGH_MA : LOW_MA;
+    return (LOW_MA * msAt[0] + HIGH_MA * msAt[1]) / total;
+}
@@ -0,0 +1,27 @@
+#include "deadline_timers.h"
+
+void DeadlineTimers::arm(uint8_t id, uint32_t atMs) {
+    if (id >= MAX_TIMERS) return;
+    at[id] = atMs;
+    armedMask |= 1u << id;
+}
+
+void DeadlineTimers::disarm(uint8_t id) {
+    if (id >= MAX_TIMERS) return;
+    armedMask &= ~(1u << id);
+}
+
+bool DeadlineTimers::isDue(uint8_t id, uint32_t nowMs) const {
+    return armed(id) && (int32_t)(nowMs - at[id]) >= 0;
+}
+
+uint32_t DeadlineTimers::msUntilNext(uint32_t nowMs, uint32_t maxWaitMs) const {
+    uint32_t wait = maxWaitMs;
+    for (uint8_t id = 0; id < MAX_TIMERS; id++) {
+        if (!(armedMask & (1u << id))) continue;
+        int32_t left = (int32_t)(at[id] - nowMs);
+        if (left <= 0) return 0;
+        if ((uint32_t)left < wait) wait = (uint32_t)left;
+    }
+    return wait;
+}
@@ -0,0 +1,50 @@
+#include "drain_scheduler.h"
+#include <algorithm>
+
+size_t DrainScheduler::frameBudget(size_t pendingFrames, size_t pendingBytes) {
+    size_t want = (size_t)(rateEma * intervalMs() * 2 / 1000.0f) + 1;
+    want = std::max(want, pendingFrames);
+    if (pendingBytes) want = std::max(want, (size_t)(pendingBytes / frameBytesEma) + 1);
+    // Still behind after a full read: keep doubling until it catches up
+    if (pendingLeft) want = std::max(want, (size_t)budget * 2);
+    if (want < MIN_BUDGET) want = MIN_BUDGET;
+    if (want > MAX_BUDGET) want = MAX_BUDGET;
+    budget = (uint32_t)want;
+    return budget;
+}
+
+void DrainScheduler::record(uint32_t nowMs, size_t frames, size_t bytes, uint32_t elapsedUs, bool leftOver) {
+    pendingLeft = leftOver;
+    if (leftOver) ticksLeftOver++;
+    if (elapsedUs > tickUsMax) tickUsMax = elapsedUs;
+    if (frames) frameBytesEma += ((float)bytes / frames - frameBytesEma) * 0.25f;
+
+    if (!started) {
+        started = true;
+        lastTickMs = nowMs;
+        return;
+    }
+    uint32_t dt = std::max<uint32_t>(nowMs - lastTickMs, 1);
+    lastTickMs = nowMs;
+    // Weighted by the time the sample covers, so frequent signalled reads
+    // and sparse polls average the same way
+    float alpha = (float)dt / (RATE_TAU_MS + dt);
+    rateEma += (frames * 1000.0f / dt - rateEma) * alpha;
+}
+
+uint32_t DrainScheduler::intervalMs() const {
+    if (pendingLeft) return MIN_INTERVAL_MS;
+    if (rateEma < 0.1f) return MAX_INTERVAL_MS;
+    float ms = FRAMES_PER_POLL * 1000.0f / rateEma;
+    if (ms < MIN_INTERVAL_MS) return MIN_INTERVAL_MS;
+    if (ms > MAX_INTERVAL_MS) return MAX_INTERVAL_MS;
+    return (uint32_t)ms;
+}
+
+void DrainScheduler::reset() {
+    rateEma = 0;
+    frameBytesEma = 64;
+    started = false;
+    pendingLeft = false;
+    budget = MIN_BUDGET;
+}
@@ -2,9 +2,14 @@
 #include "meshtastic_client.h"
 #include "ui.h"
 #include "notification.h"
+#include "power_manager.h"
+#include "cpu_governor.h"
 #include "hardware_config.h"
+#include "task_load.h"
+#include "stage_profiler.h"
 #include <M5Cardputer.h>
 #include <Wire.h>
+#include <algorithm>
 
 // Define global variables
 bool deviceConnected = false;
@@ -16,8 +21,73 @@ M5Canvas canvas(&M5.Lcd);
 MeshtasticUI *ui = nullptr;
 MeshtasticClient *client = nullptr;
 NotificationManager *notificationManager = nullptr;
+PowerManager *powerManager = nullptr;
+CpuGovernor *cpuGovernor = nullptr;
+// Input and drawing; the radio side is measured by the client's own tasks
+TaskLoad uiLoad("ui");
+
+// What wakes loop(). The key matrix has no interrupt line, so it is scanned
+// every KEY_SCAN_MS; a full frame (snapshot, input, update, draw) only
+// runs when a key, G0 or the client has something, or UI_TICK_MS has passed.
+EventGroupHandle_t uiEvents = nullptr;
+constexpr EventBits_t UI_EVT_CLIENT = 1 << 0;  // Client event posted or snapshot published
+constexpr EventBits_t UI_EVT_BUTTON = 1 << 1;  // G0 pressed
+constexpr EventBits_t UI_EVT_ALL = UI_EVT_CLIENT | UI_EVT_BUTTON;
+constexpr uint32_t KEY_SCAN_MS = 10;
+constexpr uint32_t UI_TICK_MS = 100;  // Status message expiry, clock, cursor blink
+uint32_t lastFrameMs = 0;
+bool panelAsleep = false;  // Screen timeout reached: backlight and panel off, no UI ticks
+
+void IRAM_ATTR onButtonEdge() {
+    BaseType_t woken = pdFALSE;
+    xEventGroupSetBitsFromISR(uiEvents, UI_EVT_BUTTON, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
 
 namespace {
+// With power save on and the panel off, light-sleeps through an idle key
+// scan interval instead of waiting in it. True if it slept.
+bool lightSleepIdle() {
+    if (!powerManager || !powerManager->enabled() || !panelAsleep || !client) return false;
+    if (xEventGroupGetBits(uiEvents) & UI_EVT_ALL) return false;
+    if (M5Cardputer.Keyboard.isPressed() || digitalRead(0) == LOW) return false;
+
+    // Held across the sleep so the protocol task can't start a pass halfway
+    {
+        StageProfiler::Scope prof(STAGE_LOCK_WAIT);
+        client->lockState();
+    }
+    int uartPort = -1;
+    uint32_t budgetMs = client->lightSleepBudgetMs(millis(), uartPort);
+    uint32_t sleepMs = std::min(budgetMs, PowerManager::KEY_SCAN_SLICE_MS);
+    bool slept = false;
+    if (sleepMs >= PowerManager::MIN_SLEEP_MS) {
+        WakeSource source = powerManager->sleep(sleepMs, uartPort >= 0, uartPort);
+        slept = true;
+        if (source == WAKE_BUTTON) xEventGroupSetBits(uiEvents, UI_EVT_BUTTON);  // Its ISR was parked
+        // Slept up to a protocol deadline, or the radio has sent something
+        if (sleepMs == budgetMs || source == WAKE_UART) client->onLightSleepWake();
+    }
+    client->unlockState();
+    return slept;
+}
+
+// The panel follows the screen timeout, and the UI goes headless with it
+void updatePanelPower() {
+    bool off = client && client->isScreenTimedOut();
+    if (off == panelAsleep) return;
+    panelAsleep = off;
+    if (off) {
+        if (ui) ui->setHeadless(true);
+        M5.Display.sleep();
+    } else {
+        M5.Display.wakeup();
+        M5.Display.setBrightness(client->getBrightness());
+        if (ui) ui->setHeadless(false);
+    }
+    Serial.printf("[Power] Display %s\n", off ? "off" : "on");
+}
+
 bool probeI2CDeviceOnPins(int sda, int scl, uint8_t addr) {
     Wire.begin(sda, scl);
     delay(2);
@@ -83,6 +153,9 @@ void setup() {
     M5.Lcd.setFont(&fonts::DejaVu12);
     Serial.println("Step 5: Display OK");
 
+    uiEvents = xEventGroupCreate();
+    if (uiEvents) attachInterrupt(digitalPinToInterrupt(0), onButtonEdge, FALLING);
+
     Serial.println("Step 6: Creating UI, client and notification manager...");
     try {
         ui = new MeshtasticUI();
@@ -91,12 +164,24 @@ void setup() {
         notificationManager = new NotificationManager();
         g_notificationManager = notificationManager; // Set global notification manager pointer
         notificationManager->begin();
+        powerManager = new PowerManager();
+        g_powerManager = powerManager;
+        powerManager->begin();
+        cpuGovernor = new CpuGovernor();
+        g_cpuGovernor = cpuGovernor;
+        cpuGovernor->begin();
         if (ui) {
             Serial.println("Step 7: UI created successfully");
             if (client) {
                 client->begin();
                 ui->setClient(client);
+                notificationManager->listen(client->eventBus());
+                client->eventBus().setWake(uiEvents, UI_EVT_CLIENT);
+                ui->beginFrame();
                 ui->draw();
+                ui->endFrame();
+                // From here on loop() runs on core 0; this task only does input and drawing
+                client->startProtocolTask();
                 // Startup behavior is mode-driven via UI; avoid unconditional scans here
             } else {
                 Serial.println("Step 7: Failed to create client");
@@ -113,67 +198,94 @@ void setup() {
 void loop() {
     static int loopCount = 0;
 
-    M5Cardputer.update();
+    bool sharedWithRadio = client && !client->isProtocolTaskRunning();
+    bool typing = ui && ui->isModalActive() && ui->modalType == 5;
+    EventBits_t woke = 0;
+    if (uiEvents && !sharedWithRadio) {
+        // Sleep until the client or G0 signals, or the next key scan / UI tick
+        uint32_t waitMs = KEY_SCAN_MS;
+        if (!panelAsleep) {
+            uint32_t sinceFrame = millis() - lastFrameMs;
+            waitMs = sinceFrame >= UI_TICK_MS ? 0 : std::min(KEY_SCAN_MS, UI_TICK_MS - sinceFrame);
+        }
+        if (typing && !panelAsleep) waitMs = std::min<uint32_t>(waitMs, 1);  // Fullscreen typing: keep the old 1 ms cadence
+        // Back from light sleep: take whatever woke it, then scan the keys
+        if (lightSleepIdle()) waitMs = 0;
+        woke = xEventGroupWaitBits(uiEvents, UI_EVT_ALL, pdTRUE, pdFALSE, pdMS_TO_TICKS(waitMs));
+    } else {
+        delay(1);  // Sharing the loop with the radio: keep input responsive
+    }
+
+    {
+        StageProfiler::Scope prof(STAGE_INPUT_SCAN);
+        M5Cardputer.update();
+    }
+
+    // Nothing to do this scan: skip the lock and the frame
+    bool keys = M5Cardputer.Keyboard.isChange() || M5Cardputer.Keyboard.isPressed();
+    bool button = M5.BtnA.isPressed() || M5.BtnA.wasReleased() || digitalRead(0) == LOW;
+    // Nothing to tick for with the panel off
+    bool tick = !panelAsleep && millis() - lastFrameMs >= UI_TICK_MS;
+
+    // Full clock for input, typing and modal repaints while the panel is on,
+    // and for the client's bursts either way
+    if (cpuGovernor) {
+        bool uiBurst = !panelAsleep && (keys || button || typing || (woke && ui && ui->isModalActive()));
+        cpuGovernor->update(millis(), uiBurst || (client && client->wantsFullSpeed()));
+    }
+    if (!woke && !keys && !button && !tick && !typing && !sharedWithRadio) return;
+
+    // Headless: only input gets a frame while the panel is off. Client
+    // events are still drained, so the bus can't overwrite a popup or a
+    // dialog request before wake; the frame that brings the panel back
+    // shows them and repaints from the current snapshot. Ringtones still play.
+    if (panelAsleep && !keys && !button && !sharedWithRadio) {
+        updatePanelPower();  // The client can bring the screen back, e.g. for a PIN
+        if (panelAsleep) {
+            if (ui) ui->drainEventsHeadless();
+            if (notificationManager) notificationManager->service();
+            if (powerManager && woke) powerManager->noteProcessed();  // The radio input has been handled
+            return;
+        }
+    }
+    lastFrameMs = millis();
+
+    // The frame takes no client lock: the UI draws from the snapshot it pins
+    // in beginFrame(), and input goes to the protocol task as commands
+    uiLoad.begin();
+    if (ui) ui->beginFrame();
 
     // Process UI input first to minimize input latency
     if (ui) {
+        StageProfiler::Scope prof(STAGE_HANDLE_INPUT);
         ui->handleInput();
     }
+    // Input that woke the screen: the panel is back before update() draws
+    updatePanelPower();
 
-    if (client) {
+    // Only if the protocol task could not be started; the pass runs under
+    // the state lock as it would on the task
+    if (client && !client->isProtocolTaskRunning()) {
+        client->lockState();
         client->loop();
-
-        // CRITICAL: Process PIN input in main loop (non-blocking pairing support)
-        if (client->waitingForPinInput && g_ui) {
-            // Check if user has entered and submitted PIN (modal is closed when PIN is submitted)
-            if (g_ui->blePinInput.length() > 0) {
-                String enteredPin = g_ui->blePinInput;
-                if (enteredPin.length() >= 4 && enteredPin.length() <= 6) {
-                    uint32_t pin = enteredPin.toInt();
-                    Serial.printf("[Main] User entered PIN: %06lu, injecting...\n", (unsigned long)pin);
-                    
-                    // Inject PIN using stored connection handle
-                    if (client->bleClient && client->bleClient->isConnected()) {
-                        NimBLEDevice::injectPassKey(client->bleClient->getConnInfo(), pin);
-                        Serial.println("[Main] ✓ PIN injected successfully");
-                        
-                        // Clear PIN and waiting flag
-                        g_ui->blePinInput = "";
-                        client->waitingForPinInput = false;
-                        
-                        // Show feedback message
-                        g_ui->showMessage("Authenticating...");
-                    } else {
-                        Serial.println("[Main] ✗ PIN injection failed - BLE client not connected");
-                        g_ui->blePinInput = "";
-                        client->waitingForPinInput = false;
-                        g_ui->showError("Connection lost");
-                    }
-                } else {
-                    Serial.printf("[Main] Invalid PIN length: %d\n", enteredPin.length());
-                    g_ui->blePinInput = "";
-                    client->waitingForPinInput = false;
-                    g_ui->showError("Invalid PIN");
-                }
-            }
-        }
+        client->publishSnapshot();
+        client->unlockState();
     }
 
     if (ui) {
+        StageProfiler::Scope prof(STAGE_UI_UPDATE);
         ui->update();      // Update UI state
     }
 
+    if (ui) ui->endFrame();
+    uiLoad.end();
+
+    if (notificationManager) notificationManager->service();
+    if (powerManager && (woke || keys || button)) powerManager->noteProcessed();
+    updatePanelPower();
+
     // if (loopCount % 500 == 0) {
     //     Serial.printf("Loop %d - Memory: %d bytes free\n", loopCount, ESP.getFreeHeap());
     // }
-
-    // Optimize loop delay for maximum keyboard responsiveness
-    if (ui && ui->isModalActive() && ui->modalType == 5) {
-        delay(0);  // No delay during fullscreen typing for instant response
-    } else if (client && client->isDeviceConnected()) {
-        delay(1);  // Minimal 1ms delay when connected - maximizes input responsiveness  
-    } else {
-        delay(3);  // Reduced delay when not connected for snappy UI
-    }
     loopCount++;
 }
@@ -1,20 +1,14 @@
 #include "meshtastic_client.h"
 #include "meshtastic_protocol.h"
-#include "ui.h"
-#include "notification.h"
+#include "stage_profiler.h"
 #include <algorithm>
 #include <memory>
 #include <esp_system.h>
-#include <driver/uart.h>
-#include <driver/gpio.h>
-#include <esp_rom_gpio.h>
+#include <WiFi.h>
 // FreeRTOS for background async connect
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
-// Use ESP-IDF UART driver instead of Arduino Serial1
-#define USE_ESP_IDF_UART 1
-
 // Macro for timestamped logging
 #define LOG_PRINTF(fmt, ...) Serial.printf("%s " fmt, getTimeStamp().c_str(), ##__VA_ARGS__)
 #define LOG_PRINTLN(str) Serial.printf("%s %s\n", getTimeStamp().c_str(), str)
@@ -117,7 +111,6 @@ bool isValidNodeForStorage(const ParsedNodeInfo &parsed) {
 namespace {
 constexpr uint32_t UART_PROBE_INTERVAL_MS = 3000;
 constexpr size_t MAX_HISTORY_MESSAGES = 80;
-constexpr size_t MAX_UART_FRAME = 512;
 
 // Format node IDs with fixed width (used for UI-friendly short/long IDs)
 String formatNodeIdHex(uint32_t nodeId, uint8_t width) {
@@ -135,6 +128,32 @@ String generateNodeDisplayName(uint32_t nodeId) {
 String formatMeshCoreNodeId(uint32_t nodeId) {
     return formatNodeIdHex(nodeId, 8);
 }
+
+// Scoped hold on one of the client's recursive mutexes (link or state); a
+// null mutex always "holds"
+struct LinkLock {
+    SemaphoreHandle_t mutex;
+    bool held;
+    LinkLock(SemaphoreHandle_t m, TickType_t wait)
+        : mutex(m), held(!m || xSemaphoreTakeRecursive(m, wait) == pdTRUE) {}
+    ~LinkLock() {
+        if (mutex && held) xSemaphoreGiveRecursive(mutex);
+    }
+};
+
+// Lets go of the state lock for a stretch of blocking link work, so the light
+// sleep path isn't held off by it, and takes it back on scope exit. Only the outermost hold
+// actually frees it; does nothing if this task doesn't hold it.
+struct StateUnlock {
+    SemaphoreHandle_t mutex;
+    bool released;
+    explicit StateUnlock(SemaphoreHandle_t m)
+        : mutex(m), released(m && xSemaphoreGetMutexHolder(m) == xTaskGetCurrentTaskHandle() &&
+                             xSemaphoreGiveRecursive(m) == pdTRUE) {}
+    ~StateUnlock() {
+        if (released) xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+    }
+};
 }
 
 // Non-capturing notify callback for NimBLE notifications
@@ -151,6 +170,7 @@ fromNumNotifyCB(NimBLERemoteCharacteristic *characteristic, uint8_t *data, size_
 
 static void meshCoreNotifyCB(NimBLERemoteCharacteristic *characteristic, uint8_t *data, size_t length, bool isNotify) {
     if (!g_client) return;
+    // NimBLE host task: copy and return; the main loop decodes
     g_client->onMeshCoreNotify(data, length);
 }
 
@@ -180,17 +200,12 @@ void MeshtasticBLEClientCallback::onConfirmPasskey(NimBLEConnInfo& connInfo, uin
     if (!meshtasticClient) return;
     
     // Show PIN to user and ask for confirmation
-    if (g_ui) {
-        char msg[64];
-        snprintf(msg, sizeof(msg), "Confirm PIN: %06lu", (unsigned long)pin);
-        g_ui->showMessage(msg);
-        // Immediately confirm to avoid blocking callback/UI; user still sees the PIN overlay
-        Serial.printf("[BLE Auth] Auto-confirming PIN: %06lu\n", (unsigned long)pin);
-        NimBLEDevice::injectConfirmPasskey(connInfo, true);
-    } else {
-        // No UI - auto-confirm
-        NimBLEDevice::injectConfirmPasskey(connInfo, true);
-    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Confirm PIN: %06lu", (unsigned long)pin);
+    meshtasticClient->eventBus().postNotice(NOTICE_INFO, msg);
+    // Immediately confirm to avoid blocking callback/UI; user still sees the PIN overlay
+    Serial.printf("[BLE Auth] Auto-confirming PIN: %06lu\n", (unsigned long)pin);
+    NimBLEDevice::injectConfirmPasskey(connInfo, true);
 }
 
 void MeshtasticBLEClientCallback::onAuthenticationComplete(NimBLEConnInfo& connInfo) {
@@ -213,31 +228,11 @@ void MeshtasticBLEClientCallback::onPassKeyEntry(NimBLEConnInfo& connInfo) {
     meshtasticClient->waitingForPinInput = true;
     meshtasticClient->pinInputStartTime = millis();
     
-    // Force close any existing modal and immediately open PIN input
-    if (g_ui) {
-        // Force close any active modal first
-        if (g_ui->isModalActive()) {
-            Serial.println("[BLE Auth] Closing existing modal to show PIN input");
-            g_ui->closeModal();
-        }
-        
-        // Clear any pending connection states that might interfere
-        g_ui->bleConnectionPending = false;
-        
-        // Open fullscreen PIN input modal immediately
-        g_ui->blePinInput = "";
-        g_ui->inputBuffer = "";
-        g_ui->modalType = 5;  // Fullscreen input
-        g_ui->modalContext = 13;  // MODAL_BLE_PIN_INPUT
-        g_ui->modalTitle = "Enter BLE PIN";
-        g_ui->modalInfo = "Enter 6-digit PIN shown on Meshtastic device";
-        g_ui->pendingInputAction = g_ui->INPUT_ENTER_BLE_PIN;  // Set action for Enter key
-        g_ui->needModalRedraw = true;
-        g_ui->needsRedraw = true;
-        g_ui->needImmediateModalRedraw = true;  // Urgent display needed
-        
-        Serial.println("[BLE Auth] Fullscreen PIN input modal setup completed");
-    }
+    // The UI replaces whatever dialog is open with the PIN input on its next
+    // frame (this runs on the NimBLE host task)
+    meshtasticClient->eventBus().postUiRequest(UI_REQ_BLE_PIN_ENTRY);
+    // The PIN has to be seen: bring the display back if it timed out
+    meshtasticClient->wakeScreen();
     
     Serial.printf("[BLE Auth] PIN input ready (conn_handle=%d), waiting for user...\n", 
                   meshtasticClient->pendingPairingConnHandle);
@@ -280,6 +275,7 @@ void MeshtasticBLEScanCallbacks::onResult(const NimBLEAdvertisedDevice *advertis
                       deviceAddress.c_str(), rssi, deviceName.c_str(), hasMeshSvc ? "YES" : "NO", hasMeshCoreSvc ? "YES" : "NO");
 
         // Check if device already exists in our list
+        LinkLock lock(meshtasticClient->scanListMutex, portMAX_DELAY);
         bool exists = false;
         int existingIndex = -1;
         for (size_t i = 0; i < meshtasticClient->scannedDeviceAddresses.size(); i++) {
@@ -326,27 +322,11 @@ void MeshtasticBLEScanCallbacks::onResult(const NimBLEAdvertisedDevice *advertis
                           displayName.c_str(), deviceAddress.c_str(),
                           hasMeshSvc ? "YES" : "no");
             
-            // Trigger UI refresh to show new device immediately
-            if (g_ui) {
-                g_ui->needModalRedraw = true;
-            }
+            // The next snapshot carries it to the UI
+            meshtasticClient->onScanListChanged();
             
-            // Auto-connect logic: DISABLED during manual scanning
-            // Users should manually select devices from the scan list
-            // Auto-connect only happens on boot via UI.cpp autoconnect logic
-            if (false && g_ui && g_ui->bleAutoConnectOnScan && 
-                deviceAddress == g_ui->bleAutoConnectAddress) {
-                Serial.printf("[BLE-Scan] ⚡ Auto-connect target found: %s (%s)\n", 
-                              displayName.c_str(), deviceAddress.c_str());
-                // Set flag for main loop to initiate connection
-                meshtasticClient->bleAutoConnectRequested = true;
-                meshtasticClient->bleAutoConnectTargetAddress = deviceAddress;
-                // Clear UI auto-connect flag first to avoid re-triggering
-                g_ui->bleAutoConnectOnScan = false;
-                // Stop the scan
-                meshtasticClient->stopBleScan();
-                Serial.println("[BLE-Scan] Scan stopped for auto-connection");
-            }
+            // No auto-connect during manual scanning: users pick from the
+            // scan list, auto-connect only happens on boot via the UI
         } else {
             // Device already in list - just update RSSI info if needed
             // Serial.printf("[BLE-Scan] Device already known: %s (rssi=%d)\n", deviceAddress.c_str(), rssi);
@@ -405,6 +385,11 @@ MeshtasticClient::~MeshtasticClient() {
 }
 
 void MeshtasticClient::begin() {
+    // Wake sources for loop(); the UART driver signals input before any link is opened
+    protoEvents = xEventGroupCreate();
+    if (protoEvents) uartTransport.setRxSignal(protoEvents, PROTO_EVT_RX);
+    scanListMutex = xSemaphoreCreateRecursiveMutex();
+
     // Ensure default UART pins (G1/G2) are configured before enabling text mode
     // Load persisted settings (overrides defaults)
     loadSettings();
@@ -419,18 +404,28 @@ void MeshtasticClient::begin() {
     
     lastDrainMillis = millis();
     lastUARTProbeMillis = millis();
+
+    startTxQueue();
     
     // Initialize node tracking
     autoNodeDiscoveryRequested = false;
     fastDeviceInfoReceived = false;
     
     // Note: Startup configuration will be printed by UI after user preferences are set
+    // The UI's first frame reads the loaded settings from this
+    publishSnapshot();
     Serial.println("[DEBUG] MeshtasticClient::begin() completed");
 }
 
 void MeshtasticClient::loop() {
-    uint32_t now = millis();
-    
+    StageProfiler::Scope prof(STAGE_CLIENT_LOOP);
+    // Taken before the pass: anything signalled while it runs wakes the next one
+    EventBits_t wake = protoEvents ? xEventGroupClearBits(protoEvents, PROTO_EVT_ALL) : PROTO_EVT_ALL;
+    runPass(millis(), wake);
+    armTimers(millis());
+}
+
+void MeshtasticClient::runPass(uint32_t now, EventBits_t wake) {
     // Periodic status logging
     static uint32_t lastStatusLog = 0;
     if (now - lastStatusLog > 60000) { 
@@ -443,18 +438,38 @@ void MeshtasticClient::loop() {
     // Check for screen timeout
     updateScreenTimeout();
 
+    // Link service through the keepalive below, pairing and probing included
+    StageProfiler::Scope probe(STAGE_PROBE);
+
+    // Let the active link notice TX completion and other housekeeping
+    {
+        LinkLock lock(linkMutex, 0);
+        if (lock.held && transport) transport->service();
+    }
+
+    // Apply send results reported by the background TX task
+    processTxResults();
+    sweepPendingAcks(now);
+
     // Check for trace route timeout
     if (traceRouteWaitingForResponse && (now - traceRouteTimeoutStart > TRACE_ROUTE_TIMEOUT_MS)) {
         traceRouteWaitingForResponse = false;
         LOG_PRINTF("[TraceRoute] Timeout after %d seconds - no response received\n", 
                      TRACE_ROUTE_TIMEOUT_MS / 1000);
-        if (g_ui) g_ui->showError("Trace route timeout");
+        events.postNotice(NOTICE_ERROR, "Trace route timeout");
     }
 
-    // Check for connection timeout
-    if (connectionState == CONN_WAITING_CONFIG) {
+    // Re-send want_config if the config stream stalled
+    if (configSessionActive()) {
         handleConfigTimeout();
     }
+    if (isUARTSpeedUpgradeActive()) serviceUARTUpgrade(now);
+
+    // Node DB download progress: one repaint per interval rather than per NodeInfo
+    if (isNodeSyncInProgress() && now - lastNodeSyncRedraw >= NODE_SYNC_REDRAW_MS) {
+        lastNodeSyncRedraw = now;
+        events.postNodeListChanged();
+    }
 
     // If a UI scan was started with a fixed duration, detect自然结束并打印一次汇总
     if (bleUiScanActive && activeScan && !activeScan->isScanning()) {
@@ -470,15 +485,13 @@ void MeshtasticClient::loop() {
             bleAutoConnectRequested = false;
             String targetAddr = bleAutoConnectTargetAddress;
             bleAutoConnectTargetAddress = "";
-            // Use existing address-based connect which will perform a short scan then connect
-            bool connected = connectToDeviceByAddress(targetAddr);
+            // Connect on the async connect task: a BLE connect blocks for
+            // seconds and this pass holds the state lock
+            bool connected = beginAsyncConnectByAddress(targetAddr);
             if (!connected) {
-                Serial.println("[BLE] Auto-connect by address failed; will rely on UI flow if available");
-                if (g_ui) {
-                    // Fall back to previous behavior: hint UI about the target
-                    g_ui->preferredBluetoothAddress = targetAddr;
-                    g_ui->preferredBluetoothDevice = targetAddr;
-                }
+                Serial.println("[BLE] Could not start auto-connect; will rely on UI flow if available");
+                // Fall back to previous behavior: hint UI about the target
+                events.postUiRequest(UI_REQ_BLE_TARGET, targetAddr.c_str());
             }
     }
     
@@ -491,10 +504,8 @@ void MeshtasticClient::loop() {
                 LOG_PRINTLN("[BLE Auth] PIN input timeout - canceling pairing");
                 needsSubscriptionRetry = false;
                 waitingForPinInput = false;
-                if (g_ui) {
-                    g_ui->closeModal();
-                    g_ui->displayError("PIN input timeout");
-                }
+                events.postUiRequest(UI_REQ_CLOSE_MODAL);
+                events.postNotice(NOTICE_ERROR, "PIN input timeout");
                 disconnectBLE();
             }
             return; // Skip retry logic while waiting for PIN
@@ -508,13 +519,25 @@ void MeshtasticClient::loop() {
             LOG_PRINTF("[BLE] Background subscription retry %d/%d...\n", subscriptionRetryCount, maxRetries);
             
             try {
-                bool subOk = fromNumChar->subscribe(true, fromNumNotifyCB);
-                if (subOk) {
+                // A GATT write, and the pairing exchange behind it on an
+                // unbonded radio: done with the state lock let go
+                NimBLERemoteCharacteristic *chr = fromNumChar;
+                bool subOk;
+                {
+                    StateUnlock unlock(stateMutex);
+                    LinkLock lock(linkMutex, portMAX_DELAY);
+                    // disconnectBLE() takes the link lock, so the characteristic
+                    // is still alive if it is still the one we saw
+                    subOk = fromNumChar == chr && chr->subscribe(true, fromNumNotifyCB);
+                }
+                if (fromNumChar != chr || !needsSubscriptionRetry) {
+                    LOG_PRINTLN("[BLE] Link changed during subscription retry; result ignored");
+                } else if (subOk) {
                     LOG_PRINTLN("[BLE] ✓ Background subscription successful!");
                     needsSubscriptionRetry = false;
                     pairingComplete = true;
                     pairingSuccessful = true;
-                    if (g_ui) g_ui->showSuccess("Pairing successful");
+                    events.postNotice(NOTICE_SUCCESS, "Pairing successful");
                     
                     // Now that subscription is successful, request config if not in text mode
                     if (!textMessageMode && connectionState == CONN_CONNECTED) {
@@ -526,7 +549,7 @@ void MeshtasticClient::loop() {
                     if (subscriptionRetryCount >= maxRetries) {
                         LOG_PRINTLN("[BLE] ✗ Max retries reached, giving up");
                         needsSubscriptionRetry = false;
-                        if (g_ui) g_ui->displayError("Pairing failed");
+                        events.postNotice(NOTICE_ERROR, "Pairing failed");
                         disconnectBLE();
                     } else {
                         subscriptionRetryStartTime = millis();
@@ -536,7 +559,7 @@ void MeshtasticClient::loop() {
                 LOG_PRINTF("[BLE] ✗ Retry %d threw exception: %s\n", subscriptionRetryCount, e.what());
                 if (subscriptionRetryCount >= maxRetries) {
                     needsSubscriptionRetry = false;
-                    if (g_ui) g_ui->displayError("Pairing failed");
+                    events.postNotice(NOTICE_ERROR, "Pairing failed");
                     disconnectBLE();
                 } else {
                     subscriptionRetryStartTime = millis();
@@ -569,63 +592,105 @@ void MeshtasticClient::loop() {
                 Serial.println("[UART] Grove attempt still pending; will retry automatically");
             }
         }
-    } else if (uartAvailable && !textMessageMode && connectionType != "BLE") {
-        // Check if initial discovery should be marked as complete
-        if (!initialDiscoveryComplete && discoveryStartTime > 0) {
-            uint32_t timeSinceLastNode = now - lastNodeAddedTime;
-            uint32_t totalDiscoveryTime = now - discoveryStartTime;
-            
-            // More aggressive completion criteria - either 3 seconds idle OR 20 seconds total
-            if (timeSinceLastNode > 3000 || totalDiscoveryTime > 20000) {
-                initialDiscoveryComplete = true;
-                LOGF("[Discovery] Initial discovery complete - found %d nodes in %d seconds\n", 
-                     nodeList.size(), totalDiscoveryTime / 1000);
-            }
-        }
-        
-        // Use very aggressive probe frequency during initial discovery
-        uint32_t probeInterval;
-        if (connectionState == CONN_WAITING_CONFIG || connectionState == CONN_REQUESTING_CONFIG) {
-            // Do not spam while waiting for config; check every 5 seconds only
-            probeInterval = 5000;    // 5s light poll (no TX in probeUARTOnce under this state)
-        } else if (!initialDiscoveryComplete) {
-            probeInterval = 100;   // 100ms during initial discovery - very aggressive
-        } else {
-            probeInterval = 30000; // 30 seconds after discovery complete - maintenance only
-        }
-        
-        if (now - lastUARTProbeMillis >= probeInterval) {
-            probeUARTOnce();
-            lastUARTProbeMillis = now;
-        }
     }
 
-    // If a BLE notification arrived, prioritize a quick drain immediately
-    if (fromNumNotifyPending) {
-        drainIncoming(true, true);
-        fromNumNotifyPending = false;
-        lastDrainMillis = now; // avoid double-drain in this cycle
-    }
+    serviceTcpLink(now);
+    serviceKeepalive(now);
+    probe.end();
 
-    // Continuous data reading - optimized for maximum keyboard responsiveness  
-    uint32_t drainInterval = 250;  // Slower base rate for better keyboard response
-    if (g_ui && g_ui->isModalActive()) {
-        drainInterval = 500; // Much slower during any modal activity to prioritize input
-    } else if (isDeviceConnected()) {
-        drainInterval = 300; // Slower when connected to prioritize keyboard input
-    }
-    if (now - lastDrainMillis >= drainInterval) {
+    // Read the link when it said it has input, when the last read left some
+    // behind, or when its poll timer comes round
+    bool signalled = (wake & PROTO_EVT_RX) != 0;
+    if (signalled || rxBacklog || protoTimers.isDue(PT_LINK_POLL, now)) {
+        rxBacklog = false;
+        StageProfiler::Scope prof(STAGE_DRAIN);
         if (textMessageMode) {
             processTextMessage();
         } else {
-            drainIncoming(false, false);  // Process thoroughly but less frequently
+            drainLink(now);
         }
         lastDrainMillis = now;
     }
 }
 
+void MeshtasticClient::armTimers(uint32_t now) {
+    // runPass() stops short while a PIN is being entered; only its timeout
+    // needs checking until then
+    if (needsSubscriptionRetry && waitingForPinInput) {
+        protoTimers.clear();
+        protoTimers.arm(PT_HOUSEKEEPING, now + HOUSEKEEPING_MS);
+        return;
+    }
+    // Work that was due but skipped this pass is retried on the housekeeping
+    // cadence rather than by spinning
+    auto notPast = [now](uint32_t at) { return (int32_t)(at - now) > 0 ? at : now + HOUSEKEEPING_MS; };
+
+    bool linkBusy = false;  // TxTask holds the link
+    bool txBusy = false;
+    {
+        LinkLock lock(linkMutex, 0);
+        linkBusy = !lock.held;
+        txBusy = lock.held && transport && transport->txBusy();
+    }
+    if (txBusy) {
+        protoTimers.arm(PT_TX_DONE, now + TX_DONE_POLL_MS);
+    } else {
+        protoTimers.disarm(PT_TX_DONE);
+    }
+
+    // Links that signal input only get the occasional safety poll. Text mode
+    // reads the UART without making it the active transport.
+    ITransport *link = transport;
+    if (!link && textMessageMode && uartTransport.isOpen()) link = &uartTransport;
+    // Input left behind is read again after a short gap, which lets queued
+    // commands and a snapshot through; silent links are polled at the rate
+    // drainSched settles on for the traffic.
+    if (rxBacklog) {
+        protoTimers.arm(PT_LINK_POLL, now + (linkBusy ? TX_DONE_POLL_MS : DrainScheduler::MIN_INTERVAL_MS));
+    } else if (link) {
+        uint32_t interval = link->signalsRx() ? LINK_SAFETY_POLL_MS : drainSched.intervalMs();
+        protoTimers.arm(PT_LINK_POLL, notPast(lastDrainMillis + interval));
+    } else {
+        protoTimers.disarm(PT_LINK_POLL);
+    }
+
+    if (pendingAcks.size()) {
+        protoTimers.arm(PT_ACK_SWEEP, notPast(lastAckSweepTime + ACK_SWEEP_INTERVAL_MS));
+    } else {
+        protoTimers.disarm(PT_ACK_SWEEP);
+    }
+
+    if (traceRouteWaitingForResponse) {
+        protoTimers.arm(PT_TRACE_ROUTE, notPast(traceRouteTimeoutStart + TRACE_ROUTE_TIMEOUT_MS + 1));
+    } else {
+        protoTimers.disarm(PT_TRACE_ROUTE);
+    }
+
+    // State machines that check their own timeouts on every pass
+    bool busy = configSessionActive() || isUARTSpeedUpgradeActive() || isNodeSyncInProgress() || uartDeferredConfig ||
+                bleUiScanActive || needsSubscriptionRetry || tcpStage != TCP_STAGE_IDLE ||
+                (groveConnectionManuallyTriggered && !uartAvailable);
+    if (busy) {
+        protoTimers.arm(PT_HOUSEKEEPING, now + HOUSEKEEPING_MS);
+    } else {
+        protoTimers.disarm(PT_HOUSEKEEPING);
+    }
+
+    // Per-minute traffic counters, the heartbeat and the link-silent check
+    uint32_t keepalive = minuteStartTime + 60000;
+    if (isConnected && !textMessageMode && deviceType == DEVICE_MESHTASTIC) {
+        uint32_t lastTx = std::max(lastLinkTxTime(), lastHeartbeatTime);
+        uint32_t heartbeat = lastTx + HEARTBEAT_INTERVAL_MS;
+        if ((int32_t)(heartbeat - keepalive) < 0) keepalive = heartbeat;
+        if (linkAlive && (int32_t)(lastLinkRxTime() + LINK_SILENT_MS - keepalive) < 0) {
+            keepalive = lastLinkRxTime() + LINK_SILENT_MS;
+        }
+    }
+    protoTimers.arm(PT_KEEPALIVE, notPast(keepalive));
+}
+
 bool MeshtasticClient::scanForDevicesOnly() {
-    if (g_ui) g_ui->showMessage("Scanning for BLE devices...");
+    events.postNotice(NOTICE_INFO, "Scanning for BLE devices...");
 
     NimBLEDevice::init("");
     NimBLEScan *scan = NimBLEDevice::getScan();
@@ -650,7 +715,7 @@ bool MeshtasticClient::scanForDevicesOnly() {
     scan->setScanCallbacks(nullptr, false);
 
     if (cb->foundDevices.empty()) {
-        if (g_ui) g_ui->showMessage("No Meshtastic devices found");
+        events.postNotice(NOTICE_INFO, "No Meshtastic devices found");
         return false;
     }
     return true;
@@ -698,12 +763,11 @@ bool MeshtasticClient::scanForDevices(bool connect, const String &targetName) {
 
     if (!found) {
         // Try UART fallback
-        if (g_ui) g_ui->showMessage("Trying UART connection...");
+        events.postNotice(NOTICE_INFO, "Trying UART connection...");
         if (tryInitUART()) {
             connectedDeviceName = "UART Device";
             isConnected = true;
             uartAvailable = true;
-            connectionType = "UART";
             // Suppress automatic UI success here to avoid showing messages on boot.
             // UI feedback for connections is shown when user explicitly initiates a connection.
             return true;
@@ -746,15 +810,11 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
             LOG_PRINTF("[BLE] ========== Connecting via name: %s ==========\n", addressOrName.c_str());
             
             // Check cached scan results first
-            bool foundInCache = false;
-            for (size_t i = 0; i < scannedDeviceNames.size(); i++) {
-                if (scannedDeviceNames[i] == addressOrName) {
-                    devAddress = scannedDeviceAddresses[i];
-                    devName = addressOrName;
-                    foundInCache = true;
-                    LOG_PRINTF("[BLE] Found in cache: %s -> %s\n", devName.c_str(), devAddress.c_str());
-                    break;
-                }
+            devAddress = scannedAddressFor(addressOrName);
+            bool foundInCache = !devAddress.isEmpty();
+            if (foundInCache) {
+                devName = addressOrName;
+                LOG_PRINTF("[BLE] Found in cache: %s -> %s\n", devName.c_str(), devAddress.c_str());
             }
             
             if (!foundInCache) {
@@ -779,23 +839,17 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
                 scan->setInterval(80);
                 scan->setWindow(60);
                 
-                scannedDeviceNames.clear();
-                scannedDeviceAddresses.clear();
-                scannedDevicePaired.clear();
-                scannedDeviceAddrTypes.clear();
+                clearScanList();
                 bleUiScanActive = true;
                 
                 scan->start(6000, false);
                 bleUiScanActive = false;
                 
                 // Find target device
-                for (size_t i = 0; i < scannedDeviceNames.size(); i++) {
-                    if (scannedDeviceNames[i] == addressOrName) {
-                        devAddress = scannedDeviceAddresses[i];
-                        devName = addressOrName;
-                        LOG_PRINTF("[BLE] Found in scan: %s -> %s\n", devName.c_str(), devAddress.c_str());
-                        break;
-                    }
+                devAddress = scannedAddressFor(addressOrName);
+                if (!devAddress.isEmpty()) {
+                    devName = addressOrName;
+                    LOG_PRINTF("[BLE] Found in scan: %s -> %s\n", devName.c_str(), devAddress.c_str());
                 }
                 
                 scan->clearResults();
@@ -812,7 +866,7 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
     }
     
     connectedDeviceName = devName;
-    if (g_ui) g_ui->showMessage("Connecting: " + devName);
+    events.postNotice(NOTICE_INFO, "Connecting: " + devName);
     
     // Configure security - CRITICAL for pairing
     NimBLEDevice::setSecurityAuth(true, true, true);
@@ -841,13 +895,8 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
     } else {
         // Determine preferred address type from scan cache if available
         int preferredType = -1; // -1 = unknown, 0 = PUBLIC, 1 = RANDOM
-        for (size_t i = 0; i < scannedDeviceAddresses.size(); ++i) {
-            if (scannedDeviceAddresses[i] == devAddress) {
-                uint8_t t = (i < scannedDeviceAddrTypes.size()) ? scannedDeviceAddrTypes[i] : BLE_ADDR_PUBLIC;
-                preferredType = (t == BLE_ADDR_RANDOM) ? 1 : 0;
-                break;
-            }
-        }
+        int scannedType = scannedAddrTypeFor(devAddress);
+        if (scannedType >= 0) preferredType = (scannedType == BLE_ADDR_RANDOM) ? 1 : 0;
 
         auto tryConnectWithType = [&](uint8_t type) {
             NimBLEAddress addr(devAddress.c_str(), type);
@@ -880,7 +929,7 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
     
     if (!connected) {
         LOG_PRINTLN("[BLE] ✗ Connection failed");
-        if (g_ui) g_ui->displayError("Connection failed");
+        events.postNotice(NOTICE_ERROR, "Connection failed");
         disconnectBLE();
         return false;
     }
@@ -900,10 +949,7 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
         delay(10);
     }
     
-    if (g_ui) {
-        g_ui->closeModal();
-        delay(10);
-    }
+    events.postUiRequest(UI_REQ_CLOSE_MODAL);
     
     // Initialize pairing state (will be set by callbacks if pairing is needed)
     pairingInProgress = false;
@@ -927,7 +973,7 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
         if (!fromRadioChar || !toRadioChar || !fromNumChar) {
             LOG_PRINTF("[BLE] ✗ Missing characteristics: from=%p to=%p num=%p\n",
                       fromRadioChar, toRadioChar, fromNumChar);
-            if (g_ui) g_ui->displayError("Device not compatible");
+            events.postNotice(NOTICE_ERROR, "Device not compatible");
             disconnectBLE();
             return false;
         }
@@ -944,13 +990,13 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
             if (!meshCoreRxChar || !meshCoreTxChar) {
                 LOG_PRINTF("[BLE] ✗ Missing MeshCore characteristics: rx=%p tx=%p\n",
                           meshCoreRxChar, meshCoreTxChar);
-                if (g_ui) g_ui->displayError("Device not compatible");
+                events.postNotice(NOTICE_ERROR, "Device not compatible");
                 disconnectBLE();
                 return false;
             }
         } else {
             LOG_PRINTLN("[BLE] ✗ No supported service found");
-            if (g_ui) g_ui->displayError("Not a Meshtastic/MeshCore device");
+            events.postNotice(NOTICE_ERROR, "Not a Meshtastic/MeshCore device");
             disconnectBLE();
             return false;
         }
@@ -985,11 +1031,7 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
     waitingForPinInput = false;
     
     // Close any scanning UI modals before subscription attempt
-    if (g_ui && g_ui->modalType > 0) {
-        LOG_PRINTLN("[BLE] Closing scan modal before subscription to allow PIN dialog");
-        g_ui->closeModal();
-        delay(100);
-    }
+    events.postUiRequest(UI_REQ_CLOSE_MODAL);
     
     bool subNumOk = false;
     try {
@@ -1031,7 +1073,13 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
     // Save connection info
     isConnected = true;
     deviceConnected = true;
-    connectionType = "BLE";
+    if (deviceType == DEVICE_MESHCORE) {
+        meshCoreTransport.attach(bleClient, meshCoreRxChar);
+        selectTransport(&meshCoreTransport);
+    } else {
+        bleTransport.attach(bleClient, toRadioChar, fromRadioChar);
+        selectTransport(&bleTransport);
+    }
 
     // Ensure we are not in TextMsg mode when using BLE (protobuf required for BLE)
     // If left in TextMsg, sendProtobuf() and sendMessage() will refuse to send packets.
@@ -1049,8 +1097,8 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
         // but we mark it unavailable for transport.
         // Actually, let's be cleaner:
         uartAvailable = false;
-        // We keep uartInited true so we can reuse the driver if needed, 
-        // but connectionType will be BLE.
+        // We keep uartInited true so we can reuse the driver if needed,
+        // but the active transport is BLE.
     }
     
     Preferences prefs;
@@ -1061,7 +1109,7 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
     }
     
     LOG_PRINTLN("[BLE] ========== Connection successful ==========");
-    if (g_ui) g_ui->showSuccess("Connected to " + devName);
+    events.postNotice(NOTICE_SUCCESS, "Connected to " + devName);
     
     updateConnectionState(CONN_CONNECTED);
     
@@ -1073,14 +1121,11 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
         // Only request config if subscription was successful
         if (deviceType == DEVICE_MESHCORE) {
              // Send App Start and Device Query
-             std::vector<uint8_t> appStart = MeshCore::buildAppStartFrame("Cardputer");
-             meshCoreRxChar->writeValue(appStart.data(), appStart.size(), false);
+             sendMeshCoreFrame(MeshCore::buildAppStartFrame("Cardputer"));
              delay(100);
-             std::vector<uint8_t> devQuery = MeshCore::buildDeviceQueryFrame();
-             meshCoreRxChar->writeValue(devQuery.data(), devQuery.size(), false);
+             sendMeshCoreFrame(MeshCore::buildDeviceQueryFrame());
              delay(100);
-             std::vector<uint8_t> getContacts = MeshCore::buildGetContactsFrame();
-             meshCoreRxChar->writeValue(getContacts.data(), getContacts.size(), false);
+             sendMeshCoreFrame(MeshCore::buildGetContactsFrame());
              updateConnectionState(CONN_READY); // Assume ready for MeshCore
         } else {
              requestConfig();
@@ -1094,6 +1139,9 @@ bool MeshtasticClient::connectToBLE(const NimBLEAdvertisedDevice *device, const
 }
 
 void MeshtasticClient::disconnectBLE() {
+    // Frame reads and subscribe retries use the characteristics with only the
+    // link lock held; wait for them before tearing the client down
+    LinkLock lock(linkMutex, portMAX_DELAY);
     if (fromNumChar) {
         fromNumChar->unsubscribe();
         fromNumChar = nullptr;
@@ -1113,20 +1161,20 @@ void MeshtasticClient::disconnectBLE() {
         bleClient = nullptr;
     }
 
+    bleTransport.detach();
+    meshCoreTransport.detach();
+    if (isBleLink()) selectTransport(nullptr);
+
     isConnected = false;
     deviceConnected = false;
-    connectionType = "None";
 }
 
 void MeshtasticClient::disconnectFromDevice() {
     disconnectBLE();
 
-    if (uartAvailable && uartPort) {
-        uartPort->end();
-        uartPort = nullptr;
-        uartAvailable = false;
-        uartInited = false;
-    }
+    if (uartAvailable) closeUART();
+    if (isTcpConnecting() || tcpTransport.isOpen()) stopTcpConnection();
+    selectTransport(nullptr);
 
     // Reset connection state and auto-discovery flag
     updateConnectionState(CONN_DISCONNECTED);
@@ -1135,7 +1183,7 @@ void MeshtasticClient::disconnectFromDevice() {
     lastPeriodicNodeRequest = 0;
     fastDeviceInfoReceived = false;
     
-    if (g_ui) g_ui->showMessage("Disconnected");
+    events.postNotice(NOTICE_INFO, "Disconnected");
 }
 
 // ================== Async Connect (FreeRTOS task) ==================
@@ -1179,16 +1227,44 @@ bool MeshtasticClient::beginAsyncConnectByAddress(const String &deviceAddress) {
     return true;
 }
 
+bool MeshtasticClient::beginAsyncResolve(const String &host) {
+    if (host.length() == 0) return false;
+    if (asyncConnectInProgress) {
+        Serial.println("[TCP] Async connect task busy; lookup deferred");
+        return false;
+    }
+    asyncConnectInProgress = true;
+    tcpResolve.store(TCP_RESOLVE_PENDING, std::memory_order_relaxed);
+    auto *params = new AsyncConnectParams{this, String(""), String(""), host};
+    BaseType_t ok = xTaskCreatePinnedToCore(
+        AsyncConnectTask, "ble_conn", 8192, params, 1, &asyncConnectTaskHandle, 1 /* APP CPU */);
+    if (ok != pdPASS) {
+        Serial.println("[TCP] Failed to start async connect task");
+        asyncConnectInProgress = false;
+        delete params;
+        return false;
+    }
+    Serial.printf("[TCP] Looking up %s\n", host.c_str());
+    return true;
+}
+
 void MeshtasticClient::AsyncConnectTask(void* param) {
     auto *p = static_cast<AsyncConnectParams*>(param);
     MeshtasticClient* self = p->self;
     String name = p->name;
     String addr = p->address;
+    String host = p->host;
     delete p; // free params early
 
     bool ok = false;
-    // Perform blocking BLE connect in background task
-    if (addr.length() > 0) {
+    if (host.length() > 0) {
+        // DNS/mDNS lookup for the TCP link; only the result is handed back
+        char ip[sizeof(self->tcpResolvedIp)];
+        ok = TcpTransport::resolveHost(host.c_str(), ip, sizeof(ip));
+        if (ok) memcpy(self->tcpResolvedIp, ip, sizeof(ip));
+        self->tcpResolve.store(ok ? TCP_RESOLVE_DONE : TCP_RESOLVE_FAILED, std::memory_order_release);
+    } else if (addr.length() > 0) {
+        // Perform blocking BLE connect in background task
         ok = self->connectToBLE(nullptr, addr);
     } else {
         ok = self->connectToBLE(nullptr, name);
@@ -1197,109 +1273,109 @@ void MeshtasticClient::AsyncConnectTask(void* param) {
     // Mark task done
     self->asyncConnectInProgress = false;
     self->asyncConnectTaskHandle = nullptr;
+    // A new link has config to request and notifies to drain
+    self->wakeProtocolTask(PROTO_EVT_LINK);
     vTaskDelete(nullptr);
 }
 
-bool MeshtasticClient::sendProtobuf(const uint8_t *data, size_t length, bool preferResponse) {
-    LOG_PRINTF("[ProtocolTx] sendProtobuf called: uartAvailable=%d, isConnected=%d, connType=%s, messageMode=%d, textMessageMode=%d, length=%d\n",
-               uartAvailable ? 1 : 0, isConnected ? 1 : 0, connectionType.c_str(), messageMode, textMessageMode ? 1 : 0, length);
+void MeshtasticClient::selectTransport(ITransport *t) {
+    LinkLock lock(linkMutex, portMAX_DELAY);
+    if (transport == t) return;
+    LOG_PRINTF("[Link] Transport %s -> %s\n", transport ? transport->name() : "None", t ? t->name() : "None");
+    transport = t;
+    radioQueue = RadioQueueState();
+}
 
-    if (!data || length == 0 || length > MAX_PACKET_SIZE) return false;
+uint32_t MeshtasticClient::linkRxBytes() const {
+    return uartTransport.stats().rxBytes + bleTransport.stats().rxBytes + meshCoreTransport.stats().rxBytes +
+           tcpTransport.stats().rxBytes;
+}
 
-    // Prefer the active transport explicitly selected by connectionType
-    bool preferBLE = (isConnected && connectionType == "BLE" && toRadioChar != nullptr);
-    bool preferUART = (connectionType == "UART" && uartAvailable);
+uint32_t MeshtasticClient::linkTxBytes() const {
+    return uartTransport.stats().txBytes + bleTransport.stats().txBytes + meshCoreTransport.stats().txBytes +
+           tcpTransport.stats().txBytes;
+}
 
-    // For BLE connections, also check mode
-    if (preferBLE) {
-        if (textMessageMode) {
-            LOG_PRINTLN("[ProtocolTx] ERROR: Attempted to send protobuf while in TextMsg mode (BLE) - blocking!");
-            return false;
-        }
-        // Debug: print UUIDs and truncated hex for outgoing BLE payload
-        if (toRadioChar) {
-            // Store strings to avoid dangling pointers from temporary objects
-            std::string svcStr = meshService ? meshService->getUUID().toString() : std::string("(no-svc)");
-            std::string toStr = toRadioChar->getUUID().toString();
-            // LOG_PRINTF("[BLE-TX] Service=%s ToRadio=%s len=%u (withResponse=1)\n", svcStr.c_str(), toStr.c_str(), (unsigned)length);
-        } 
-        // BLE TX: use write-with-response for reliability on ToRadio characteristic
-        bool success = toRadioChar->writeValue(data, length, /*withResponse=*/true);
-        // LOG_PRINTF("[BLE-TX] write(withResponse) result=%d\n", success ? 1 : 0);
-        if (!success) {
-            // Serial.println("[BLE] Write (with response) failed - attempting to secure connection (may prompt PIN)...");
-            // Retry after securing connection (lazy pairing trigger)
-            if (bleClient && bleClient->secureConnection()) {
-                // Serial.println("[BLE] Secure connection established, retrying write (with response)...");
-                success = toRadioChar->writeValue(data, length, /*withResponse=*/true);
-                LOG_PRINTF("[BLE-TX] retry write(withResponse) result=%d\n", success ? 1 : 0);
-            } else {
-                Serial.println("[BLE] Secure connection failed or unavailable");
-            }
-        }
-        return success;
-    }
+bool MeshtasticClient::sendProtobuf(const uint8_t *data, size_t length) {
+    if (!data || length == 0 || length > MAX_PACKET_SIZE) return false;
+    LinkLock lock(linkMutex, portMAX_DELAY);
+    memcpy(txFrame + STREAM_HEADER_SIZE, data, length);
+    return sendFrame(txFrame, length);
+}
 
-    // Fallback to UART when BLE is not the active transport
-    if (uartAvailable) {
-        if (messageMode == MODE_TEXTMSG) {
-            LOG_PRINTLN("[ProtocolTx] ERROR: Attempted to send protobuf while in TextMsg mode (UART) - blocking!");
-            return false;
-        }
-        LOG_PRINTLN("[ProtocolTx] Sending via UART protobuf...");
-        dumpHex("[UART-TX]", data, length);
-        bool result = sendProtobufUART(data, length, false);
-        LOG_PRINTF("[ProtocolTx] UART send result: %d\n", result ? 1 : 0);
-        return result;
+bool MeshtasticClient::sendFrame(uint8_t *frame, size_t payloadLen) {
+    if (!frame || payloadLen == 0 || payloadLen > MAX_PACKET_SIZE) return false;
+    LinkLock lock(linkMutex, portMAX_DELAY);
+    if (!transport) return false;
+    if (textMessageMode || messageMode == MODE_TEXTMSG) {
+        LOG_PRINTF("[ProtocolTx] ERROR: Attempted to send protobuf while in TextMsg mode (%s) - blocking!\n",
+                   transport->name());
+        return false;
     }
-
-    // If we get here and still have BLE available (but connectionType not set yet), try BLE as last resort
-    if (isConnected && toRadioChar) {
-        if (textMessageMode) return false;
-        // Log UUIDs and truncated hex even in fallback BLE path for visibility
-        std::string svcStr = meshService ? meshService->getUUID().toString() : std::string("(no-svc)");
-        std::string toStr = toRadioChar->getUUID().toString();
-        bool ok = toRadioChar->writeValue(data, length, preferResponse);
-        LOG_PRINTF("[BLE-TX] (fallback) write(withResponse=%d) result=%d\n", preferResponse ? 1 : 0, ok ? 1 : 0);
-        return ok;
+    if (transportIs(TRANSPORT_UART)) {
+        // Respect Bluetooth-only preference: do not transmit on UART
+        if (userConnectionPreference == PREFER_BLUETOOTH || !uartAvailable) return false;
+        dumpHex("[UART-TX]", frame + STREAM_HEADER_SIZE, payloadLen);
     }
-
-    return false;
+    return transport->send(frame, payloadLen);
 }
 
-std::vector<uint8_t> MeshtasticClient::receiveProtobuf() {
-    std::vector<uint8_t> out;
+bool MeshtasticClient::sendMeshCoreFrame(const std::vector<uint8_t> &frame) {
+    if (frame.empty() || frame.size() > MAX_PACKET_SIZE) return false;
+    LinkLock lock(linkMutex, portMAX_DELAY);
+    if (!transportIs(TRANSPORT_BLE_MESHCORE)) return false;
+    memcpy(txFrame + STREAM_HEADER_SIZE, frame.data(), frame.size());
+    return transport->send(txFrame, frame.size());
+}
 
-    // Prefer BLE if it's the active connection
-    if (isConnected && connectionType == "BLE" && fromRadioChar) {
-        for (int retry = 0; retry < 3; retry++) {
-            std::string value = fromRadioChar->readValue();
-            if (!value.empty()) {
-                out.assign(reinterpret_cast<const uint8_t*>(value.data()),
-                           reinterpret_cast<const uint8_t*>(value.data()) + value.size());
-                break;
-            }
-            delay(10);
+size_t MeshtasticClient::receiveFrames(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) {
+    if (!transport) return 0;
+    // Respect Bluetooth-only preference: do not consume UART
+    if (transportIs(TRANSPORT_UART) && (userConnectionPreference == PREFER_BLUETOOTH || !uartAvailable)) return 0;
+    size_t n = 0;
+    bool busy = false;
+    std::vector<std::string> lines;
+    {
+        // On BLE every frame is a GATT read, so the link is read with only
+        // the link lock held; the caller applies the frames under the state lock
+        StateUnlock unlock(stateMutex);
+        // TxTask owns the link while it transmits; just try again on the next drain
+        LinkLock lock(linkMutex, 0);
+        if (!lock.held) {
+            busy = true;
+        } else if (transport) {
+            n = transport->poll(out, maxFrames);
+            // Console text the framer split out from between frames
+            std::string line;
+            while (transport->nextLogLine(line)) lines.push_back(line);
         }
-        return out;
     }
-
-    // Otherwise, use UART if available
-    if (uartAvailable) {
-        return receiveProtobufUART();
+    if (busy) {
+        rxBacklog = true;
+        return 0;
     }
-
-    return out;
+    // Whatever is left over produces no new signal, so come straight back for it
+    if (n >= maxFrames) rxBacklog = true;
+    for (const std::string &line : lines) {
+        radioLog.add(millis(), RadioLog::levelFromConsole(line.c_str()), nullptr, line.c_str());
+    }
+    return n;
 }
 
 void MeshtasticClient::onFromNumNotify(uint8_t *data, size_t length) {
     (void)data;
     (void)length;
-    // Mark that data is pending; the main loop will drain shortly.
-    fromNumNotifyPending = true;
+    // Only says data is waiting; the protocol task reads FromRadio until it's empty
+    fromNumNotifies.fetch_add(1, std::memory_order_relaxed);
+    wakeProtocolTask(PROTO_EVT_RX);
 }
 
 void MeshtasticClient::onMeshCoreNotify(uint8_t *data, size_t length) {
+    // Drops are counted by the transport and logged from drainIncoming, not here
+    if (meshCoreTransport.pushNotify(data, length)) wakeProtocolTask(PROTO_EVT_RX);
+}
+
+void MeshtasticClient::onMeshCoreFrame(uint8_t *data, size_t length) {
     if (length == 0) return;
     
     // Parse MeshCore frame
@@ -1330,28 +1406,23 @@ void MeshtasticClient::onMeshCoreNotify(uint8_t *data, size_t length) {
                     connectedDeviceName = nameStr;
                     LOG_PRINTF("[MeshCore] Self Info: Name=%s, ID=0x%08X\n", nameStr.c_str(), myNodeId);
                     
-                    // Update UI if needed
-                    if (g_ui) g_ui->forceRedraw();
+                    events.postNodeListChanged();
                 }
             }
             break;
         }
         case MeshCore::RESP_CODE_SENT:
             LOG_PRINTLN("[MeshCore] Message Sent");
-            if (g_ui) g_ui->showSuccess("Message Sent");
+            events.postNotice(NOTICE_SUCCESS, "Message Sent");
             break;
         case MeshCore::PUSH_CODE_MSG_WAITING:
             LOG_PRINTLN("[MeshCore] Message Waiting");
             // Send CMD_SYNC_NEXT_MESSAGE (10)
-            if (meshCoreRxChar) {
-                std::vector<uint8_t> frame;
-                frame.push_back(MeshCore::CMD_SYNC_NEXT_MESSAGE);
-                meshCoreRxChar->writeValue(frame.data(), frame.size(), false);
-            }
+            sendMeshCoreFrame(std::vector<uint8_t>{MeshCore::CMD_SYNC_NEXT_MESSAGE});
             break;
         case MeshCore::PUSH_CODE_STATUS_RESPONSE:
             LOG_PRINTLN("[MeshCore] Status Response (Ping Reply)");
-            if (g_ui) g_ui->showSuccess("Ping Reply Received");
+            events.postNotice(NOTICE_SUCCESS, "Ping Reply Received");
             break;
         case MeshCore::PUSH_CODE_ADVERT:
              LOG_PRINTLN("[MeshCore] Advert Received");
@@ -1404,6 +1475,7 @@ void MeshtasticClient::onMeshCoreNotify(uint8_t *data, size_t length) {
                          pubKeyHex += hex;
                      }
                      nodeList[idx].macAddress = pubKeyHex;
+                     nodesVersion++;
                  }
                  LOG_PRINTF("[MeshCore] Contact added: %s (0x%08X)\n", nodeInfo.user.longName.c_str(), nodeInfo.nodeId);
              } else {
@@ -1505,15 +1577,9 @@ void MeshtasticClient::handleMeshCoreContactMessage(uint8_t code, const uint8_t
         msg.snr = static_cast<int8_t>(data[1]) / 4.0f;
     }
 
-    addMessageToHistory(msg);
+    addMessageToHistory(msg, MSG_EVENT_ALERT);
     LOG_PRINTF("[MeshCore] Contact msg from %s (0x%08X) len=%d direct=%d\n",
                msg.fromName.c_str(), msg.fromNodeId, text.length(), msg.isDirect);
-    if (g_notificationManager) {
-        g_notificationManager->playNotification(false); // direct message ringtone
-    }
-    if (g_ui) {
-        g_ui->openNewMessagePopup(msg.fromName, text, msg.snr);
-    }
 }
 
 void MeshtasticClient::handleMeshCoreChannelMessage(uint8_t code, const uint8_t *data, size_t length) {
@@ -1585,37 +1651,27 @@ void MeshtasticClient::handleMeshCoreChannelMessage(uint8_t code, const uint8_t
         msg.snr = static_cast<int8_t>(data[1]) / 4.0f;
     }
 
-    addMessageToHistory(msg);
+    addMessageToHistory(msg, MSG_EVENT_ALERT | MSG_EVENT_BROADCAST);
     LOG_PRINTF("[MeshCore] Channel msg (ch=%d) len=%d\n", channelIdx, text.length());
-    if (g_notificationManager) {
-        g_notificationManager->playNotification(true); // broadcast/channel ringtone
-    }
-    if (g_ui) {
-        int previewLen = std::min<int>(text.length(), 30);
-        g_ui->openNewMessagePopup(channelName, text.substring(0, previewLen), msg.snr);
-    }
 }
 
 bool MeshtasticClient::sendMeshCoreText(const String& text, const std::vector<uint8_t>& pubKeyPrefix) {
-    if (!meshCoreRxChar || !isConnected) return false;
-    std::vector<uint8_t> frame = MeshCore::buildTextMsgFrame(text, pubKeyPrefix);
-    bool ok = meshCoreRxChar->writeValue(frame.data(), frame.size(), false);
+    if (!isConnected) return false;
+    bool ok = sendMeshCoreFrame(MeshCore::buildTextMsgFrame(text, pubKeyPrefix));
     LOG_PRINTF("[MeshCore] Sent Text Message (%s)\n", ok ? "ok" : "fail");
     return ok;
 }
 
 bool MeshtasticClient::sendMeshCoreBroadcast(const String& text, uint8_t channelIdx) {
-    if (!meshCoreRxChar || !isConnected) return false;
-    std::vector<uint8_t> frame = MeshCore::buildChannelTextMsgFrame(text, channelIdx);
-    bool ok = meshCoreRxChar->writeValue(frame.data(), frame.size(), false);
+    if (!isConnected) return false;
+    bool ok = sendMeshCoreFrame(MeshCore::buildChannelTextMsgFrame(text, channelIdx));
     LOG_PRINTF("[MeshCore] Sent Broadcast Message (%s)\n", ok ? "ok" : "fail");
     return ok;
 }
 
 void MeshtasticClient::sendMeshCorePing(const std::vector<uint8_t>& pubKey) {
-    if (!meshCoreRxChar || !isConnected) return;
-    std::vector<uint8_t> frame = MeshCore::buildStatusReqFrame(pubKey);
-    meshCoreRxChar->writeValue(frame.data(), frame.size(), false);
+    if (!isConnected) return;
+    sendMeshCoreFrame(MeshCore::buildStatusReqFrame(pubKey));
     LOG_PRINTLN("[MeshCore] Sent Ping (Status Req)");
 }
 
@@ -1641,19 +1697,71 @@ void MeshtasticClient::sendMeshCorePing(uint32_t nodeId) {
 }
 
 void MeshtasticClient::sendMeshCoreGetContacts() {
-    if (!meshCoreRxChar || !isConnected) return;
-    std::vector<uint8_t> frame = MeshCore::buildGetContactsFrame(0);
-    meshCoreRxChar->writeValue(frame.data(), frame.size(), false);
+    if (!isConnected) return;
+    sendMeshCoreFrame(MeshCore::buildGetContactsFrame(0));
     LOG_PRINTLN("[MeshCore] Sent Get Contacts Request");
 }
 
-void MeshtasticClient::updateMessageStatus(uint32_t packetId, MessageStatus newStatus) {
-    for (auto &msg : messageHistory) {
-        if (msg.packetId == packetId) {
-            msg.status = newStatus;
-            break;
+void MeshtasticClient::updateMessageStatus(uint32_t packetId, MessageStatus newStatus, uint8_t failReason) {
+    uint32_t now = millis();
+    PendingAck ack;
+    if (newStatus == MSG_STATUS_SENT || newStatus == MSG_STATUS_SENDING) {
+        // Still waiting for the mesh to acknowledge: keep tracking
+        const PendingAck *e = pendingAcks.find(packetId);
+        if (!e) return;
+        ack = *e;
+    } else {
+        if (!pendingAcks.take(packetId, ack)) return; // Not ours, or already resolved
+        if (newStatus == MSG_STATUS_DELIVERED && ack.sent) {
+            pendingAcks.recordRtt(ack.toNodeId, now - ack.sentMs, now);
+            const AckRttStats *rtt = pendingAcks.rttFor(ack.toNodeId);
+            LOG_PRINTF("[Ack] id=%u from 0x%08X rtt=%lu ms (avg=%lu ms, n=%lu)\n", packetId, ack.toNodeId,
+                       (unsigned long)(now - ack.sentMs), (unsigned long)rtt->avgMs, (unsigned long)rtt->samples);
         }
     }
+
+    MeshtasticMessage *msg = findMessageBySeq(ack.historySeq);
+    if (!msg) {
+        LOG_PRINTF("[Ack] id=%u resolved (%d) after its message left history\n", packetId, (int)newStatus);
+        return;
+    }
+    // A late transport confirmation must not overwrite a final state
+    if (newStatus == MSG_STATUS_SENT && msg->status != MSG_STATUS_SENDING) return;
+    msg->status = newStatus;
+    if (newStatus == MSG_STATUS_FAILED) msg->failReason = failReason;
+    messagesVersion++;
+    events.postAckUpdated(packetId, newStatus, msg->failReason);
+}
+
+MeshtasticMessage *MeshtasticClient::findMessageBySeq(uint32_t historySeq) {
+    // Sequence numbers are consecutive and history only drops from the front,
+    // so the entry's index is its distance from the oldest one.
+    if (messageHistory.empty() || historySeq < messageHistory.front().historySeq) return nullptr;
+    size_t idx = historySeq - messageHistory.front().historySeq;
+    if (idx >= messageHistory.size() || messageHistory[idx].historySeq != historySeq) return nullptr;
+    return &messageHistory[idx];
+}
+
+void MeshtasticClient::sweepPendingAcks(uint32_t now) {
+    if (now - lastAckSweepTime < ACK_SWEEP_INTERVAL_MS) return;
+    lastAckSweepTime = now;
+    if (pendingAcks.size() == 0) return;
+
+    PendingAck expired[8];
+    size_t n = pendingAcks.sweep(now, ACK_TIMEOUT_MS, expired, 8);
+    for (size_t i = 0; i < n; ++i) {
+        pendingAcks.recordTimeout(expired[i].toNodeId, now);
+        LOG_PRINTF("[Ack] id=%u to 0x%08X timed out after %lu s\n", expired[i].packetId, expired[i].toNodeId,
+                   (unsigned long)(ACK_TIMEOUT_MS / 1000));
+        MeshtasticMessage *msg = findMessageBySeq(expired[i].historySeq);
+        if (!msg || msg->status == MSG_STATUS_DELIVERED) continue;
+        // Heard relayed but never acked end to end: it did leave, so don't call it failed
+        if (expired[i].relayed) continue;
+        msg->status = MSG_STATUS_FAILED;
+        msg->failReason = ROUTING_ERROR_TIMEOUT;
+        messagesVersion++;
+        events.postAckUpdated(msg->packetId, MSG_STATUS_FAILED, ROUTING_ERROR_TIMEOUT);
+    }
 }
 
 MeshtasticNode *MeshtasticClient::getNodeById(uint32_t nodeId) {
@@ -1675,21 +1783,39 @@ const MeshtasticNode *MeshtasticClient::findNode(uint32_t nodeId) const {
     return nullptr;
 }
 
-void MeshtasticClient::upsertNode(const ParsedNodeInfo &parsed) {
+// FNV-1a over the raw name bytes; equal hashes mean sanitizing would give the same names
+static uint32_t nodeNameHash(const String &shortName, const String &longName) {
+    uint32_t h = 2166136261u;
+    auto mix = [&h](const String &str) {
+        const char *p = str.c_str();
+        for (size_t i = 0; i < str.length(); ++i) {
+            h ^= (uint8_t)p[i];
+            h *= 16777619u;
+        }
+        h ^= 0x1F; // Field separator, so ("ab","c") and ("a","bc") differ
+        h *= 16777619u;
+    };
+    mix(shortName);
+    mix(longName);
+    return h;
+}
+
+uint8_t MeshtasticClient::upsertNode(const ParsedNodeInfo &parsed) {
     // Use strict validation before adding any node
     if (!isValidNodeForStorage(parsed)) {
-        return;
+        return NODE_CHANGE_NONE;
     }
 
     // Serial.printf("[NodeInfo] upsertNode called for 0x%08X\n", parsed.nodeId);
 
     MeshtasticNode *existing = getNodeById(parsed.nodeId);
-    // Pre-sanitize names once
-    String parsedShort = sanitizeDisplayName(parsed.user.shortName);
-    String parsedLong  = sanitizeDisplayName(parsed.user.longName);
+    uint32_t nameHash = nodeNameHash(parsed.user.shortName, parsed.user.longName);
     if (!existing) {
+        String parsedShort = sanitizeDisplayName(parsed.user.shortName);
+        String parsedLong  = sanitizeDisplayName(parsed.user.longName);
         MeshtasticNode node;
         node.nodeId = parsed.nodeId;
+        node.nameHash = nameHash;
         
         // Prefer full (long) name when available; otherwise use short; else fallback
         if (isValidDisplayName(parsedLong)) {
@@ -1725,42 +1851,79 @@ void MeshtasticClient::upsertNode(const ParsedNodeInfo &parsed) {
         node.batteryLevel = parsed.batteryLevel;
         nodeList.push_back(node);
         nodeIndexById[parsed.nodeId] = nodeList.size() - 1;
+        nodesVersion++;
         
         // Update discovery tracking
         lastNodeAddedTime = millis();
         
         LOG_PRINTF("[NodeInfo] Added node 0x%08x (%s), total=%d\n", parsed.nodeId, node.shortName.c_str(), nodeList.size());
-        if (g_ui) g_ui->forceRedraw();
-        return;
+        // During the background node download, loop() repaints at a fixed cadence instead
+        if (!isNodeSyncInProgress()) events.postNodeChanged(parsed.nodeId, NODE_CHANGE_ADDED);
+        return NODE_CHANGE_ADDED;
     }
 
     // Serial.printf("[NodeInfo] Updating existing node 0x%08X\n", parsed.nodeId);
-    
-    // Update names with sanitized, prefer long > short > fallback
-    if (isValidDisplayName(parsedLong)) {
-        existing->longName = parsedLong;
-    } else if (isValidDisplayName(parsedShort) && (existing->longName.isEmpty() || !isValidDisplayName(existing->longName))) {
-        existing->longName = parsedShort;
+    uint8_t changed = NODE_CHANGE_NONE;
+
+    // Names are only re-derived when the raw bytes differ from last time
+    if (existing->nameHash != nameHash) {
+        existing->nameHash = nameHash;
+        String parsedShort = sanitizeDisplayName(parsed.user.shortName);
+        String parsedLong  = sanitizeDisplayName(parsed.user.longName);
+        String longName = existing->longName;
+        String shortName = existing->shortName;
+
+        // Update names with sanitized, prefer long > short > fallback
+        if (isValidDisplayName(parsedLong)) {
+            longName = parsedLong;
+        } else if (isValidDisplayName(parsedShort) && (longName.isEmpty() || !isValidDisplayName(longName))) {
+            longName = parsedShort;
+        }
+
+        if (isValidDisplayName(parsedShort)) {
+            shortName = parsedShort;
+        } else if (isValidDisplayName(parsedLong)) {
+            shortName = parsedLong;
+        } else if (shortName.isEmpty() || !isValidDisplayName(shortName)) {
+            shortName = generateNodeDisplayName(parsed.nodeId);
+        }
+
+        if (longName != existing->longName || shortName != existing->shortName) {
+            existing->longName = longName;
+            existing->shortName = shortName;
+            changed |= NODE_CHANGE_NAME;
+        }
     }
 
-    if (isValidDisplayName(parsedShort)) {
-        existing->shortName = parsedShort;
-    } else if (isValidDisplayName(parsedLong)) {
-        existing->shortName = parsedLong;
-    } else if (existing->shortName.isEmpty() || !isValidDisplayName(existing->shortName)) {
-        existing->shortName = generateNodeDisplayName(parsed.nodeId);
+    if (existing->snr != parsed.snr || existing->hopLimit != (uint8_t)parsed.hopsAway) {
+        existing->snr = parsed.snr;
+        existing->hopLimit = (uint8_t)parsed.hopsAway;
+        changed |= NODE_CHANGE_SIGNAL;
     }
-    
-    existing->snr = parsed.snr;
-    existing->lastHeard = parsed.lastHeard;
-    existing->channel = parsed.channel;
-    if (parsed.hasPosition) {
+    if (existing->lastHeard != parsed.lastHeard) {
+        existing->lastHeard = parsed.lastHeard;
+        changed |= NODE_CHANGE_LAST_HEARD;
+    }
+    if (existing->channel != parsed.channel) {
+        existing->channel = parsed.channel;
+        changed |= NODE_CHANGE_CHANNEL;
+    }
+    if (parsed.hasPosition && (existing->latitude != parsed.latitude || existing->longitude != parsed.longitude ||
+                               existing->altitude != parsed.altitude)) {
         existing->latitude = parsed.latitude;
         existing->longitude = parsed.longitude;
         existing->altitude = parsed.altitude;
+        changed |= NODE_CHANGE_POSITION;
     }
-    if (parsed.batteryLevel >= 0) existing->batteryLevel = parsed.batteryLevel;
-    existing->hopLimit = parsed.hopsAway;
+    if (parsed.batteryLevel >= 0 && existing->batteryLevel != parsed.batteryLevel) {
+        existing->batteryLevel = parsed.batteryLevel;
+        changed |= NODE_CHANGE_BATTERY;
+    }
+
+    if (changed) nodesVersion++;
+    // Only the affected row (and the detail pane if it is selected) is repainted
+    if (changed && !isNodeSyncInProgress()) events.postNodeChanged(parsed.nodeId, changed);
+    return changed;
 }
 
 void MeshtasticClient::updateChannel(const ParsedChannelInfo &parsed) {
@@ -1828,30 +1991,16 @@ void MeshtasticClient::requestConfig() {
         return;
     }
 
-    // Avoid duplicate immediate requests while one is in flight
-    if (connectionState == CONN_REQUESTING_CONFIG) {
-        // If we just requested, skip duplicate calls
-        if (configRequestTime > 0 && (millis() - configRequestTime) < 500) {
-            Serial.println("[Config] Duplicate request suppressed (already requesting)");
-            return;
-        }
+    // One session at a time: a request already in flight will either complete or be retried on stall
+    if (configSessionActive()) {
+        Serial.printf("[Config] Session nonce=0x%08X already in progress - not restarting\n", configSession.nonce);
+        return;
     }
 
     updateConnectionState(CONN_REQUESTING_CONFIG);
 
-    // Following proper Meshtastic startup sequence:
-    // Use standard configuration request (0) for device info
-    // Node database will be populated through normal packet flow
-    configRequestId = 0;  // Standard config request per Python library pattern
-    
-    Serial.printf("[Config] Standard startup: using want_config_id=%d for device configuration\n", configRequestId);
-    auto packet = buildWantConfig(configRequestId);
-    Serial.printf("[Config] Packet size: %d bytes\n", packet.size());
-    
-    bool sent = sendProtobuf(packet.data(), packet.size());
-    Serial.printf("[Config] sendProtobuf() returned %d\n", sent);
-
-    if (sent) {
+    // Config, channels and MyInfo first; the node DB follows once the UI is usable
+    if (startConfigSession(CFG_PHASE_CONFIG)) {
         updateConnectionState(CONN_WAITING_CONFIG);
         configRequestTime = millis();
         configReceived = false;
@@ -1861,6 +2010,115 @@ void MeshtasticClient::requestConfig() {
     }
 }
 
+bool MeshtasticClient::startConfigSession(ConfigPhase phase) {
+    configSession = ConfigSession();
+    configSession.phase = phase;
+    configSession.startTime = millis();
+    configSession.rxBytesAtStart = linkRxBytes();
+    configSession.txBytesAtStart = linkTxBytes();
+    return sendConfigRequest();
+}
+
+bool MeshtasticClient::sendConfigRequest() {
+    // Full dumps get a fresh random nonce per attempt so a config_complete_id
+    // left over from an earlier dump can't be mistaken for the end of this one
+    uint32_t nonce;
+    if (configSession.phase == CFG_PHASE_CONFIG) {
+        nonce = WANT_CONFIG_ONLY_CONFIG;
+    } else if (configSession.phase == CFG_PHASE_NODES) {
+        nonce = WANT_CONFIG_ONLY_NODES;
+    } else {
+        do {
+            nonce = esp_random();
+        } while (nonce == 0 || nonce == configSession.nonce || nonce == WANT_CONFIG_ONLY_CONFIG ||
+                 nonce == WANT_CONFIG_ONLY_NODES);
+    }
+
+    configSession.nonce = nonce;
+    configSession.attempts++;
+    configSession.lastRequestTime = millis();
+    configSession.state = CFG_REQUESTED;
+    configRequestId = nonce;
+
+    auto packet = buildWantConfig(nonce);
+    bool sent = sendProtobuf(packet.data(), packet.size());
+    Serial.printf("[Config] want_config_id=0x%08X (attempt %u/%u) sent=%d\n", nonce, configSession.attempts,
+                  CONFIG_MAX_ATTEMPTS, sent ? 1 : 0);
+    if (!sent) configSession.state = CFG_FAILED;
+    return sent;
+}
+
+void MeshtasticClient::onConfigFrame(const ParsedFromRadio &parsed) {
+    configSession.frames++;
+    configSession.nodes += parsed.nodes.size();
+    configSession.lastProgressTime = millis();
+    if (configSession.state == CFG_REQUESTED) configSession.state = CFG_STREAMING;
+
+    if (!parsed.sawConfigComplete) return;
+    if (parsed.configCompleteId != configSession.nonce) {
+        Serial.printf("[Config] Ignoring config_complete_id=0x%08X (waiting for 0x%08X)\n", parsed.configCompleteId,
+                      configSession.nonce);
+        return;
+    }
+    finishConfigSession(CFG_COMPLETE);
+}
+
+void MeshtasticClient::finishConfigSession(ConfigSessionState result) {
+    uint32_t now = millis();
+    configSession.state = result;
+    configSession.durationMs = now - configSession.startTime;
+    configSession.rxBytes = linkRxBytes() - configSession.rxBytesAtStart;
+    configSession.txBytes = linkTxBytes() - configSession.txBytesAtStart;
+    uint32_t rxBps = configSession.durationMs
+                         ? (uint32_t)((uint64_t)configSession.rxBytes * 1000 / configSession.durationMs)
+                         : 0;
+
+    static const char *const phaseNames[] = {"full", "config", "nodes"};
+    LOGF("[Config] %s session %s: %lu frames, %lu nodes, %lu bytes rx / %lu tx in %lu ms, %lu B/s (%u attempt%s)\n",
+         phaseNames[configSession.phase], result == CFG_COMPLETE ? "complete" : "FAILED",
+         (unsigned long)configSession.frames,
+         (unsigned long)configSession.nodes, (unsigned long)configSession.rxBytes,
+         (unsigned long)configSession.txBytes, (unsigned long)configSession.durationMs, (unsigned long)rxBps,
+         configSession.attempts, configSession.attempts == 1 ? "" : "s");
+
+    // Node DB downloads are the bulk transfer worth comparing across link speeds
+    bool carriedNodeDb = configSession.phase != CFG_PHASE_CONFIG || configSession.nodes > 1;
+    if (result == CFG_COMPLETE && carriedNodeDb && transportIs(TRANSPORT_UART)) {
+        lastNodeSyncBps = rxBps;
+        if (uartUpgrade.state == UART_UPGRADE_VERIFY) {
+            uartUpgrade.state = UART_UPGRADE_DONE;
+            uartUpgrade.bpsAfter = rxBps;
+            LOGF("[UART] Speed upgrade done: %lu baud %lu B/s -> %lu baud %lu B/s\n",
+                 (unsigned long)uartUpgrade.fromBaud, (unsigned long)uartUpgrade.bpsBefore,
+                 (unsigned long)uartUpgrade.targetBaud, (unsigned long)uartUpgrade.bpsAfter);
+            events.postNotice(NOTICE_SUCCESS, "Link now " + String(uartUpgrade.targetBaud) + " baud");
+        }
+    }
+
+    if (configSession.phase == CFG_PHASE_NODES) {
+        initialDiscoveryComplete = true;
+        events.postNodeListChanged(); // Final node count and list
+        return;
+    }
+
+    if (result == CFG_COMPLETE) {
+        configReceived = true;
+        if (connectionState == CONN_WAITING_CONFIG) updateConnectionState(CONN_READY);
+    } else if (connectionState == CONN_WAITING_CONFIG) {
+        // Keep whatever arrived usable; only a session that never heard back is an error
+        updateConnectionState(configSession.frames > 0 ? CONN_READY : CONN_ERROR);
+    }
+
+    // Older firmware treats the config-only nonce as an ordinary one and has
+    // already sent the whole node DB (more than our own NodeInfo)
+    if (configSession.phase == CFG_PHASE_CONFIG && result == CFG_COMPLETE && configSession.nodes <= 1) {
+        LOGF("[Config] Ready after %lu ms - fetching node DB in the background\n",
+             (unsigned long)configSession.durationMs);
+        if (startConfigSession(CFG_PHASE_NODES)) return;
+    }
+    initialDiscoveryComplete = true;
+}
+
 void MeshtasticClient::requestNodeList() {
     Serial.println("[Nodes] Manual refresh requested - restarting node discovery");
     
@@ -1886,18 +2144,23 @@ void MeshtasticClient::requestNodeList() {
         return;
     }
 
-    auto packet = buildWantConfig(0);
-    if (sendProtobuf(packet.data(), packet.size())) {
-        Serial.println("[Nodes] Config request sent to restart discovery");
+    if (configSessionActive()) {
+        Serial.println("[Nodes] Config session already in progress");
+    } else if (startConfigSession(CFG_PHASE_NODES)) {
+        Serial.println("[Nodes] Node DB request sent to restart discovery");
     } else {
         Serial.println("[Nodes] Failed to send config request");
-        if (g_ui) g_ui->showMessage("Failed to refresh nodes");
+        events.postNotice(NOTICE_INFO, "Failed to refresh nodes");
     }
 }
 
 // UART Implementation
-bool MeshtasticClient::tryInitUART() {
+bool MeshtasticClient::tryInitUART(bool detectBaud) {
     Serial.println("[UART] tryInitUART() called");
+    if (uartProbing) {
+        Serial.println("[UART] Port open or baud detection already running");
+        return false;
+    }
     
     // Honor Bluetooth-only preference: skip UART init entirely
     if (userConnectionPreference == PREFER_BLUETOOTH) {
@@ -1908,8 +2171,8 @@ bool MeshtasticClient::tryInitUART() {
     if (uartInited && uartAvailable) {
         Serial.println("[UART] Already initialized and available (fast path)");
         // Ensure connection flags are set even on fast path (they were missing before)
-        if (connectionType != "UART") {
-            connectionType = "UART";
+        if (!transportIs(TRANSPORT_UART)) {
+            selectTransport(&uartTransport);
         }
         if (!isConnected) {
             isConnected = true;
@@ -1934,123 +2197,40 @@ bool MeshtasticClient::tryInitUART() {
 
 #if defined(ARDUINO)
     Serial.println("[UART] Initializing UART connection...");
-    Serial.printf("[UART] Config: baud=%d, RX=GPIO%d, TX=GPIO%d\n", uartBaud, uartRxPin, uartTxPin);
-    
-#ifdef USE_ESP_IDF_UART
-    // Use ESP-IDF uart driver (like Bus-Pirate HdUartService)
-    Serial.println("[UART] Using ESP-IDF uart driver");
-    
-    // Configure UART parameters
-    uart_config_t uart_config = {
-        .baud_rate = (int)uartBaud,
-        .data_bits = UART_DATA_8_BITS,
-        .parity = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
-        .rx_flow_ctrl_thresh = 122,
-        .source_clk = UART_SCLK_DEFAULT,
-    };
-    
-    // Install UART driver
-    const int uart_buffer_size = 1024;
-    esp_err_t err = uart_driver_install(UART_NUM_1, uart_buffer_size, 0, 0, NULL, 0);
-    if (err != ESP_OK) {
-        Serial.printf("[UART] uart_driver_install failed: %d\n", err);
-        return false;
-    }
-    
-    // Configure UART parameters
-    err = uart_param_config(UART_NUM_1, &uart_config);
-    if (err != ESP_OK) {
-        Serial.printf("[UART] uart_param_config failed: %d\n", err);
-        uart_driver_delete(UART_NUM_1);
-        return false;
-    }
-    
-    // Set UART pins
-    err = uart_set_pin(UART_NUM_1, uartTxPin, uartRxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    if (err != ESP_OK) {
-        Serial.printf("[UART] uart_set_pin failed: %d\n", err);
-        uart_driver_delete(UART_NUM_1);
-        return false;
-    }
-    
-    // Configure GPIO as input with pullup for RX
-    gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_DISABLE;
-    io_conf.mode = GPIO_MODE_INPUT;
-    io_conf.pin_bit_mask = (1ULL << uartRxPin);
-    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
-    gpio_config(&io_conf);
-    
-    Serial.println("[UART] ESP-IDF UART driver installed successfully");
+    // Opening waits out the port's settle delays; like the baud probe it only
+    // touches the port, so the state lock is let go meanwhile
+    bool opened;
+    uartProbing = true;
+    {
+        uint32_t baud = uartBaud;
+        int txPin = uartTxPin, rxPin = uartRxPin;
+        StateUnlock unlock(stateMutex);
+        LinkLock lock(linkMutex, portMAX_DELAY);
+        opened = uartTransport.open(baud, txPin, rxPin);
+    }
+    uartProbing = false;
+    if (!opened) return false;
     uartInited = true;
-    
-    // Wait for hardware to stabilize
-    delay(200);
-    
-    // Clear any junk in both RX and TX buffers
-    uart_flush(UART_NUM_1);
-    
-    // Additional cleanup: read and discard any garbage data
-    uint8_t dummy[256];
-    size_t cleared = 0;
-    int len;
-    while ((len = uart_read_bytes(UART_NUM_1, dummy, sizeof(dummy), 10 / portTICK_PERIOD_MS)) > 0) {
-        cleared += len;
-    }
-    if (cleared > 0) {
-        Serial.printf("[UART] Cleared %d bytes of garbage from ESP-IDF buffer\n", cleared);
-    }
-    
-#else
-    // Use Arduino Serial1 (original implementation)
-    uartPort = &Serial1;
-    uartPort->end();
-    delay(100);
 
-    Serial.printf("[UART] Initializing in TextMsg mode - extra care to prevent spurious signals\n");
-    Serial.printf("[UART] Calling Serial1.begin(%d, SERIAL_8N1, %d, %d)\n", uartBaud, uartRxPin, uartTxPin);
-    
-    // Configure pins BEFORE initializing serial to prevent glitches
-    pinMode(uartRxPin, INPUT_PULLUP);
-    pinMode(uartTxPin, OUTPUT);
-    digitalWrite(uartTxPin, HIGH);  // Set TX high (idle state) before enabling UART
-    delay(100);  // Longer stabilization time
-    
-    uartPort->begin(uartBaud, SERIAL_8N1, uartRxPin, uartTxPin);
-    uartInited = true;
-    
-    // Verify Serial1 configuration
-    Serial.printf("[UART] Serial1 initialized: available=%d, baudRate=%d\n", uartPort->available(), uartPort->baudRate());
-    Serial.printf("[UART] GPIO states: RX(GPIO%d)=%d, TX(GPIO%d)=%d\n", 
-                  uartRxPin, digitalRead(uartRxPin), uartTxPin, digitalRead(uartTxPin));
-    
-    // Give it more time to stabilize in TextMsg mode
-    delay(500);
-    
-    // Flush TX buffer to ensure no garbage is sent
-    uartPort->flush();
-    delay(100); // Extra delay after flush
-    
-    // In TextMsg mode, ensure TX line is stable
-    if (textMessageMode) {
-        Serial.println("[UART] TextMsg mode - ensuring TX line stability");
-        digitalWrite(uartTxPin, HIGH);  // Ensure TX is high (idle)
-        delay(100);
-    }
-    
-    // Clear any junk in the RX buffer
-    int cleared = 0;
-    while (uartPort->available()) {
-        uartPort->read();
-        cleared++;
-    }
-    if (cleared > 0) {
-        Serial.printf("[UART] Cleared %d bytes from Arduino Serial1 buffer\n", cleared);
+    // Text mode has no framing to recognise, so only protobuf mode probes
+    if (!textMessageMode && detectBaud) {
+        uint32_t detected = detectUARTBaud();
+        // The state lock was dropped while probing; the port may have been
+        // closed or handed to another link meanwhile
+        if (!uartTransport.isOpen()) {
+            Serial.println("[UART] Port closed during baud detection");
+            uartInited = false;
+            return false;
+        }
+        if (detected && detected != uartBaud) {
+            Serial.printf("[UART] Radio answers at %lu baud (configured %lu) - saving\n",
+                          (unsigned long)detected, (unsigned long)uartBaud);
+            uartBaud = detected;
+            saveSettings();
+        }
+        // A frame that proved the rate is still buffered in the framer
+        if (detected) wakeProtocolTask(PROTO_EVT_RX);
     }
-#endif
     
     Serial.println("[UART] Serial port initialized successfully");
     
@@ -2058,7 +2238,7 @@ bool MeshtasticClient::tryInitUART() {
     uartAvailable = true;
     isConnected = true;            // Treat UART availability as a connected transport
     deviceConnected = true;
-    connectionType = "UART";      // Advertise actual connection type
+    selectTransport(&uartTransport);  // Advertise actual connection type
     connectedDeviceName = "UART Device";
     
     Serial.println("[UART] UART connection ready - marked as connected");
@@ -2075,10 +2255,8 @@ bool MeshtasticClient::tryInitUART() {
         uartDeferredConfig = false; // Disable deferred config
         
         // Send initial config request after a short delay to let UART stabilize
-        // We can't block here, so we'll let the loop handle it via probeUARTOnce
-        // or just trigger it now if we are sure.
-        // Let's trigger it in the next loop cycle by setting state to CONN_CONNECTED
-        // and ensuring probeUARTOnce picks it up.
+        // We can't block here, so we'll let the loop handle it via the deferred
+        // config trigger in serviceDeferredUARTConfig().
         
         // Actually, let's just send it now to be sure.
         // But we need to be careful about blocking.
@@ -2099,215 +2277,229 @@ bool MeshtasticClient::tryInitUART() {
 #endif
 }
 
-bool MeshtasticClient::probeUARTOnce() {
-    if (!uartPort) return false;
-
-    int avail = uartPort->available();
-    if (avail > 0) return true;
+void MeshtasticClient::closeUART() {
+    // A baud probe may be using the port with the state lock dropped
+    LinkLock lock(linkMutex, portMAX_DELAY);
+    uartTransport.close();
+    uartAvailable = false;
+    uartInited = false;
+}
 
-    // Send requests to trigger responses only in protobuf mode
-    if (!textMessageMode) {
-        static uint32_t requestCounter = 0;
-        static uint32_t lastIntensiveRequest = 0;
-        requestCounter++;
-        uint32_t now = millis();
-        
-        // While waiting/requesting config, do not transmit anything; rely on requestConfig() + timeout
-        if (connectionState == CONN_WAITING_CONFIG || connectionState == CONN_REQUESTING_CONFIG) {
-            return (avail > 0);
-        } else if ((connectionState == CONN_CONNECTED || connectionState == CONN_READY) && !initialDiscoveryComplete) {
-            // Very aggressive discovery phase - multiple request types for fast node discovery
-            if (now - lastIntensiveRequest > 300) {  // Throttle to every 300ms during discovery phase
-                // Cycle through many different request types to discover nodes quickly
-                switch (requestCounter % 8) {
-                    case 0:
-                        // Standard config request
-                        {
-                            auto pkt = buildWantConfig(0);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery config probe (cycle %d, nodes=%d)\n", requestCounter, nodeList.size());
-                        }
-                        break;
-                    case 1:
-                        // Node database request
-                        {
-                            auto pkt = buildWantConfig(69420);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery node DB request (nodes=%d)\n", nodeList.size());
-                        }
-                        break;
-                    case 2:
-                        // Alternative node database request
-                        {
-                            auto pkt = buildWantConfig(12345);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery alt DB request (nodes=%d)\n", nodeList.size());
-                        }
-                        break;
-                    case 3:
-                        // Broadcast request
-                        {
-                            auto pkt = buildWantConfig(1);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery broadcast request (nodes=%d)\n", nodeList.size());
-                        }
-                        break;
-                    case 4:
-                        // Another variant config request
-                        {
-                            auto pkt = buildWantConfig(0xFFFFFFFF);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery variant config (nodes=%d)\n", nodeList.size());
-                        }
-                        break;
-                    case 5:
-                        // Request with specific node ID pattern
-                        {
-                            auto pkt = buildWantConfig(0x12345678);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery pattern request (nodes=%d)\n", nodeList.size());
-                        }
-                        break;
-                    case 6:
-                        // Small ID request
-                        {
-                            auto pkt = buildWantConfig(42);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery small ID request (nodes=%d)\n", nodeList.size());
-                        }
-                        break;
-                    case 7:
-                        // Large ID request  
-                        {
-                            auto pkt = buildWantConfig(0xABCDEF00);
-                            bool ok = sendProtobufUART(pkt.data(), pkt.size(), true);
-                            if (ok) LOGF("[UART] Discovery large ID request (nodes=%d)\n", nodeList.size());
-                        }
-                        break;
-                }
-                lastIntensiveRequest = now;
-                requestCounter++;
-            }
+uint32_t MeshtasticClient::detectUARTBaud() {
+    uint32_t start = millis();
+    uint32_t saved = uartBaud;
+    uint32_t found = 0;
+    // Probing takes up to a few seconds and only touches the port, which the
+    // link lock covers; the UI and callers of the client carry on meanwhile
+    uartProbing = true;
+    {
+        StateUnlock unlock(stateMutex);
+        if (probeUARTBaud(saved, saved)) {
+            found = saved;
         } else {
-            // Discovery complete - send occasional maintenance probes but much less frequently
-            // Only send minimal requests to get messages, not full node discovery
-            if (now - lastIntensiveRequest > 5000) { // 5s maintenance interval
-                auto pkt = buildWantConfig(0);
-                (void)sendProtobufUART(pkt.data(), pkt.size(), true);
-                lastIntensiveRequest = now;
+            for (uint32_t baud : UART_BAUD_CANDIDATES) {
+                if (baud == saved) continue;
+                if (!uartTransport.isOpen()) break;
+                if (probeUARTBaud(baud, saved)) {
+                    found = baud;
+                    break;
+                }
             }
-            // LOGF("[UART] Light maintenance probe (discovery complete, nodes=%d)\n", nodeList.size());
+            // Nothing answered (radio absent or still booting): stay on the saved rate
+            if (!found) probeUARTBaud(0, saved);
         }
     }
+    uartProbing = false;
+    Serial.printf("[UART] Baud detection: %s%lu after %lu ms\n", found ? "" : "no answer, keeping ",
+                  (unsigned long)(found ? found : saved), (unsigned long)(millis() - start));
+    return found;
+}
 
+// Switches the port to baud and waits for a complete frame. It listens first,
+// since the radio may already be sending (mesh traffic, a config dump), then
+// sends a heartbeat, which changes nothing on the radio and which newer
+// firmware answers; at a wrong rate the radio's framer drops it as noise.
+// Frames are left in the framer for the normal receive path. baud == 0 just
+// restores the saved rate. Runs without the state lock, so it only touches
+// the port.
+bool MeshtasticClient::probeUARTBaud(uint32_t baud, uint32_t saved) {
+    LinkLock lock(linkMutex, portMAX_DELAY);
+    if (!uartTransport.isOpen()) return false;
+    uartTransport.setBaud(baud ? baud : saved);
+    // Whatever was read at the previous rate is noise
+    uartTransport.flushInput();
+    if (!baud) return false;
+
+    uint32_t start = millis();
+    bool nudged = false;
+    while (millis() - start < UART_PROBE_LISTEN_MS) {
+        if (uartTransport.frameReady()) return true;
+        if (!nudged && millis() - start >= UART_PROBE_PASSIVE_MS) {
+            nudged = true;
+            size_t len = buildHeartbeat(txFrame + STREAM_HEADER_SIZE, MAX_PACKET_SIZE);
+            if (len) uartTransport.send(txFrame, len);
+        }
+        delay(5);
+    }
     return false;
 }
 
-std::vector<uint8_t> MeshtasticClient::receiveProtobufUART() {
-    std::vector<uint8_t> out;
-
-    // Respect Bluetooth-only preference: do not consume UART
-    if (userConnectionPreference == PREFER_BLUETOOTH) {
-        return out;
+bool MeshtasticClient::requestUARTSpeedUpgrade(uint32_t targetBaud) {
+    if (!transportIs(TRANSPORT_UART) || !uartAvailable || textMessageMode || myNodeId == 0) {
+        LOG_PRINTLN("[UART] Speed upgrade needs a protobuf Grove link with the radio's config loaded");
+        return false;
+    }
+    if (isUARTSpeedUpgradeActive()) return false;
+    if (serialBaudToEnum(targetBaud) == 0 || targetBaud == uartBaud) return false;
+
+    int slot = acquireTxSlot();
+    if (slot < 0) return false;
+    TxRequest &req = txSlots[slot];
+    req.packetId = esp_random() & 0x7FFFFFFF;
+    req.len = buildGetSerialConfig(req.frame + STREAM_HEADER_SIZE, MAX_PACKET_SIZE, myNodeId, req.packetId);
+    req.kind = TX_KIND_ADMIN;
+    if (req.len == 0) {
+        releaseTxSlot(slot);
+        return false;
     }
+    if (!submitTxSlot(slot)) return false;
 
-    if (!uartAvailable) return out;
+    uartUpgrade = UartUpgrade();
+    uartUpgrade.state = UART_UPGRADE_QUERY;
+    uartUpgrade.targetBaud = targetBaud;
+    uartUpgrade.fromBaud = uartBaud;
+    uartUpgrade.startTime = millis();
+    uartUpgrade.bpsBefore = lastNodeSyncBps;
+    LOG_PRINTF("[UART] Speed upgrade %lu -> %lu baud: reading radio serial config\n",
+               (unsigned long)uartBaud, (unsigned long)targetBaud);
+    return true;
+}
 
-#ifdef USE_ESP_IDF_UART
-    // Drain bytes from ESP-IDF UART
-    size_t available = 0;
-    uart_get_buffered_data_len(UART_NUM_1, &available);
-    if (available > 0) {
-        uint8_t temp[256];
-        int toRead = (int)((available > sizeof(temp)) ? sizeof(temp) : available);
-        int len = uart_read_bytes(UART_NUM_1, temp, toRead, 10 / portTICK_PERIOD_MS);
-        if (len > 0) {
-            uartRxBuffer.insert(uartRxBuffer.end(), temp, temp + len);
-        }
+void MeshtasticClient::onSerialConfig(const ParsedFromRadio &parsed) {
+    if (uartUpgrade.state != UART_UPGRADE_QUERY) return;
+    ParsedSerialConfig cfg = parsed.serialConfig;
+    LOG_PRINTF("[UART] Radio serial module: enabled=%d mode=%lu baud=%lu rx=%lu tx=%lu\n", cfg.enabled ? 1 : 0,
+               (unsigned long)cfg.mode, (unsigned long)serialBaudFromEnum(cfg.baud), (unsigned long)cfg.rxd,
+               (unsigned long)cfg.txd);
+    // A disabled module means we're on the firmware console port, whose rate is fixed
+    if (!cfg.enabled || cfg.mode != 2 /* PROTO */) {
+        failUARTUpgrade("radio serial module is not in PROTO mode");
+        return;
     }
-#else
-    if (!uartPort) return out;
-    while (uartPort->available()) {
-        uint8_t byte = uartPort->read();
-        uartRxBuffer.push_back(byte);
-        if (uartRxBuffer.size() > MAX_UART_FRAME) {
-            uartRxBuffer.clear();
-            break;
-        }
+    cfg.baud = serialBaudToEnum(uartUpgrade.targetBaud);
+
+    int slot = acquireTxSlot();
+    if (slot < 0) {
+        failUARTUpgrade("TX queue full");
+        return;
     }
-#endif
+    TxRequest &req = txSlots[slot];
+    req.packetId = esp_random() & 0x7FFFFFFF;
+    req.len = buildSetSerialConfig(req.frame + STREAM_HEADER_SIZE, MAX_PACKET_SIZE, myNodeId, cfg,
+                                   parsed.adminPasskey, req.packetId);
+    req.kind = TX_KIND_ADMIN;
+    if (req.len == 0) releaseTxSlot(slot);
+    if (req.len == 0 || !submitTxSlot(slot)) {
+        failUARTUpgrade("could not queue set_module_config");
+        return;
+    }
+    uartUpgrade.state = UART_UPGRADE_REBOOT;
+    uartUpgrade.startTime = millis();
+    LOG_PRINTLN("[UART] Serial config written - waiting for radio reboot");
+    events.postNotice(NOTICE_INFO, "Radio rebooting...");
+}
 
-    // Common parse logic from buffer
-    size_t discarded = 0;
-    while (!uartRxBuffer.empty() && (uartRxBuffer[0] != STREAM_START1)) {
-        uartRxBuffer.erase(uartRxBuffer.begin());
-        discarded++;
-    }
-    if (discarded > 0) {
-        // Rate limit this log
-        static uint32_t lastGarbageLog = 0;
-        if (millis() - lastGarbageLog > 1000) {
-            Serial.printf("[UART] Discarded %d bytes of garbage (waiting for 0x%02X)\n", (int)discarded, STREAM_START1);
-            lastGarbageLog = millis();
-        }
-    }
-    if (uartRxBuffer.size() >= 2 && uartRxBuffer[0] == STREAM_START1 && uartRxBuffer[1] != STREAM_START2) {
-        uartRxBuffer.erase(uartRxBuffer.begin());
-    }
-
-    // Deferred config trigger & fallback: send initial config only once when activity appears,
-    // or after a timeout if no bytes ever arrive.
-    if (uartDeferredConfig) {
-        bool hasActivity = !uartRxBuffer.empty();
-        // Reduced timeout to 1s to start faster
-        bool timeout = (uartDeferredStartTime > 0 && (millis() - uartDeferredStartTime > 1000));
-        if (hasActivity || timeout) {
-            Serial.println(hasActivity ? "[UART] Activity detected - sending deferred config request" : "[UART] Timeout - sending initial config request");
-            uartDeferredConfig = false;
-            requestConfig();
-            discoveryStartTime = millis();
-            lastNodeAddedTime = millis();
-        }
+void MeshtasticClient::serviceUARTUpgrade(uint32_t now) {
+    if (uartUpgrade.state == UART_UPGRADE_QUERY && now - uartUpgrade.startTime >= UART_UPGRADE_QUERY_TIMEOUT_MS) {
+        failUARTUpgrade("no reply to serial config request");
+    } else if (uartUpgrade.state == UART_UPGRADE_REBOOT && now - uartUpgrade.startTime >= UART_UPGRADE_REBOOT_MS) {
+        uartUpgrade.state = UART_UPGRADE_VERIFY;
+        uartUpgrade.startTime = now;
+        // The rate is known, so no detection on the protocol task; the config
+        // download that follows the reopen is the check
+        setUARTConfig(uartUpgrade.targetBaud, uartTxPin, uartRxPin, true, false);
+    } else if (uartUpgrade.state == UART_UPGRADE_VERIFY && configSession.state == CFG_FAILED &&
+               (int32_t)(configSession.startTime - uartUpgrade.startTime) >= 0) {
+        failUARTUpgrade("no config from radio at the new rate");
     }
-    if (uartRxBuffer.size() >= 4 && uartRxBuffer[0] == STREAM_START1 && uartRxBuffer[1] == STREAM_START2) {
-        uint16_t len = (uartRxBuffer[2] << 8) | uartRxBuffer[3];
-        if (len > MAX_PACKET_SIZE) {
-            uartRxBuffer.clear();
-            return out;
-        }
-        if (uartRxBuffer.size() >= static_cast<size_t>(len) + 4) {
-            out.assign(uartRxBuffer.begin() + 4, uartRxBuffer.begin() + 4 + len);
-            uartRxBuffer.erase(uartRxBuffer.begin(), uartRxBuffer.begin() + 4 + len);
-            // LOG_PRINTF("[UART-RX] Complete packet received: length=%d\n", len);
-            // dumpHex("[UART-RX-PKT]", out.data(), out.size());
+}
+
+void MeshtasticClient::failUARTUpgrade(const char *reason) {
+    LOG_PRINTF("[UART] Speed upgrade to %lu baud failed: %s\n", (unsigned long)uartUpgrade.targetBaud, reason);
+    bool reopened = uartUpgrade.state == UART_UPGRADE_VERIFY;
+    uartUpgrade.state = UART_UPGRADE_FAILED;
+    // Back to the old rate; if the radio did switch after all, a Grove
+    // reconnect detects it
+    if (reopened && uartBaud != uartUpgrade.fromBaud) {
+        setUARTConfig(uartUpgrade.fromBaud, uartTxPin, uartRxPin, true, false);
+    }
+    events.postNotice(NOTICE_ERROR, "Baud upgrade failed");
+}
+
+void MeshtasticClient::serviceKeepalive(uint32_t now) {
+    // Roll the per-minute traffic counters
+    if (now - minuteStartTime >= 60000) {
+        rxBytesLastMinute = linkRxBytes() - minuteStartRxBytes;
+        txBytesLastMinute = linkTxBytes() - minuteStartTxBytes;
+        minuteStartRxBytes = linkRxBytes();
+        minuteStartTxBytes = linkTxBytes();
+        if (minuteStartTime != 0 && isConnected) {
+            LOGF("[Link] Last minute: rx=%lu B tx=%lu B (heartbeats=%lu)\n", (unsigned long)rxBytesLastMinute,
+                 (unsigned long)txBytesLastMinute, (unsigned long)heartbeatsSent);
         }
+        minuteStartTime = now;
     }
 
-    return out;
-}
+    if (!isConnected || textMessageMode || deviceType != DEVICE_MESHTASTIC) {
+        linkAlive = false;
+        return;
+    }
 
-bool MeshtasticClient::sendProtobufUART(const uint8_t *data, size_t len, bool allowWhenUnavailable) {
-    // Respect Bluetooth-only preference: do not transmit on UART
-    if (userConnectionPreference == PREFER_BLUETOOTH) return false;
-    if (!data || !len) return false;
-    if (!allowWhenUnavailable && !uartAvailable) return false;
-    if (len > MAX_PACKET_SIZE) return false;
+    bool alive = lastLinkRxTime() != 0 && now - lastLinkRxTime() < LINK_SILENT_MS;
+    if (alive != linkAlive) {
+        linkAlive = alive;
+        LOGF("[Link] Radio link %s\n", alive ? "alive" : "silent - no bytes received recently");
+    }
 
-#ifdef USE_ESP_IDF_UART
-    uint8_t header[4] = {STREAM_START1, STREAM_START2, (uint8_t)(len / 256), (uint8_t)(len % 256)};
-    int w1 = uart_write_bytes(UART_NUM_1, (const char*)header, 4);
-    int w2 = uart_write_bytes(UART_NUM_1, (const char*)data, (size_t)len);
-    return (w1 == 4 && w2 == (int)len);
-#else
-    if (!uartPort) return false;
-    uartPort->write(STREAM_START1);
-    uartPort->write(STREAM_START2);
-    uartPort->write((uint8_t)(len / 256));
-    uartPort->write((uint8_t)(len % 256));
-    size_t written = uartPort->write(data, len);
-    uartPort->flush();
-    return written == len;
-#endif
+    // Real traffic and config sessions already prove we're here
+    if (configSessionActive()) return;
+    uint32_t lastTx = std::max(lastLinkTxTime(), lastHeartbeatTime);
+    if (lastTx != 0 && now - lastTx < HEARTBEAT_INTERVAL_MS) return;
+
+    lastHeartbeatTime = now;
+    int slot = acquireTxSlot();
+    if (slot < 0) return;
+    TxRequest &req = txSlots[slot];
+    req.len = buildHeartbeat(req.frame + STREAM_HEADER_SIZE, MAX_PACKET_SIZE);
+    req.packetId = 0;
+    req.kind = TX_KIND_HEARTBEAT;
+    if (req.len == 0) {
+        releaseTxSlot(slot);
+        return;
+    }
+    if (submitTxSlot(slot)) heartbeatsSent++;
+}
+
+// Deferred config trigger & fallback: send initial config only once when activity appears,
+// or after a timeout if no bytes ever arrive.
+void MeshtasticClient::serviceDeferredUARTConfig() {
+    if (!uartDeferredConfig || !transportIs(TRANSPORT_UART) || !uartAvailable) return;
+    uint32_t lastRx = uartTransport.stats().lastRxMs;
+    bool hasActivity = lastRx != 0 && (int32_t)(lastRx - uartDeferredStartTime) >= 0;
+    // Reduced timeout to 1s to start faster
+    bool timeout = (uartDeferredStartTime > 0 && (millis() - uartDeferredStartTime > 1000));
+    if (hasActivity || timeout) {
+        uartDeferredConfig = false;
+        // A download already running will bring everything a new one would
+        if (configSessionActive()) {
+            Serial.println("[UART] Config download already running - no deferred request");
+            return;
+        }
+        Serial.println(hasActivity ? "[UART] Activity detected - sending deferred config request" : "[UART] Timeout - sending initial config request");
+        requestConfig();
+        discoveryStartTime = millis();
+        lastNodeAddedTime = millis();
+    }
 }
 
 void MeshtasticClient::processTextMessage() {
@@ -2320,8 +2512,7 @@ void MeshtasticClient::processTextMessage() {
     
 #ifdef USE_ESP_IDF_UART
     // Check available data using ESP-IDF uart driver
-    size_t available = 0;
-    uart_get_buffered_data_len(UART_NUM_1, &available);
+    size_t available = uartTransport.available();
     
     if (now - lastDiagnostic > 5000) {
         diagCount++;
@@ -2337,7 +2528,13 @@ void MeshtasticClient::processTextMessage() {
     
     // Read data using ESP-IDF uart_read_bytes
     uint8_t buffer[128];
-    int len = uart_read_bytes(UART_NUM_1, buffer, sizeof(buffer), 20 / portTICK_PERIOD_MS);
+    int len;
+    {
+        // Waits up to 20 ms for input, off the state lock
+        StateUnlock unlock(stateMutex);
+        LinkLock lock(linkMutex, portMAX_DELAY);
+        len = uartTransport.readRaw(buffer, sizeof(buffer), 20);
+    }
     
     if (len > 0) {
         Serial.printf("[TextMode-RX] Read %d bytes from ESP-IDF uart\n", len);
@@ -2383,9 +2580,7 @@ void MeshtasticClient::processTextMessage() {
                     msg.status = MSG_STATUS_DELIVERED;
                     msg.fromName = fromName.length() > 0 ? fromName : "Radio";
                     
-                    addMessageToHistory(msg);
-                    
-                    if (g_ui && g_ui->currentTab != 0) g_ui->showSuccess("Text message received");
+                    addMessageToHistory(msg, MSG_EVENT_TOAST);
                     textRxBuffer = "";
                 }
             } else {
@@ -2395,6 +2590,7 @@ void MeshtasticClient::processTextMessage() {
     }
 #else
     // Use Arduino Serial1 (original implementation)
+    HardwareSerial *uartPort = uartTransport.port();
     if (!uartPort) return;
     
     if (now - lastDiagnostic > 5000) {
@@ -2458,13 +2654,7 @@ void MeshtasticClient::processTextMessage() {
                 msg.messageType = MSG_TYPE_TEXT;
                 msg.snr = 0.0f;  // SNR not available in text mode
                 
-                addMessageToHistory(msg);
-                
-                // Show message in UI only if not on Messages page
-                if (g_ui && g_ui->currentTab != 0) {
-                    g_ui->showMessage("New: " + textRxBuffer.substring(0, 20) + 
-                                    (textRxBuffer.length() > 20 ? "..." : ""));
-                }
+                addMessageToHistory(msg, MSG_EVENT_TOAST);
                 
                 textRxBuffer = "";
             } else {
@@ -2519,15 +2709,51 @@ bool MeshtasticClient::sendMessage(uint32_t nodeId, const String &message, uint8
     if (deviceType == DEVICE_MESHCORE) {
         return sendDirectMessage(nodeId, message);
     }
-    
+    if (!isConnected) return false;
+
+    int slot = acquireTxSlot();
+    if (slot < 0) {
+        LOG_PRINTLN("[TxQueue] Queue full - message rejected");
+        return false;
+    }
+    TxRequest &req = txSlots[slot];
     uint32_t packetId = 0;
-    std::vector<uint8_t> packet = buildTextMessage(myNodeId, nodeId, channel, message, packetId, true);
-    
-    if (sendProtobuf(packet.data(), packet.size())) {
-        LOG_PRINTF("[Message] Sent to 0x%08X (id=%d)\n", nodeId, packetId);
-        return true;
+    req.len = buildTextMessage(req.frame + STREAM_HEADER_SIZE, MAX_PACKET_SIZE, myNodeId, nodeId, channel,
+                               message, packetId, true);
+    req.packetId = packetId;
+    req.kind = TX_KIND_TEXT;
+    if (req.len == 0) {
+        releaseTxSlot(slot);
+        return false;
     }
-    return false;
+    if (!submitTxSlot(slot)) return false;
+
+    MeshtasticMessage msg;
+    msg.fromNodeId = myNodeId;
+    msg.toNodeId = nodeId;
+    msg.fromName = myNodeName.length() ? myNodeName : generateNodeDisplayName(myNodeId);
+    if (nodeId == 0xFFFFFFFF) {
+        msg.toName = getPrimaryChannelName();
+        if (msg.toName.isEmpty()) msg.toName = "Primary";
+    } else {
+        const MeshtasticNode *node = findNode(nodeId);
+        msg.toName = (node && node->longName.length()) ? node->longName
+                   : (node && node->shortName.length()) ? node->shortName : generateNodeDisplayName(nodeId);
+    }
+    msg.content = message;
+    msg.timestamp = millis() / 1000;
+    msg.messageType = MSG_TYPE_TEXT;
+    msg.channel = channel;
+    msg.isDirect = (nodeId != 0xFFFFFFFF);
+    msg.status = MSG_STATUS_SENDING;
+    msg.packetId = packetId;
+    addMessageToHistory(msg);
+    if (!pendingAcks.track(packetId, nodeId, messageHistory.back().historySeq, millis())) {
+        LOG_PRINTF("[Ack] Tracker full - id=%u will not be ack-tracked\n", packetId);
+    }
+
+    LOG_PRINTF("[Message] Queued to 0x%08X (id=%u)\n", nodeId, packetId);
+    return true;
 }
 
 bool MeshtasticClient::sendDirectMessage(uint32_t nodeId, const String &message) {
@@ -2597,7 +2823,6 @@ int MeshtasticClient::getBrightness() const {
 
 void MeshtasticClient::setBrightness(uint8_t b) {
     brightness = b;
-    M5.Display.setBrightness(b);
     saveSettings();
 }
 
@@ -2625,11 +2850,12 @@ void MeshtasticClient::updateScreenTimeout() {
 }
 
 String MeshtasticClient::getMessageModeString() const {
-    if (textMessageMode || messageMode == MODE_TEXTMSG) {
-        return "TextMsg";
-    }
+    return formatMessageMode(textMessageMode ? MODE_TEXTMSG : messageMode);
+}
 
-    switch (messageMode) {
+String MeshtasticClient::formatMessageMode(MessageMode mode) {
+    switch (mode) {
+        case MODE_TEXTMSG:   return "TextMsg";
         case MODE_PROTOBUFS: return "Protobufs";
         case MODE_SIMPLE:    return "Simple";
         default:             return "Unknown";
@@ -2637,8 +2863,12 @@ String MeshtasticClient::getMessageModeString() const {
 }
 
 String MeshtasticClient::getScreenTimeoutString() const {
-    if (screenTimeoutMs == 0) return "Never";
-    return String(screenTimeoutMs / 1000) + "s";
+    return formatScreenTimeout(screenTimeoutMs);
+}
+
+String MeshtasticClient::formatScreenTimeout(uint32_t timeoutMs) {
+    if (timeoutMs == 0) return "Never";
+    return String(timeoutMs / 1000) + "s";
 }
 
 void MeshtasticClient::setMessageMode(int mode) {
@@ -2669,15 +2899,20 @@ void MeshtasticClient::setMessageMode(int mode) {
     if (targetTextMode) {
         LOG_PRINTLN("[Mode] TextMsg mode enabled (UART-only)");
         // Text mode cannot operate over BLE transports
-        if (connectionType == "BLE" && isConnected) {
+        if (isBleLink() && isConnected) {
             LOG_PRINTLN("[Mode] Disconnecting BLE to honor TextMsg request");
             disconnectBLE();
         }
+        // Nor over the TCP API
+        if (isTcpConnecting() || tcpTransport.isOpen()) {
+            LOG_PRINTLN("[Mode] Disconnecting TCP to honor TextMsg request");
+            stopTcpConnection();
+        }
         if (uartAvailable) {
             updateConnectionState(CONN_READY);
         }
     } else {
-        if (wasTextMode && connectionType == "UART" && uartAvailable) {
+        if (wasTextMode && transportIs(TRANSPORT_UART) && uartAvailable) {
             LOG_PRINTLN("[Mode] Leaving TextMsg mode - requesting protobuf config");
             requestConfig();
         }
@@ -2699,14 +2934,26 @@ void MeshtasticClient::setTextMessageMode(int mode) {
 // ==========================================
 
 void MeshtasticClient::updateConnectionState(int state) {
+    if (connectionState != (ConnectionState)state) {
+        events.postConnectionState((uint8_t)state, transport ? transport->kind() : TRANSPORT_NONE);
+    }
     connectionState = (ConnectionState)state;
+    // Queue depth is per radio and per link; relearn it on the next one
+    if (connectionState == CONN_DISCONNECTED) {
+        LinkLock lock(linkMutex, portMAX_DELAY);
+        radioQueue = RadioQueueState();
+    }
+    // A config exchange never survives the link it was started on
+    if (connectionState == CONN_DISCONNECTED && configSessionActive()) {
+        configSession.state = CFG_IDLE;
+    }
 }
 
 bool MeshtasticClient::startGroveConnection() {
     Serial.println("[UART] Manual Grove connection requested via UI");
 
     // Always disconnect BLE first to ensure clean state
-    if (isConnected && connectionType == "BLE") {
+    if (isConnected && isBleLink()) {
         Serial.println("[UART] Disconnecting BLE before starting Grove...");
         disconnectBLE();
     }
@@ -2721,7 +2968,7 @@ bool MeshtasticClient::startGroveConnection() {
     }
 
     // If UART already active just report success
-    if (uartAvailable && connectionType == "UART") {
+    if (uartAvailable && transportIs(TRANSPORT_UART)) {
         Serial.println("[UART] Already connected via Grove");
         return true;
     }
@@ -2734,14 +2981,149 @@ bool MeshtasticClient::startGroveConnection() {
     return initOk;
 }
 
-bool MeshtasticClient::connectToDeviceByName(const String& name) {
-    // Find device by name in scanned list and connect
-    for (size_t i = 0; i < scannedDeviceNames.size(); i++) {
-        if (scannedDeviceNames[i] == name) {
-            return connectToDeviceByAddress(scannedDeviceAddresses[i]);
+// ==========================================
+// WiFi / TCP
+// ==========================================
+
+void MeshtasticClient::setWifiCredentials(const String &ssid, const String &password) {
+    wifiSsid = ssid;
+    wifiPassword = password;
+    saveSettings();
+}
+
+void MeshtasticClient::setTcpHost(const String &host) {
+    tcpHost = host;
+    tcpHost.trim();
+    saveSettings();
+}
+
+bool MeshtasticClient::startTcpConnection() {
+    if (wifiSsid.isEmpty() || tcpHost.isEmpty()) {
+        LOG_PRINTLN("[TCP] Need a WiFi network and a radio host first");
+        return false;
+    }
+    if (isTcpConnecting() || (transportIs(TRANSPORT_TCP) && tcpTransport.isUp())) return true;
+
+    // One radio link at a time
+    if (isBleLink()) disconnectBLE();
+    if (uartAvailable || uartInited) {
+        if (transportIs(TRANSPORT_UART)) selectTransport(nullptr);
+        closeUART();
+        isConnected = false;
+    }
+    // The TCP API speaks protobufs only
+    if (textMessageMode || messageMode == MODE_TEXTMSG) {
+        LOG_PRINTLN("[TCP] Forcing Protobufs message mode for TCP connection");
+        textMessageMode = false;
+        messageMode = MODE_PROTOBUFS;
+        saveSettings();
+    }
+
+    LOGF("[TCP] Joining WiFi '%s'...\n", wifiSsid.c_str());
+    WiFi.mode(WIFI_STA);
+    // Modem sleep would add a DTIM interval of latency to every packet
+    WiFi.setSleep(false);
+    if (WiFi.status() != WL_CONNECTED) WiFi.begin(wifiSsid.c_str(), wifiPassword.c_str());
+    tcpStage = TCP_STAGE_WIFI;
+    tcpStageStart = millis();
+    updateConnectionState(CONN_CONNECTING);
+    return true;
+}
+
+void MeshtasticClient::stopTcpConnection() {
+    bool wasActive = transportIs(TRANSPORT_TCP);
+    tcpStage = TCP_STAGE_IDLE;
+    if (wasActive) {
+        selectTransport(nullptr);
+        isConnected = false;
+        deviceConnected = false;
+    }
+    tcpTransport.close();
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    if (wasActive || connectionState == CONN_CONNECTING) updateConnectionState(CONN_DISCONNECTED);
+}
+
+void MeshtasticClient::onTcpLinkDown(const char *reason) {
+    LOGF("[TCP] Link down: %s\n", reason);
+    stopTcpConnection();
+    events.postNotice(NOTICE_ERROR, String("WiFi: ") + reason);
+}
+
+void MeshtasticClient::openTcpLink(const char *ip, uint32_t now) {
+    if (!tcpTransport.open(ip, MESHTASTIC_TCP_PORT)) {
+        onTcpLinkDown("cannot reach radio host");
+        return;
+    }
+    tcpStage = TCP_STAGE_CONNECTING;
+    tcpStageStart = now;
+}
+
+void MeshtasticClient::serviceTcpLink(uint32_t now) {
+    if (tcpStage == TCP_STAGE_WIFI) {
+        if (WiFi.status() == WL_CONNECTED) {
+            LOGF("[TCP] WiFi up as %s (RSSI %d dBm) after %lu ms\n", WiFi.localIP().toString().c_str(),
+                 (int)WiFi.RSSI(), (unsigned long)(now - tcpStageStart));
+            if (TcpTransport::isNumericHost(tcpHost.c_str())) {
+                openTcpLink(tcpHost.c_str(), now);
+            } else if (beginAsyncResolve(tcpHost)) {
+                // The lookup blocks; the connect task does it and wakes us
+                tcpStage = TCP_STAGE_RESOLVING;
+                tcpStageStart = now;
+            }
+            // Otherwise a BLE connect still has the task; try again next pass
+        } else if (now - tcpStageStart > WIFI_JOIN_TIMEOUT_MS) {
+            onTcpLinkDown("network join timed out");
         }
+        return;
+    }
+
+    if (tcpStage == TCP_STAGE_RESOLVING) {
+        uint8_t resolve = tcpResolve.load(std::memory_order_acquire);
+        if (resolve == TCP_RESOLVE_DONE) {
+            LOGF("[TCP] %s is %s\n", tcpHost.c_str(), tcpResolvedIp);
+            openTcpLink(tcpResolvedIp, now);
+        } else if (resolve == TCP_RESOLVE_FAILED) {
+            onTcpLinkDown("cannot resolve radio host");
+        } else if (now - tcpStageStart > TCP_RESOLVE_TIMEOUT_MS) {
+            onTcpLinkDown("radio host lookup timed out");
+        }
+        return;
+    }
+
+    if (tcpStage == TCP_STAGE_CONNECTING) {
+        tcpTransport.service();
+        if (tcpTransport.state() == TRANSPORT_ERROR) {
+            onTcpLinkDown("radio refused the connection");
+            return;
+        }
+        if (!tcpTransport.isUp()) return;
+
+        tcpStage = TCP_STAGE_IDLE;
+        deviceType = DEVICE_MESHTASTIC;
+        isConnected = true;
+        deviceConnected = true;
+        connectedDeviceName = tcpHost;
+        selectTransport(&tcpTransport);
+        updateConnectionState(CONN_CONNECTED);
+        discoveryStartTime = millis();
+        lastNodeAddedTime = millis();
+        initialDiscoveryComplete = false;
+        requestConfig();
+        events.postNotice(NOTICE_SUCCESS, "Connected via WiFi");
+        return;
+    }
+
+    // A closed or reset socket surfaces as an ERROR state from poll()
+    if (transportIs(TRANSPORT_TCP) && tcpTransport.state() == TRANSPORT_ERROR) {
+        onTcpLinkDown("connection lost");
     }
-    return false;
+}
+
+bool MeshtasticClient::connectToDeviceByName(const String& name) {
+    // Find device by name in scanned list and connect
+    String address = scannedAddressFor(name);
+    return !address.isEmpty() && connectToDeviceByAddress(address);
 }
 
 bool MeshtasticClient::connectToDeviceByAddress(const String& address) {
@@ -2776,14 +3158,16 @@ bool MeshtasticClient::connectToDeviceWithPin(const String& name, const String&
 
 void MeshtasticClient::handleRemoteDisconnect() {
     isConnected = false;
+    if (connectionState != CONN_DISCONNECTED) events.postConnectionState(CONN_DISCONNECTED, TRANSPORT_BLE_MESHTASTIC);
     connectionState = CONN_DISCONNECTED;
+    wakeProtocolTask(PROTO_EVT_LINK);
     if (bleClient) {
         // bleClient->disconnect(); // Already disconnected if this is called
         bleClient = nullptr;
     }
 }
 
-void MeshtasticClient::setUARTConfig(uint32_t baud, int txPin, int rxPin, bool applyNow) {
+void MeshtasticClient::setUARTConfig(uint32_t baud, int txPin, int rxPin, bool applyNow, bool detectBaud) {
     // Sanity constraints – keep values inside a safe range for ESP32 GPIOs/baud
     if (baud < 1200 || baud > 2000000) {
         LOG_PRINTF("[UART] Requested baud %lu outside safe range, clamping to default %d\n",
@@ -2814,42 +3198,40 @@ void MeshtasticClient::setUARTConfig(uint32_t baud, int txPin, int rxPin, bool a
     LOG_PRINTF("[UART] Config updated -> baud=%lu TX=GPIO%d RX=GPIO%d (apply=%d)\n",
                (unsigned long)uartBaud, uartTxPin, uartRxPin, applyNow ? 1 : 0);
 
-    bool uartWasActive = (connectionType == "UART" && uartAvailable);
-
-    auto shutdownUART = [this]() {
-#ifdef USE_ESP_IDF_UART
-        uart_driver_delete(UART_NUM_1);
-#else
-        if (uartPort) {
-            uartPort->end();
-        }
-#endif
-        uartAvailable = false;
-        uartInited = false;
-        uartPort = nullptr;
-    };
+    bool uartWasActive = (transportIs(TRANSPORT_UART) && uartAvailable);
 
     if (uartAvailable || uartInited) {
-        shutdownUART();
-        if (connectionType == "UART") {
-            connectionType = "None";
+        if (transportIs(TRANSPORT_UART)) {
+            selectTransport(nullptr);
             isConnected = false;
             deviceConnected = false;
             updateConnectionState(CONN_DISCONNECTED);
         }
-        uartRxBuffer.clear();
+        closeUART();
     }
 
     if (applyNow && uartWasActive) {
         LOG_PRINTLN("[UART] Restarting UART with new settings...");
-        if (!tryInitUART()) {
+        if (!tryInitUART(detectBaud)) {
             LOG_PRINTLN("[UART] Failed to restart UART after config change");
         }
     }
 }
 
 void MeshtasticClient::handleConfigTimeout() {
-    // Check if config request timed out
+    uint32_t now = millis();
+    uint32_t lastActivity = std::max(configSession.lastRequestTime, configSession.lastProgressTime);
+    if (now - lastActivity < CONFIG_STALL_TIMEOUT_MS) return;
+
+    if (configSession.attempts >= CONFIG_MAX_ATTEMPTS) {
+        Serial.printf("[Config] No progress for %lu ms after %u attempts - giving up\n",
+                      (unsigned long)(now - lastActivity), configSession.attempts);
+        finishConfigSession(CFG_FAILED);
+        return;
+    }
+    Serial.printf("[Config] Stalled for %lu ms (%lu frames so far) - re-requesting\n",
+                  (unsigned long)(now - lastActivity), (unsigned long)configSession.frames);
+    if (!sendConfigRequest()) finishConfigSession(CFG_FAILED);
 }
 
 // ==========================================
@@ -2872,9 +3254,7 @@ bool MeshtasticClient::startBleScan() {
 
     if (activeScan) {
         bleUiScanActive = true;
-        scannedDeviceNames.clear();
-        scannedDeviceAddresses.clear();
-        scannedDevicePaired.clear();
+        clearScanList();
         activeScan->start(0, false); // Continuous scan
         return true;
     }
@@ -2892,16 +3272,38 @@ bool MeshtasticClient::isBleScanning() const {
     return activeScan && activeScan->isScanning();
 }
 
-std::vector<String> MeshtasticClient::getScannedDeviceNames() const {
-    return scannedDeviceNames;
+void MeshtasticClient::onScanListChanged() {
+    scanListVersion.fetch_add(1, std::memory_order_relaxed);
+    wakeProtocolTask(PROTO_EVT_LINK);
+}
+
+void MeshtasticClient::clearScanList() {
+    {
+        LinkLock lock(scanListMutex, portMAX_DELAY);
+        scannedDeviceNames.clear();
+        scannedDeviceAddresses.clear();
+        scannedDevicePaired.clear();
+        scannedDeviceAddrTypes.clear();
+    }
+    onScanListChanged();
 }
 
-std::vector<String> MeshtasticClient::getScannedDeviceAddresses() const {
-    return scannedDeviceAddresses;
+String MeshtasticClient::scannedAddressFor(const String &name) const {
+    LinkLock lock(scanListMutex, portMAX_DELAY);
+    for (size_t i = 0; i < scannedDeviceNames.size(); i++) {
+        if (scannedDeviceNames[i] == name) return scannedDeviceAddresses[i];
+    }
+    return String();
 }
 
-std::vector<bool> MeshtasticClient::getScannedDevicePairedStatus() const {
-    return scannedDevicePaired;
+int MeshtasticClient::scannedAddrTypeFor(const String &address) const {
+    LinkLock lock(scanListMutex, portMAX_DELAY);
+    for (size_t i = 0; i < scannedDeviceAddresses.size(); i++) {
+        if (scannedDeviceAddresses[i] == address) {
+            return i < scannedDeviceAddrTypes.size() ? scannedDeviceAddrTypes[i] : BLE_ADDR_PUBLIC;
+        }
+    }
+    return -1;
 }
 
 void MeshtasticClient::logCurrentScanSummary() const {
@@ -2942,7 +3344,7 @@ String MeshtasticClient::formatLastHeard(uint32_t lastHeard) {
 
 bool MeshtasticClient::broadcastMessage(const String& message, uint8_t channel) {
     if (deviceType == DEVICE_MESHCORE) {
-        if (!meshCoreRxChar || !isConnected) {
+        if (!transportIs(TRANSPORT_BLE_MESHCORE) || !isConnected) {
             LOG_PRINTLN("[MeshCore] Cannot broadcast (not connected)");
             return false;
         }
@@ -2968,36 +3370,646 @@ bool MeshtasticClient::broadcastMessage(const String& message, uint8_t channel)
         return sent;
     }
 
-    return sendTextMessage(message, 0xFFFFFFFF); // Legacy broadcast fallback
+    return sendMessage(0xFFFFFFFF, message, channel);
 }
 
 bool MeshtasticClient::sendTraceRoute(uint32_t destId, uint8_t hopLimit) {
-    (void)destId;
-    (void)hopLimit;
     if (deviceType == DEVICE_MESHCORE) {
         LOG_PRINTLN("[TraceRoute] MeshCore does not support trace route requests");
-        if (g_ui) g_ui->showError("Trace Route not supported on MeshCore");
+        events.postNotice(NOTICE_ERROR, "Trace Route not supported on MeshCore");
+        return false;
+    }
+    if (!isConnected) return false;
+
+    int slot = acquireTxSlot();
+    if (slot < 0) {
+        LOG_PRINTLN("[TxQueue] Queue full - trace route rejected");
+        return false;
+    }
+    TxRequest &req = txSlots[slot];
+    req.packetId = esp_random() & 0x7FFFFFFF;
+    req.len = buildTraceRoute(req.frame + STREAM_HEADER_SIZE, MAX_PACKET_SIZE, destId, hopLimit, req.packetId);
+    req.kind = TX_KIND_TRACEROUTE;
+    if (req.len == 0) {
+        releaseTxSlot(slot);
         return false;
     }
-    // Send traceroute packet
+    if (!submitTxSlot(slot)) return false;
+
+    traceRouteWaitingForResponse = true;
+    traceRouteTimeoutStart = millis();
+    LOG_PRINTF("[TraceRoute] Queued to 0x%08X (id=%u, hops=%u)\n", destId, req.packetId, hopLimit);
+    return true;
+}
+
+// ================== Outgoing TX queue ==================
+bool MeshtasticClient::startTxQueue() {
+    if (txTaskHandle) return true;
+    linkMutex = xSemaphoreCreateRecursiveMutex();
+    txFreeSlots = xQueueCreate(TX_QUEUE_DEPTH, sizeof(uint8_t));
+    txPendingSlots = xQueueCreate(TX_QUEUE_DEPTH, sizeof(uint8_t));
+    txResults = xQueueCreate(TX_QUEUE_DEPTH, sizeof(TxResult));
+    if (!linkMutex || !txFreeSlots || !txPendingSlots || !txResults) {
+        Serial.println("[TxQueue] Failed to allocate queues");
+        return false;
+    }
+    for (uint8_t i = 0; i < TX_QUEUE_DEPTH; ++i) xQueueSend(txFreeSlots, &i, 0);
+    BaseType_t ok = xTaskCreatePinnedToCore(TxTask, "mesh_tx", 6144, this, 1, &txTaskHandle, 1 /* APP CPU */);
+    if (ok != pdPASS) {
+        Serial.println("[TxQueue] Failed to start TX task");
+        txTaskHandle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+int MeshtasticClient::acquireTxSlot() {
+    uint8_t slot;
+    if (!txFreeSlots || xQueueReceive(txFreeSlots, &slot, 0) != pdTRUE) return -1;
+    return slot;
+}
+
+bool MeshtasticClient::submitTxSlot(int slot) {
+    uint8_t idx = (uint8_t)slot;
+    if (xQueueSend(txPendingSlots, &idx, 0) == pdTRUE) return true;
+    releaseTxSlot(slot);
     return false;
 }
 
+void MeshtasticClient::releaseTxSlot(int slot) {
+    uint8_t idx = (uint8_t)slot;
+    xQueueSend(txFreeSlots, &idx, 0);
+}
+
+void MeshtasticClient::TxTask(void *param) {
+    MeshtasticClient *self = static_cast<MeshtasticClient *>(param);
+    for (;;) {
+        uint8_t idx;
+        if (xQueueReceive(self->txPendingSlots, &idx, portMAX_DELAY) != pdTRUE) continue;
+        TxRequest &req = self->txSlots[idx];
+
+        // Pace our own packets so back-to-back sends don't pile up airtime on
+        // the radio. This also gives loop() time to count the previous
+        // packet's radio queue slot before the check below.
+        uint32_t since = millis() - self->txLastSendTime;
+        if (self->txLastSendTime && since < TX_PACING_MS) vTaskDelay(pdMS_TO_TICKS(TX_PACING_MS - since));
+
+        // Heartbeats and admin requests are handled by the radio itself; only
+        // mesh packets take a slot in its TX queue
+        bool meshPacket = req.kind == TX_KIND_TEXT || req.kind == TX_KIND_TRACEROUTE;
+        if (meshPacket && self->radioQueueFull()) {
+            uint32_t waitStart = millis();
+            bool full = true;
+            while (full && self->isConnected && millis() - waitStart < RADIO_QUEUE_STALL_MS) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(250));
+                full = self->radioQueueFull();
+            }
+            LOG_PRINTF("[TxQueue] Held id=%u %lu ms for a radio queue slot%s\n", req.packetId,
+                       (unsigned long)(millis() - waitStart), full ? " (gave up waiting)" : "");
+        }
+
+        TxResult result{req.packetId, req.kind, false, 0, false};
+        uint32_t backoff = TX_RETRY_BACKOFF_MS;
+        while (result.attempts < TX_MAX_ATTEMPTS) {
+            result.attempts++;
+            self->txLoad.begin();
+            bool sent = self->isConnected && self->sendFrame(req.frame, req.len);
+            self->txLoad.end();
+            if (sent) {
+                result.ok = true;
+                break;
+            }
+            vTaskDelay(pdMS_TO_TICKS(backoff));
+            backoff *= 2;
+        }
+        self->txLastSendTime = millis();
+        result.radioSlot = result.ok && meshPacket;
+
+        xQueueSend(self->txResults, &result, portMAX_DELAY);
+        xQueueSend(self->txFreeSlots, &idx, portMAX_DELAY);
+        self->wakeProtocolTask(PROTO_EVT_TX_DONE);
+    }
+}
+
+bool MeshtasticClient::startProtocolTask() {
+    if (protoTaskHandle) return true;
+    stateMutex = xSemaphoreCreateRecursiveMutex();
+    commandQueue = xQueueCreate(COMMAND_QUEUE_DEPTH, sizeof(ClientCommand));
+    if (!stateMutex || !commandQueue || !protoEvents) {
+        Serial.println("[Proto] Failed to allocate state lock, command queue or event group");
+        return false;
+    }
+    // Core 0 alongside the BLE/WiFi host tasks; the Arduino loop (UI) and TxTask stay on core 1
+    BaseType_t ok = xTaskCreatePinnedToCore(ProtocolTask, "mesh_proto", 8192, this, 2, &protoTaskHandle, 0 /* PRO CPU */);
+    if (ok != pdPASS) {
+        Serial.println("[Proto] Failed to start protocol task; loop() stays on the UI task");
+        protoTaskHandle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void MeshtasticClient::ProtocolTask(void *param) {
+    MeshtasticClient *self = static_cast<MeshtasticClient *>(param);
+    for (;;) {
+        // Bits are left set for loop() to take, so nothing signalled during a
+        // pass is lost
+        uint32_t waitMs = self->protoTimers.msUntilNext(millis(), PROTO_MAX_SLEEP_MS);
+        if (waitMs) xEventGroupWaitBits(self->protoEvents, PROTO_EVT_ALL, pdFALSE, pdFALSE, pdMS_TO_TICKS(waitMs));
+        self->protoLoad.begin();
+        {
+            LinkLock lock(self->stateMutex, portMAX_DELAY);
+            ClientCommand cmd;
+            while (xQueueReceive(self->commandQueue, &cmd, 0) == pdTRUE) self->runCommand(cmd);
+            self->loop();
+            self->publishSnapshot();
+        }
+        self->protoLoad.end();
+
+        uint32_t now = millis();
+        if (now - self->lastLoadReport >= LOAD_REPORT_MS) {
+            self->lastLoadReport = now;
+            TaskLoad::printAll();
+            StageProfiler::printSummary();
+        }
+        self->protoTimers.arm(PT_LOAD_REPORT, self->lastLoadReport + LOAD_REPORT_MS);
+    }
+}
+
+void MeshtasticClient::wakeProtocolTask(EventBits_t bits) {
+    if (protoEvents) xEventGroupSetBits(protoEvents, bits);
+}
+
+void MeshtasticClient::lockState() {
+    if (stateMutex) xSemaphoreTakeRecursive(stateMutex, portMAX_DELAY);
+}
+
+void MeshtasticClient::unlockState() {
+    if (stateMutex) xSemaphoreGiveRecursive(stateMutex);
+}
+
+void MeshtasticClient::publishSnapshot() {
+    stateWantsFullSpeed.store(configSessionActive() || isUARTSpeedUpgradeActive() || asyncConnectInProgress ||
+                                  rxBacklog || drainSched.rate() >= FULL_SPEED_RX_FPS,
+                              std::memory_order_relaxed);
+
+    const ClientSnapshot &cur = snapshots.latest();
+    uint32_t now = millis();
+    TransportKind link = transport ? transport->kind() : TRANSPORT_NONE;
+    bool linkUp = transport && transport->isUp();
+    // The node list can be a few hundred entries: copy it at most once per
+    // progress repaint while the node DB is downloading
+    bool nodesDue = cur.nodesVersion != nodesVersion &&
+                    (!isNodeSyncInProgress() || now - lastNodesPublish >= NODE_SYNC_REDRAW_MS);
+    bool messagesDue = cur.messagesVersion != messagesVersion;
+    uint32_t scanVersion = scanListVersion.load(std::memory_order_relaxed);
+    bool scanDue = cur.scanListVersion != scanVersion;
+    ClientStatus status = currentStatus();
+    bool stateDue = cur.connectionState != connectionState || cur.connected != isConnected || cur.link != link ||
+                    cur.linkUp != linkUp || cur.deviceType != deviceType || cur.myNodeId != myNodeId ||
+                    cur.nodeSyncInProgress != isNodeSyncInProgress() || cur.nodeSyncCount != getNodeSyncCount() ||
+                    cur.primaryChannelName != primaryChannelName || cur.status != status;
+    if (!nodesDue && !messagesDue && !scanDue && !stateDue && !reportRequested) return;
+
+    ClientSnapshot *next = snapshots.beginWrite();
+    if (!next) return; // The UI still holds the older slot; try again next pass
+    next->version = cur.version + 1;
+    if (nodesDue) {
+        next->nodes = std::make_shared<const std::vector<MeshtasticNode>>(nodeList);
+        next->nodesVersion = nodesVersion;
+        lastNodesPublish = now;
+    } else {
+        next->nodes = cur.nodes;
+        next->nodesVersion = cur.nodesVersion;
+    }
+    if (messagesDue) {
+        next->messages = std::make_shared<const std::vector<MeshtasticMessage>>(messageHistory);
+        next->messagesVersion = messagesVersion;
+    } else {
+        next->messages = cur.messages;
+        next->messagesVersion = cur.messagesVersion;
+    }
+    next->connectionState = connectionState;
+    next->connected = isConnected;
+    next->link = link;
+    next->linkUp = linkUp;
+    next->deviceType = deviceType;
+    next->myNodeId = myNodeId;
+    next->primaryChannelName = primaryChannelName;
+    next->nodeSyncInProgress = isNodeSyncInProgress();
+    next->nodeSyncCount = getNodeSyncCount();
+    next->status = status;
+    if (scanDue) {
+        auto list = std::make_shared<BleScanList>();
+        {
+            LinkLock lock(scanListMutex, portMAX_DELAY);
+            list->names = scannedDeviceNames;
+            list->addresses = scannedDeviceAddresses;
+            list->paired = scannedDevicePaired;
+        }
+        next->scanList = std::move(list);
+        next->scanListVersion = scanVersion;
+    } else {
+        next->scanList = cur.scanList;
+        next->scanListVersion = cur.scanListVersion;
+    }
+    if (reportRequested) {
+        reportRequested = false;
+        auto report = std::make_shared<ClientReport>();
+        report->radioLog = radioLog;
+        {
+            LinkLock lock(linkMutex, portMAX_DELAY);  // TxTask counts its sends
+            report->linkName = getConnectionType();
+            if (transport) {
+                report->haveLink = true;
+                report->linkUp = transport->isUp();
+                report->linkStats = transport->stats();
+            }
+        }
+        report->radioQueueFree = getRadioQueueFree();
+        report->radioQueueMax = getRadioQueueMax();
+        report->radioQueueRejects = radioQueueRejects;
+        report->pendingAcks = pendingAcks.size();
+        report->duplicates = recentPackets.stats();
+        next->report = std::move(report);
+        next->reportVersion = cur.reportVersion + 1;
+    } else {
+        next->report = cur.report;
+        next->reportVersion = cur.reportVersion;
+    }
+    snapshots.publish();
+    // Not every state change comes with an event; let the UI pick this one up
+    events.wake();
+
+    // Let go of superseded lists now rather than two publishes from now,
+    // unless a reader is still on that slot
+    if (ClientSnapshot *old = snapshots.beginWrite()) {
+        old->nodes.reset();
+        old->messages.reset();
+        old->scanList.reset();
+        old->report.reset();
+    }
+}
+
+ClientStatus MeshtasticClient::currentStatus() const {
+    ClientStatus st;
+    st.uartAvailable = uartAvailable;
+    st.tcpConnecting = isTcpConnecting();
+    st.uartUpgradeActive = isUARTSpeedUpgradeActive();
+    st.bleScanning = isBleScanning();
+    st.messageMode = textMessageMode ? MODE_TEXTMSG : messageMode;
+    st.currentChannel = currentChannel;
+    st.brightness = brightness.load(std::memory_order_relaxed);
+    st.screenTimeoutMs = screenTimeoutMs.load(std::memory_order_relaxed);
+    st.uartBaud = uartBaud;
+    st.uartTxPin = uartTxPin;
+    st.uartRxPin = uartRxPin;
+    st.wifiSsid = wifiSsid;
+    st.hasWifiPassword = !wifiPassword.isEmpty();
+    st.tcpHost = tcpHost;
+    st.radioLogLines = radioLog.size();
+    return st;
+}
+
+bool MeshtasticClient::postCommand(ClientCommandType type, uint32_t nodeId, uint8_t arg) {
+    ClientCommand cmd{type, nodeId, arg, 0, {}};
+    return queueCommand(cmd);
+}
+
+bool MeshtasticClient::postValue(ClientCommandType type, uint32_t value) {
+    ClientCommand cmd{type, 0, 0, value, {}};
+    return queueCommand(cmd);
+}
+
+bool MeshtasticClient::postText(ClientCommandType type, const String &text, uint32_t nodeId) {
+    ClientCommand cmd{type, nodeId, 0, 0, {}};
+    if (text.length() > COMMAND_TEXT_MAX) {
+        Serial.printf("[Proto] Command %u text cut to %u chars\n", (unsigned)type, (unsigned)COMMAND_TEXT_MAX);
+    }
+    strlcpy(cmd.text, text.c_str(), sizeof(cmd.text));
+    return queueCommand(cmd);
+}
+
+bool MeshtasticClient::queueCommand(const ClientCommand &cmd) {
+    if (!protoTaskHandle) {
+        // No protocol task: the caller is the one running loop(), and takes
+        // the lock the task would have held
+        lockState();
+        runCommand(cmd);
+        unlockState();
+        return true;
+    }
+    if (xQueueSend(commandQueue, &cmd, 0) != pdTRUE) {
+        Serial.printf("[Proto] Command queue full, dropped command %u\n", (unsigned)cmd.type);
+        return false;
+    }
+    wakeProtocolTask(PROTO_EVT_COMMAND);
+    return true;
+}
+
+uint32_t MeshtasticClient::lightSleepBudgetMs(uint32_t now, int &uartWakePort) {
+    uartWakePort = -1;
+    // Signalled or queued work the protocol task hasn't picked up yet
+    if (!protoEvents || (xEventGroupGetBits(protoEvents) & PROTO_EVT_ALL)) return 0;
+    if (commandQueue && uxQueueMessagesWaiting(commandQueue)) return 0;
+    if (txPendingSlots && uxQueueMessagesWaiting(txPendingSlots)) return 0;
+    if (rxBacklog || asyncConnectInProgress || scanInProgress || bleUiScanActive) return 0;
+    // The BLE controller and WiFi keep their own timing; sleeping through
+    // them drops the connection
+    if (bleClient && bleClient->isConnected()) return 0;
+    if (WiFi.getMode() != WIFI_OFF) return 0;
+    {
+        LinkLock lock(linkMutex, 0);
+        if (!lock.held) return 0;  // TxTask is writing
+        if (transport && transport->kind() != TRANSPORT_UART) return 0;
+        if (uartTransport.isOpen()) {
+            // The bytes that wake the chip from light sleep are lost, and with
+            // a radio on the link that is a FromRadio frame; only a port with
+            // nothing attached yet sleeps and waits for its first byte
+            if (uartAvailable) return 0;
+            if (uartTransport.txBusy() || uartTransport.rxPendingBytes()) return 0;
+            uartWakePort = UartTransport::PORT;
+        }
+    }
+    return protoTimers.msUntilNext(now, PROTO_MAX_SLEEP_MS);
+}
+
+bool MeshtasticClient::wantsFullSpeed() const {
+    if (stateWantsFullSpeed.load(std::memory_order_relaxed)) return true;
+    if (commandQueue && uxQueueMessagesWaiting(commandQueue)) return true;
+    return txPendingSlots && uxQueueMessagesWaiting(txPendingSlots) > 1;
+}
+
+void MeshtasticClient::runCommand(const ClientCommand &cmd) {
+    switch (cmd.type) {
+        case CMD_CONNECT_GROVE:
+            startGroveConnection();
+            break;
+        case CMD_REQUEST_NODES:
+            requestNodeList();
+            break;
+        case CMD_TRACE_ROUTE:
+            sendTraceRoute(cmd.nodeId, cmd.arg);
+            break;
+        case CMD_SEND_TEXT: {
+            String text(cmd.text);
+            bool ok = cmd.nodeId == 0xFFFFFFFF ? broadcastMessage(text, currentChannel) : sendDirectMessage(cmd.nodeId, text);
+            LOG_PRINTF("[Proto] Send to 0x%08X: %s\n", cmd.nodeId, ok ? "queued" : "FAILED");
+            if (!ok) events.postNotice(NOTICE_ERROR, "Send failed");
+            break;
+        }
+        case CMD_MESHCORE_PING:
+            sendMeshCorePing(cmd.nodeId);
+            break;
+        case CMD_CLEAR_HISTORY:
+            clearMessageHistory();
+            break;
+        case CMD_SET_UART_BAUD:
+            setUARTConfig(cmd.value, uartTxPin, uartRxPin);
+            break;
+        case CMD_SET_UART_TX_PIN:
+            setUARTConfig(uartBaud, (int)cmd.value, uartRxPin);
+            break;
+        case CMD_SET_UART_RX_PIN:
+            setUARTConfig(uartBaud, uartTxPin, (int)cmd.value);
+            break;
+        case CMD_UART_SPEED_UPGRADE:
+            if (!requestUARTSpeedUpgrade(cmd.value)) events.postNotice(NOTICE_ERROR, "Upgrade needs Grove protobuf link");
+            break;
+        case CMD_SET_BRIGHTNESS:
+            setBrightness((uint8_t)cmd.value);
+            break;
+        case CMD_SET_SCREEN_TIMEOUT:
+            setScreenTimeout(cmd.value);
+            break;
+        case CMD_SET_MESSAGE_MODE:
+            setMessageMode((int)cmd.value);
+            break;
+        case CMD_SET_TEXT_MODE:
+            setTextMessageMode((int)cmd.value);
+            break;
+        case CMD_SET_WIFI_SSID: {
+            String ssid(cmd.text);
+            // Changing networks invalidates the saved password
+            setWifiCredentials(ssid, ssid == wifiSsid ? wifiPassword : String(""));
+            break;
+        }
+        case CMD_SET_WIFI_PASSWORD:
+            setWifiCredentials(wifiSsid, String(cmd.text));
+            break;
+        case CMD_SET_TCP_HOST:
+            setTcpHost(String(cmd.text));
+            break;
+        case CMD_CONNECT_TCP:
+            if (!startTcpConnection()) events.postNotice(NOTICE_ERROR, "WiFi connection failed");
+            break;
+        case CMD_SET_PREFERENCE:
+            setUserConnectionPreference((int)cmd.value);
+            break;
+        case CMD_DISCONNECT:
+            disconnectFromDevice();
+            break;
+        case CMD_BLE_CONNECT_NAME:
+        case CMD_BLE_CONNECT_ADDRESS: {
+            String target(cmd.text);
+            bool ok = cmd.type == CMD_BLE_CONNECT_NAME ? beginAsyncConnectByName(target)
+                                                       : beginAsyncConnectByAddress(target);
+            if (!ok) events.postNotice(NOTICE_ERROR, "Failed to start connection");
+            break;
+        }
+        case CMD_BLE_SCAN_START:
+            if (isBleScanning()) stopBleScan();
+            if (!startBleScan()) events.postNotice(NOTICE_ERROR, "Failed to start BLE scan");
+            break;
+        case CMD_BLE_SCAN_STOP:
+            stopBleScan();
+            break;
+        case CMD_BLE_CLEAR_PAIRED:
+            clearPairedDevices();
+            break;
+        case CMD_BLE_PIN:
+            if (!waitingForPinInput) {
+                Serial.println("[BLE Auth] PIN entered but no pairing is waiting for one");
+                break;
+            }
+            waitingForPinInput = false;
+            if (bleClient && bleClient->isConnected()) {
+                Serial.printf("[BLE Auth] Injecting PIN %06lu\n", (unsigned long)cmd.value);
+                NimBLEDevice::injectPassKey(bleClient->getConnInfo(), cmd.value);
+                events.postNotice(NOTICE_INFO, "Authenticating...");
+            } else {
+                Serial.println("[BLE Auth] PIN injection failed - BLE client not connected");
+                events.postNotice(NOTICE_ERROR, "Connection lost");
+            }
+            break;
+        case CMD_PRINT_CONFIG:
+            printStartupConfig();
+            break;
+        case CMD_REPORT:
+            reportRequested = true;
+            break;
+    }
+}
+
+void MeshtasticClient::processTxResults() {
+    if (!txResults) return;
+    TxResult r;
+    while (xQueueReceive(txResults, &r, 0) == pdTRUE) {
+        LOG_PRINTF("[TxQueue] id=%u %s after %u attempt(s)\n", r.packetId, r.ok ? "sent" : "FAILED", r.attempts);
+        if (r.radioSlot) {
+            // Count the slot it took until the radio's next QueueStatus says otherwise
+            LinkLock lock(linkMutex, portMAX_DELAY);
+            if (radioQueue.free > 0) radioQueue.free--;
+        }
+        if (r.kind == TX_KIND_HEARTBEAT) continue;
+        if (r.kind == TX_KIND_ADMIN) {
+            if (!r.ok && isUARTSpeedUpgradeActive()) failUARTUpgrade("admin request not sent");
+            continue;
+        }
+        if (r.kind == TX_KIND_TRACEROUTE) {
+            if (!r.ok) {
+                traceRouteWaitingForResponse = false;
+                events.postNotice(NOTICE_ERROR, "Trace route send failed");
+            }
+            continue;
+        }
+        if (r.ok) pendingAcks.markSent(r.packetId, r.attempts, millis());
+        updateMessageStatus(r.packetId, r.ok ? MSG_STATUS_SENT : MSG_STATUS_FAILED);
+        if (!r.ok) events.postNotice(NOTICE_ERROR, "Message send failed");
+    }
+}
+
+bool MeshtasticClient::radioQueueFull() {
+    LinkLock lock(linkMutex, portMAX_DELAY);
+    return radioQueue.known && radioQueue.free == 0;
+}
+
+void MeshtasticClient::onQueueStatus(const ParsedQueueStatus &qs) {
+    bool wasFull;
+    {
+        LinkLock lock(linkMutex, portMAX_DELAY);
+        wasFull = radioQueue.known && radioQueue.free == 0;
+        radioQueue.free = (uint16_t)qs.free;
+        radioQueue.maxlen = (uint16_t)qs.maxlen;
+        radioQueue.updatedMs = millis();
+        radioQueue.known = qs.maxlen > 0;
+    }
+    if (wasFull && qs.free > 0 && txTaskHandle) xTaskNotifyGive(txTaskHandle);
+    LOG_PRINTF("[Queue] Radio TX queue %u/%u free (id=%u res=%d)\n", (unsigned)qs.free, (unsigned)qs.maxlen,
+               qs.meshPacketId, (int)qs.res);
+
+    if (qs.meshPacketId == 0) return;
+    if (qs.accepted()) {
+        // In the radio's queue; no-op unless the TX result hasn't been applied yet
+        updateMessageStatus(qs.meshPacketId, MSG_STATUS_SENT);
+        return;
+    }
+    radioQueueRejects++;
+    if (!pendingAcks.find(qs.meshPacketId)) return;
+    LOG_PRINTF("[Queue] Radio rejected id=%u (res=%d)\n", qs.meshPacketId, (int)qs.res);
+    updateMessageStatus(qs.meshPacketId, MSG_STATUS_FAILED);
+    events.postNotice(NOTICE_ERROR, "Radio rejected message");
+}
+
+void MeshtasticClient::onRoutingAck(const ParsedRoutingAck &ack) {
+    PendingAck *e = pendingAcks.find(ack.packetId);
+    if (!e) return; // Not ours, or already resolved
+
+    if (ack.errorReason == ROUTING_ERROR_NONE) {
+        // For a DM, an ack from anyone but the destination only means a
+        // neighbour rebroadcast it; keep waiting for the real one
+        if (e->toNodeId != 0xFFFFFFFF && ack.from != e->toNodeId) {
+            if (!e->relayed) LOG_PRINTF("[Ack] id=%u relayed by 0x%08X\n", ack.packetId, ack.from);
+            e->relayed = true;
+            return;
+        }
+        updateMessageStatus(ack.packetId, MSG_STATUS_DELIVERED);
+        return;
+    }
+
+    const char *reason = routingErrorName(ack.errorReason);
+    LOG_PRINTF("[Ack] id=%u to 0x%08X failed: %s (from 0x%08X)\n", ack.packetId, e->toNodeId, reason, ack.from);
+    updateMessageStatus(ack.packetId, MSG_STATUS_FAILED, (uint8_t)ack.errorReason);
+    events.postNotice(NOTICE_ERROR, String("Not delivered: ") + reason);
+}
+
 void MeshtasticClient::clearMessageHistory() {
     messageHistory.clear();
+    messagesVersion++;
 }
 
-void MeshtasticClient::drainIncoming(bool processAll, bool fromNotify) {
-    (void)fromNotify;  // Currently unused but retained for future heuristics
+void MeshtasticClient::drainLink(uint32_t now) {
+    // The link's own count of what's waiting, taken before reading
+    size_t pendingFrames = fromNumNotifies.exchange(0, std::memory_order_relaxed);
+    if (transportIs(TRANSPORT_BLE_MESHCORE)) pendingFrames += meshCoreTransport.queuedNotifies();
+    size_t pendingBytes = 0;
+    {
+        LinkLock lock(linkMutex, 0);
+        if (lock.held && transport) pendingBytes = transport->rxPendingBytes();
+        // A different link starts from scratch
+        if (lock.held && transport != drainSchedLink) {
+            drainSched.reset();
+            drainSchedLink = transport;
+        }
+    }
+    size_t budget = drainSched.frameBudget(pendingFrames, pendingBytes);
+
+    // Chunks until the link runs dry, the budget is spent or the time cap
+    // is reached; the rest is left to the backlog poll. Each BLE Meshtastic
+    // frame is a GATT read of its own, so there the cap is checked per frame.
+    size_t chunk = transportIs(TRANSPORT_BLE_MESHTASTIC) ? 1 : DrainScheduler::CHUNK_FRAMES;
+    uint32_t startUs = micros();
+    size_t handled = 0;
+    drainFrameBytes = 0;
+    while (handled < budget) {
+        size_t want = budget - handled;
+        if (want > chunk) want = chunk;
+        rxBacklog = false;
+        size_t got = drainIncoming(want);
+        handled += got;
+        if (got < want) break;
+        if (micros() - startUs >= DrainScheduler::TICK_CAP_US) break;
+    }
+    uint32_t elapsedUs = micros() - startUs;
+    drainSched.record(now, handled, drainFrameBytes, elapsedUs, rxBacklog);
+}
+
+size_t MeshtasticClient::drainIncoming(size_t maxFrames) {
+    std::vector<std::vector<uint8_t>> frames;
+    if (transportIs(TRANSPORT_BLE_MESHCORE)) {
+        // Notifications queued by the BLE host task. They're already in RAM,
+        // but handling them isn't free; the rest stay queued for the next chunk.
+        size_t n = receiveFrames(frames, maxFrames);
+        for (auto &frame : frames) {
+            StageProfiler::Scope prof(STAGE_PARSE);  // Decoded and applied in one go
+            onMeshCoreFrame(frame.data(), frame.size());
+            drainFrameBytes += frame.size();
+        }
+        uint32_t dropped = meshCoreTransport.droppedNotifies();
+        if (dropped != meshCoreDroppedLogged) {
+            LOG_PRINTF("[MeshCore] %lu notification(s) dropped (queue full)\n",
+                       (unsigned long)(dropped - meshCoreDroppedLogged));
+            meshCoreDroppedLogged = dropped;
+        }
+        return n;
+    }
+    size_t n = receiveFrames(frames, maxFrames);
+    serviceDeferredUARTConfig();
 
-    // Historical behavior: processAll=true was the "quick" path used for BLE notify drains
-    int loops = processAll ? 1 : 5;
-    while (loops-- > 0) {
-        auto data = receiveProtobuf();
-        if (data.empty()) break;
+    for (const auto &data : frames) {
+        drainFrameBytes += data.size();
+        // Rebroadcasts and replayed queues can hand us the same packet twice
+        uint32_t pktFrom, pktId;
+        if (peekMeshPacketKey(data, pktFrom, pktId) && recentPackets.seen(pktFrom, pktId, millis())) {
+            LOG_PRINTF("[RX] Duplicate packet id=%u from 0x%08X dropped\n", pktId, pktFrom);
+            continue;
+        }
 
         ParsedFromRadio parsed;
-        if (!parseFromRadio(data, parsed, myNodeId)) {
+        StageProfiler::Scope parse(STAGE_PARSE);
+        bool parsedOk = parseFromRadio(data, parsed, myNodeId);
+        parse.end();
+        if (!parsedOk) {
             static uint32_t s_lastParseFailLog = 0;
             uint32_t now = millis();
             if (now - s_lastParseFailLog > 1000) {
@@ -3007,6 +4019,14 @@ void MeshtasticClient::drainIncoming(bool processAll, bool fromNotify) {
             continue;
         }
 
+        for (const auto &rec : parsed.logRecords) {
+            radioLog.add(millis(), (uint8_t)rec.level, rec.source.c_str(), rec.message.c_str());
+        }
+
+        if (configSessionActive()) {
+            onConfigFrame(parsed);
+        }
+
         if (connectionState == CONN_WAITING_CONFIG) {
             bool sawConfigData = parsed.hasMyInfo || !parsed.channels.empty() ||
                                  parsed.sawConfig || parsed.sawConfigComplete;
@@ -3014,7 +4034,7 @@ void MeshtasticClient::drainIncoming(bool processAll, bool fromNotify) {
                 configReceived = true;
             }
 
-            if (parsed.hasMyInfo || parsed.sawConfigComplete) {
+            if (parsed.hasMyInfo) {
                 Serial.println("[Config] Configuration complete - radio ready");
                 updateConnectionState(CONN_READY);
 
@@ -3031,16 +4051,27 @@ void MeshtasticClient::drainIncoming(bool processAll, bool fromNotify) {
             myNodeId = parsed.myInfo.myNodeNum;
         }
 
-        for (const auto &node : parsed.nodes) {
-            upsertNode(node);
+        if (parsed.hasSerialConfig) {
+            onSerialConfig(parsed);
+        }
+
+        if (!parsed.nodes.empty()) {
+            StageProfiler::Scope prof(STAGE_UPSERT);
+            for (const auto &node : parsed.nodes) {
+                upsertNode(node);
+            }
         }
 
         for (const auto &channel : parsed.channels) {
             updateChannel(channel);
         }
 
+        if (parsed.hasQueueStatus) {
+            onQueueStatus(parsed.queueStatus);
+        }
+
         for (const auto &ack : parsed.acks) {
-            updateMessageStatus(ack.packetId, MSG_STATUS_DELIVERED);
+            onRoutingAck(ack);
         }
 
         for (const auto &text : parsed.texts) {
@@ -3085,14 +4116,13 @@ void MeshtasticClient::drainIncoming(bool processAll, bool fromNotify) {
             Serial.printf("[TraceRoute] Forward hops=%d SNR entries=%d | Return hops=%d SNR entries=%d\n",
                           trace.route.size(), trace.snr.size(), trace.routeBack.size(), trace.snrBack.size());
 
-            if (traceRouteWaitingForResponse) {
+                if (traceRouteWaitingForResponse) {
                 traceRouteWaitingForResponse = false;
-                if (g_ui) {
-                    g_ui->openTraceRouteResult(trace.to, trace.route, trace.snr, trace.routeBack, trace.snrBack);
-                }
+                events.postTraceRoute(trace.to, trace.route, trace.snr, trace.routeBack, trace.snrBack);
             }
         }
     }
+    return n;
 }
 
 // ==========================================
@@ -3109,12 +4139,15 @@ void MeshtasticClient::loadSettings() {
         uartBaud = prefs.getUInt("uartBaud", MESHTASTIC_UART_BAUD);
         uartTxPin = prefs.getInt("uartTx", MESHTASTIC_TXD_PIN);
         uartRxPin = prefs.getInt("uartRx", MESHTASTIC_RXD_PIN);
+        wifiSsid = prefs.getString("wifiSsid", "");
+        wifiPassword = prefs.getString("wifiPass", "");
+        tcpHost = prefs.getString("tcpHost", "");
         prefs.end();
         
         // Apply loaded settings
-        M5.Display.setBrightness(brightness);
-        Serial.printf("[Settings] Loaded: brightness=%d timeout=%d textMode=%d msgMode=%d baud=%lu TX=%d RX=%d\n",
-                      brightness, screenTimeoutMs, textMessageMode ? 1 : 0, messageMode,
+        M5.Display.setBrightness(brightness.load());
+        Serial.printf("[Settings] Loaded: brightness=%d timeout=%lu textMode=%d msgMode=%d baud=%lu TX=%d RX=%d\n",
+                      brightness.load(), (unsigned long)screenTimeoutMs.load(), textMessageMode ? 1 : 0, messageMode,
                       (unsigned long)uartBaud, uartTxPin, uartRxPin);
         if (textMessageMode) {
             messageMode = MODE_TEXTMSG;
@@ -3125,13 +4158,16 @@ void MeshtasticClient::loadSettings() {
 void MeshtasticClient::saveSettings() {
     Preferences prefs;
     if (prefs.begin("meshtastic", false)) {
-        prefs.putUChar("brightness", brightness);
-        prefs.putUInt("timeout", screenTimeoutMs);
+        prefs.putUChar("brightness", brightness.load());
+        prefs.putUInt("timeout", screenTimeoutMs.load());
         prefs.putBool("textMode", textMessageMode);
         prefs.putUChar("msgMode", (uint8_t)messageMode);
         prefs.putUInt("uartBaud", uartBaud);
         prefs.putInt("uartTx", uartTxPin);
         prefs.putInt("uartRx", uartRxPin);
+        prefs.putString("wifiSsid", wifiSsid);
+        prefs.putString("wifiPass", wifiPassword);
+        prefs.putString("tcpHost", tcpHost);
         prefs.end();
         Serial.println("[Settings] Saved");
     }
@@ -3143,17 +4179,23 @@ void MeshtasticClient::printStartupConfig() {
     Serial.printf("  Message Mode: %s\n", getMessageModeString().c_str());
     Serial.printf("  UART Config: Baud=%lu, TX=%d, RX=%d\n", (unsigned long)uartBaud, uartTxPin, uartRxPin);
     Serial.printf("  UART Status: Available=%s, Inited=%s\n", uartAvailable ? "YES" : "NO", uartInited ? "YES" : "NO");
-    Serial.printf("  Brightness: %d\n", brightness);
+    Serial.printf("  TCP Radio: %s:%u via WiFi '%s'\n", tcpHost.isEmpty() ? "(unset)" : tcpHost.c_str(),
+                  (unsigned)MESHTASTIC_TCP_PORT, wifiSsid.c_str());
+    Serial.printf("  Brightness: %d\n", brightness.load());
     Serial.printf("  Screen Timeout: %s\n", getScreenTimeoutString().c_str());
     Serial.printf("  Text Message Mode: %s\n", textMessageMode ? "Enabled" : "Disabled");
 }
 
-void MeshtasticClient::addMessageToHistory(const MeshtasticMessage &msg) {
+void MeshtasticClient::addMessageToHistory(const MeshtasticMessage &msg, uint8_t eventFlags) {
     messageHistory.push_back(msg);
+    uint32_t seq = nextHistorySeq++;
+    messageHistory.back().historySeq = seq;
     // Limit history size to prevent memory issues
     if (messageHistory.size() > 100) {
         messageHistory.erase(messageHistory.begin());
     }
+    messagesVersion++;
+    events.postMessageAdded(seq, eventFlags);
 }
 
 
@@ -55,6 +55,47 @@ static const char* getPortName(uint32_t port) {
     }
 }
 
+const char *routingErrorName(uint32_t error) {
+    switch (error) {
+        case ROUTING_ERROR_NONE: return "NONE";
+        case ROUTING_ERROR_NO_ROUTE: return "NO_ROUTE";
+        case ROUTING_ERROR_GOT_NAK: return "GOT_NAK";
+        case ROUTING_ERROR_TIMEOUT: return "TIMEOUT";
+        case ROUTING_ERROR_NO_INTERFACE: return "NO_INTERFACE";
+        case ROUTING_ERROR_MAX_RETRANSMIT: return "MAX_RETRANSMIT";
+        case ROUTING_ERROR_NO_CHANNEL: return "NO_CHANNEL";
+        case ROUTING_ERROR_TOO_LARGE: return "TOO_LARGE";
+        case ROUTING_ERROR_NO_RESPONSE: return "NO_RESPONSE";
+        case ROUTING_ERROR_DUTY_CYCLE_LIMIT: return "DUTY_CYCLE_LIMIT";
+        case ROUTING_ERROR_BAD_REQUEST: return "BAD_REQUEST";
+        case ROUTING_ERROR_NOT_AUTHORIZED: return "NOT_AUTHORIZED";
+        case ROUTING_ERROR_PKI_FAILED: return "PKI_FAILED";
+        case ROUTING_ERROR_PKI_UNKNOWN_PUBKEY: return "PKI_UNKNOWN_PUBKEY";
+        case ROUTING_ERROR_ADMIN_BAD_SESSION_KEY: return "ADMIN_BAD_SESSION_KEY";
+        case ROUTING_ERROR_ADMIN_PUBLIC_KEY_UNAUTHORIZED: return "ADMIN_PUBLIC_KEY_UNAUTHORIZED";
+        case ROUTING_ERROR_RATE_LIMIT_EXCEEDED: return "RATE_LIMIT_EXCEEDED";
+        default: return "UNKNOWN";
+    }
+}
+
+// Routing.error_reason (3), present only on acks and naks; -1 if absent
+static int64_t parseRoutingErrorReason(const std::vector<uint8_t> &buf) {
+    using namespace mini_pb;
+    Reader r(buf);
+    while (!r.eof()) {
+        uint32_t field;
+        WT wt;
+        if (!r.get_tag(field, wt)) break;
+        if (field == 3 && wt == VARINT) {
+            uint64_t v;
+            if (!r.get_varint(v)) break;
+            return (int64_t)(uint32_t)v;
+        }
+        r.skip(wt);
+    }
+    return -1;
+}
+
 static bool parseUserInfo(const std::vector<uint8_t> &buf, ParsedUserInfo &user) {
     using namespace mini_pb;
     Reader r(buf);
@@ -248,6 +289,125 @@ static bool parseChannelMsg(const std::vector<uint8_t> &buf, ParsedChannelInfo &
     return true;
 }
 
+// ModuleConfig.SerialConfig
+static bool parseSerialConfigMsg(const std::vector<uint8_t> &buf, ParsedSerialConfig &cfg) {
+    using namespace mini_pb;
+    Reader r(buf);
+    while (!r.eof()) {
+        uint32_t field;
+        WT wt;
+        if (!r.get_tag(field, wt)) break;
+        if (wt != VARINT) {
+            r.skip(wt);
+            continue;
+        }
+        uint64_t v;
+        if (!r.get_varint(v)) break;
+        switch (field) {
+            case 1: cfg.enabled = v != 0; break;
+            case 2: cfg.echo = v != 0; break;
+            case 3: cfg.rxd = static_cast<uint32_t>(v); break;
+            case 4: cfg.txd = static_cast<uint32_t>(v); break;
+            case 5: cfg.baud = static_cast<uint32_t>(v); break;
+            case 6: cfg.timeout = static_cast<uint32_t>(v); break;
+            case 7: cfg.mode = static_cast<uint32_t>(v); break;
+            case 8: cfg.overrideConsole = v != 0; break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+// LogRecord, sent in place of console text when the radio has
+// security.debug_log_api_enabled set
+static bool parseLogRecordMsg(const std::vector<uint8_t> &buf, ParsedLogRecord &rec) {
+    using namespace mini_pb;
+    Reader r(buf);
+    while (!r.eof()) {
+        uint32_t field;
+        WT wt;
+        if (!r.get_tag(field, wt)) break;
+        if (field == 1 && wt == LEN) {
+            std::vector<uint8_t> tmp;
+            if (!r.get_bytes(tmp)) break;
+            rec.message = bytesToString(tmp);
+        } else if (field == 2 && wt == I32) {
+            if (!r.get_fixed32(rec.time)) break;
+        } else if (field == 3 && wt == LEN) {
+            std::vector<uint8_t> tmp;
+            if (!r.get_bytes(tmp)) break;
+            rec.source = bytesToString(tmp);
+        } else if (field == 4 && wt == VARINT) {
+            uint64_t v;
+            if (!r.get_varint(v)) break;
+            rec.level = static_cast<uint32_t>(v);
+        } else {
+            r.skip(wt);
+        }
+    }
+    return rec.message.length() > 0;
+}
+
+// QueueStatus: the radio's TX queue after it handled one of our packets
+static bool parseQueueStatusMsg(const std::vector<uint8_t> &buf, ParsedQueueStatus &qs) {
+    using namespace mini_pb;
+    Reader r(buf);
+    while (!r.eof()) {
+        uint32_t field;
+        WT wt;
+        if (!r.get_tag(field, wt)) break;
+        if (wt != VARINT) {
+            r.skip(wt);
+            continue;
+        }
+        uint64_t v;
+        if (!r.get_varint(v)) break;
+        switch (field) {
+            case 1: qs.res = static_cast<int32_t>(v); break;  // int32: negatives are sign-extended
+            case 2: qs.free = static_cast<uint32_t>(v); break;
+            case 3: qs.maxlen = static_cast<uint32_t>(v); break;
+            case 4: qs.meshPacketId = static_cast<uint32_t>(v); break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+// AdminMessage; only get_module_config_response (8) carrying ModuleConfig.serial (2)
+static bool parseAdminMsg(const std::vector<uint8_t> &buf, ParsedFromRadio &out) {
+    using namespace mini_pb;
+    Reader r(buf);
+    bool found = false;
+    while (!r.eof()) {
+        uint32_t field;
+        WT wt;
+        if (!r.get_tag(field, wt)) break;
+        if (field == 8 && wt == LEN) {
+            std::vector<uint8_t> moduleBuf;
+            if (!r.get_bytes(moduleBuf)) break;
+            Reader mr(moduleBuf);
+            while (!mr.eof()) {
+                uint32_t mf;
+                WT mwt;
+                if (!mr.get_tag(mf, mwt)) break;
+                if (mf == 2 && mwt == LEN) {
+                    std::vector<uint8_t> serialBuf;
+                    if (!mr.get_bytes(serialBuf)) break;
+                    out.serialConfig = ParsedSerialConfig();
+                    found = parseSerialConfigMsg(serialBuf, out.serialConfig);
+                } else {
+                    mr.skip(mwt);
+                }
+            }
+        } else if (field == 101 && wt == LEN) {
+            if (!r.get_bytes(out.adminPasskey)) break;
+        } else {
+            r.skip(wt);
+        }
+    }
+    return found;
+}
+
 namespace mini_pb {
 static void put_varint(std::vector<uint8_t> &out, uint64_t v) {
     while (v >= 0x80) {
@@ -335,6 +495,63 @@ void Reader::skip(WT wt) {
         case I32: idx = (idx + 4 <= len) ? idx + 4 : len; break;
     }
 }
+
+void Writer::put(uint8_t b) {
+    if (pos < cap) {
+        buf[pos++] = b;
+    } else {
+        overflow = true;
+    }
+}
+void Writer::put_varint(uint64_t v) {
+    while (v >= 0x80) {
+        put(uint8_t(v) | 0x80);
+        v >>= 7;
+    }
+    put(uint8_t(v));
+}
+void Writer::varint(uint32_t field, uint64_t v) {
+    put_tag(field, VARINT);
+    put_varint(v);
+}
+void Writer::fixed32(uint32_t field, uint32_t v) {
+    put_tag(field, I32);
+    put(uint8_t(v & 0xFF));
+    put(uint8_t((v >> 8) & 0xFF));
+    put(uint8_t((v >> 16) & 0xFF));
+    put(uint8_t((v >> 24) & 0xFF));
+}
+void Writer::bytes(uint32_t field, const uint8_t *p, size_t n) {
+    put_tag(field, LEN);
+    put_varint(n);
+    if (overflow || n > cap - pos) {
+        overflow = true;
+        return;
+    }
+    if (n) memcpy(buf + pos, p, n);
+    pos += n;
+}
+size_t Writer::begin_message(uint32_t field) {
+    put_tag(field, LEN);
+    size_t mark = pos;
+    for (size_t i = 0; i < kLenBytes; ++i) put(0);
+    return mark;
+}
+void Writer::end_message(size_t mark) {
+    if (overflow) return;
+    size_t len = pos - (mark + kLenBytes);
+    if (len > kMaxNestedLen) {
+        overflow = true;
+        return;
+    }
+    // Padded varint: every byte but the last carries the continuation bit
+    for (size_t i = 0; i < kLenBytes; ++i) {
+        uint8_t b = uint8_t(len & 0x7F);
+        len >>= 7;
+        if (i + 1 < kLenBytes) b |= 0x80;
+        buf[mark + i] = b;
+    }
+}
 } // namespace mini_pb
 
 std::vector<uint8_t> buildWantConfig(uint32_t nonce) {
@@ -353,34 +570,64 @@ std::vector<uint8_t> buildWantConfig(uint32_t nonce) {
     return toradio;
 }
 
-std::vector<uint8_t> buildTextMessage(
-    uint32_t fromNodeId, uint32_t toNodeId, uint8_t channel, const String &text, uint32_t &packetIdOut,
-    bool wantAck
+size_t buildTextMessage(
+    uint8_t *out, size_t cap, uint32_t fromNodeId, uint32_t toNodeId, uint8_t channel, const String &text,
+    uint32_t &packetIdOut, bool wantAck
 ) {
     // Check if this is the problematic 0xFF 0x00 message
     if (text.length() == 2 && (uint8_t)text[0] == 0xFF && (uint8_t)text[1] == 0x00) {
         Serial.println("[ProtocolTx] *** BLOCKING suspicious 0xFF 0x00 message ***");
-        std::vector<uint8_t> empty;
-        return empty; // Return empty vector to block this message
+        return 0; // Return empty to block this message
     }
-                  
-    using namespace mini_pb;
-    std::vector<uint8_t> data;
-    add_varint(data, 1, TEXT_MESSAGE_APP);
-    std::vector<uint8_t> payload(text.length());
-    for (size_t i = 0; i < text.length(); ++i) payload[i] = (uint8_t)text[i];
-    add_bytes(data, 2, payload);
-    std::vector<uint8_t> mesh;
-    if (fromNodeId) add_fixed32(mesh, 1, fromNodeId);
-    add_fixed32(mesh, 2, toNodeId);
-    add_varint(mesh, 3, channel);
-    add_message(mesh, 4, data);
+
     if (packetIdOut == 0) packetIdOut = (uint32_t)millis() ^ ((uint32_t)esp_random() & 0xFFFF);
-    add_fixed32(mesh, 6, packetIdOut);
-    add_varint(mesh, 10, wantAck ? 1 : 0);
-    std::vector<uint8_t> toradio;
-    add_message(toradio, 1, mesh);
-    return toradio;
+
+    mini_pb::Writer w(out, cap);
+    size_t mesh = w.begin_message(1); // ToRadio.packet
+    if (fromNodeId) w.fixed32(1, fromNodeId);
+    w.fixed32(2, toNodeId);
+    w.varint(3, channel);
+    size_t data = w.begin_message(4); // MeshPacket.decoded
+    w.varint(1, TEXT_MESSAGE_APP);
+    w.bytes(2, (const uint8_t *)text.c_str(), text.length());
+    w.end_message(data);
+    w.fixed32(6, packetIdOut);
+    w.varint(10, wantAck ? 1 : 0);
+    w.end_message(mesh);
+    return w.size();
+}
+
+bool peekMeshPacketKey(const std::vector<uint8_t> &raw, uint32_t &from, uint32_t &packetId) {
+    using namespace mini_pb;
+    Reader r(raw);
+    while (!r.eof()) {
+        uint32_t f;
+        WT wt;
+        if (!r.get_tag(f, wt)) return false;
+        if (f != 2 || wt != LEN) {
+            r.skip(wt);
+            continue;
+        }
+        size_t l;
+        if (!r.get_len(l)) return false;
+        Reader mr(r.data + r.idx, l);
+        from = 0;
+        packetId = 0;
+        while (!mr.eof()) {
+            uint32_t mf;
+            WT mwt;
+            if (!mr.get_tag(mf, mwt)) break;
+            if ((mf == 1 || mf == 6) && mwt == I32) {
+                uint32_t v;
+                if (!mr.get_fixed32(v)) break;
+                (mf == 1 ? from : packetId) = v;
+            } else {
+                mr.skip(mwt);
+            }
+        }
+        return true;
+    }
+    return false;
 }
 
 bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint32_t myNodeId) {
@@ -434,6 +681,7 @@ bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint3
                     if (!mr.get_bytes(dataBuf)) break;
                     Reader dr(dataBuf);
                     uint32_t port = 0;
+                    uint32_t requestId = 0;
                     std::vector<uint8_t> payload;
                     while (!dr.eof()) {
                         uint32_t df;
@@ -445,6 +693,8 @@ bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint3
                             port = (uint32_t)v;
                         } else if (df == 2 && dwt == LEN) {
                             dr.get_bytes(payload);
+                        } else if (df == 6 && dwt == I32) {
+                            dr.get_fixed32(requestId);
                         } else dr.skip(dwt);
                     }
                     
@@ -460,12 +710,21 @@ bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint3
                         }
                     }
                     
+                    int64_t routingError = (port == ROUTING_APP && requestId) ? parseRoutingErrorReason(payload) : -1;
                     if (port == TEXT_MESSAGE_APP && !payload.empty()) {
                         String text;
                         text.reserve(payload.size());
                         for (auto b : payload) text += (char)b;
                         pkt.text = text;
                         haveText = true;
+                    } else if (routingError >= 0) {
+                        // Ack (error_reason NONE) or nak for one of our packets
+                        ParsedRoutingAck ack;
+                        ack.packetId = requestId;
+                        ack.from = pkt.from;
+                        ack.errorReason = (uint32_t)routingError;
+                        out.acks.push_back(ack);
+                        any = true;
                     } else if (port == ROUTING_APP && !payload.empty()) {
                         // ROUTING_APP - may contain trace route responses
                         Serial.printf("[%s] Received response from 0x%08X to 0x%08X, payload size=%d\n", 
@@ -748,6 +1007,12 @@ bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint3
                         
                         out.traceRoutes.push_back(trace);
                         any = true;
+                    } else if (port == ADMIN_APP && !payload.empty() && (myNodeId == 0 || pkt.from == myNodeId)) {
+                        // Replies to our own admin requests come from the attached radio
+                        if (parseAdminMsg(payload, out)) {
+                            out.hasSerialConfig = true;
+                            any = true;
+                        }
                     }
                 } else mr.skip(mwt);
             }
@@ -755,27 +1020,20 @@ bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint3
                 out.texts.push_back(pkt);
                 any = true;
             }
-        } else if (f == 11 && wt == LEN) {
-            std::vector<uint8_t> rt;
-            if (!r.get_bytes(rt)) break;
-            Reader rr(rt);
-            ParsedRoutingAck ack;
-            bool found = false;
-            while (!rr.eof()) {
-                uint32_t rf;
-                WT rwt;
-                if (!rr.get_tag(rf, rwt)) break;
-                if (rf == 3 && rwt == VARINT) {
-                    uint64_t v;
-                    rr.get_varint(v);
-                    ack.packetId = (uint32_t)v;
-                    found = true;
-                } else rr.skip(rwt);
-            }
-            if (found) {
-                out.acks.push_back(ack);
+        } else if (f == 6 && wt == LEN) {
+            std::vector<uint8_t> logBuf;
+            if (!r.get_bytes(logBuf)) break;
+            ParsedLogRecord rec;
+            if (parseLogRecordMsg(logBuf, rec)) {
+                out.logRecords.push_back(rec);
                 any = true;
             }
+        } else if (f == 11 && wt == LEN) {
+            std::vector<uint8_t> qsBuf;
+            if (!r.get_bytes(qsBuf)) break;
+            out.queueStatus = ParsedQueueStatus();
+            out.hasQueueStatus = parseQueueStatusMsg(qsBuf, out.queueStatus);
+            any = any || out.hasQueueStatus;
         } else if (f == 3 && wt == LEN) {
             std::vector<uint8_t> tmp;
             if (!r.get_bytes(tmp)) break;
@@ -796,9 +1054,11 @@ bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint3
             out.sawConfig = true;
             r.skip(wt);
         } else if (f == 7 && wt == VARINT) {
-            out.sawConfigComplete = true;
             uint64_t v;
-            r.get_varint(v);
+            if (!r.get_varint(v)) break;
+            out.sawConfigComplete = true;
+            out.configCompleteId = (uint32_t)v;
+            any = true;
         } else if (f == 10 && wt == LEN) {
             std::vector<uint8_t> tmp;
             if (!r.get_bytes(tmp)) break;
@@ -814,31 +1074,112 @@ bool parseFromRadio(const std::vector<uint8_t> &raw, ParsedFromRadio &out, uint3
     return any;
 }
 
-std::vector<uint8_t> buildTraceRoute(uint32_t destinationNodeId, uint8_t hopLimit, uint32_t requestId) {
-    using namespace mini_pb;
+size_t buildTraceRoute(uint8_t *out, size_t cap, uint32_t destinationNodeId, uint8_t hopLimit, uint32_t requestId) {
+    if (requestId == 0) requestId = esp_random();
 
-    // Build RouteDiscovery payload for trace route request
-    std::vector<uint8_t> routePayload;
+    mini_pb::Writer w(out, cap);
+    size_t mesh = w.begin_message(1);         // MeshPacket in ToRadio
+    // Don't set 'from' field - radio will set it automatically
+    w.fixed32(2, destinationNodeId);          // to field
+    w.varint(3, 0);                           // channel (primary channel)
+    size_t data = w.begin_message(4);         // data payload
+    w.varint(1, TRACEROUTE_APP);              // TRACEROUTE_APP port number
     // For trace route request, we should NOT include any route data initially
     // The RouteDiscovery should be empty for requests - intermediate nodes will populate it
-    
-    std::vector<uint8_t> data;
-    add_varint(data, 1, TRACEROUTE_APP); // TRACEROUTE_APP port number
-    add_bytes(data, 2, routePayload); // RouteDiscovery payload (empty for request)
-    add_varint(data, 3, 1); // want_response = true
-    add_fixed32(data, 4, destinationNodeId); // dest field - very important for routing!
+    w.bytes(2, nullptr, 0);
+    w.varint(3, 1);                           // want_response = true
+    w.fixed32(4, destinationNodeId);          // dest field - very important for routing!
+    w.end_message(data);
+    w.fixed32(6, requestId);                  // packet ID
+    w.varint(9, hopLimit);                    // hop_limit - critical for routing
+    w.varint(10, 1);                          // want_ack = true
+    w.end_message(mesh);
+    return w.size();
+}
 
-    std::vector<uint8_t> mesh;
-    // Don't set 'from' field - radio will set it automatically
-    add_fixed32(mesh, 2, destinationNodeId); // to field
-    add_varint(mesh, 3, 0);                   // channel (primary channel)
-    add_message(mesh, 4, data);               // data payload
-    if (requestId == 0) requestId = esp_random();
-    add_fixed32(mesh, 6, requestId);          // packet ID
-    add_varint(mesh, 9, hopLimit);            // hop_limit - critical for routing
-    add_varint(mesh, 10, 1);                  // want_ack = true
+size_t buildHeartbeat(uint8_t *out, size_t cap) {
+    // ToRadio.heartbeat (field 7) is an empty Heartbeat message: it tells the
+    // firmware the client is still there without asking it to send anything
+    mini_pb::Writer w(out, cap);
+    w.bytes(7, nullptr, 0);
+    return w.size();
+}
 
-    std::vector<uint8_t> toradio;
-    add_message(toradio, 1, mesh);  // MeshPacket in ToRadio
-    return toradio;
+uint32_t serialBaudToEnum(uint32_t bitsPerSecond) {
+    switch (bitsPerSecond) {
+        case 9600: return 7;
+        case 19200: return 8;
+        case 38400: return 9;
+        case 57600: return 10;
+        case 115200: return 11;
+        case 230400: return 12;
+        case 460800: return 13;
+        case 576000: return 14;
+        case 921600: return 15;
+        default: return 0;
+    }
+}
+
+uint32_t serialBaudFromEnum(uint32_t baudEnum) {
+    switch (baudEnum) {
+        case 7: return 9600;
+        case 8: return 19200;
+        case 9: return 38400;
+        case 10: return 57600;
+        case 11: return 115200;
+        case 12: return 230400;
+        case 13: return 460800;
+        case 14: return 576000;
+        case 15: return 921600;
+        case 0: return 38400;  // BAUD_DEFAULT: the serial module falls back to 38400
+        default: return 0;
+    }
+}
+
+// Wraps an encoded AdminMessage in a MeshPacket addressed to the attached radio
+static size_t buildAdminPacket(
+    uint8_t *out, size_t cap, uint32_t myNodeId, const uint8_t *admin, size_t adminLen, uint32_t packetId
+) {
+    mini_pb::Writer w(out, cap);
+    size_t mesh = w.begin_message(1);         // MeshPacket in ToRadio
+    w.fixed32(2, myNodeId);                   // to: local node
+    size_t data = w.begin_message(4);         // decoded
+    w.varint(1, ADMIN_APP);
+    w.bytes(2, admin, adminLen);
+    w.varint(3, 1);                           // want_response
+    w.end_message(data);
+    w.fixed32(6, packetId);
+    w.end_message(mesh);
+    return w.size();
+}
+
+size_t buildGetSerialConfig(uint8_t *out, size_t cap, uint32_t myNodeId, uint32_t packetId) {
+    uint8_t admin[8];
+    mini_pb::Writer a(admin, sizeof(admin));
+    a.varint(7, 1);                           // get_module_config_request = SERIAL_CONFIG
+    if (!a.ok()) return 0;
+    return buildAdminPacket(out, cap, myNodeId, a.data(), a.size(), packetId);
+}
+
+size_t buildSetSerialConfig(
+    uint8_t *out, size_t cap, uint32_t myNodeId, const ParsedSerialConfig &cfg,
+    const std::vector<uint8_t> &passkey, uint32_t packetId
+) {
+    uint8_t admin[96];
+    mini_pb::Writer a(admin, sizeof(admin));
+    size_t module = a.begin_message(35);      // set_module_config
+    size_t serial = a.begin_message(2);       // ModuleConfig.serial
+    a.varint(1, cfg.enabled ? 1 : 0);
+    a.varint(2, cfg.echo ? 1 : 0);
+    a.varint(3, cfg.rxd);
+    a.varint(4, cfg.txd);
+    a.varint(5, cfg.baud);
+    a.varint(6, cfg.timeout);
+    a.varint(7, cfg.mode);
+    a.varint(8, cfg.overrideConsole ? 1 : 0);
+    a.end_message(serial);
+    a.end_message(module);
+    if (!passkey.empty()) a.bytes(101, passkey.data(), passkey.size());
+    if (!a.ok()) return 0;
+    return buildAdminPacket(out, cap, myNodeId, a.data(), a.size(), packetId);
 }
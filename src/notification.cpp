@@ -104,6 +104,26 @@ void NotificationManager::playNotification(bool isBroadcast) {
     }
 }
 
+void NotificationManager::service() {
+    bool direct = false;
+    bool broadcast = false;
+    ClientEvent e;
+    while (events.next(e)) {
+        if (e.type != EVT_MESSAGE_ADDED || !(e.message.flags & MSG_EVENT_ALERT)) continue;
+        if (e.message.flags & MSG_EVENT_BROADCAST) {
+            broadcast = true;
+        } else {
+            direct = true;
+        }
+    }
+    events.takeMissed();
+    if (direct) {
+        playNotification(false);
+    } else if (broadcast) {
+        playNotification(true);
+    }
+}
+
 void NotificationManager::stopRingtone() {
     if (!speakerAvailable) {
         return;
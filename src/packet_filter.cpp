@@ -0,0 +1,31 @@
+#include "packet_filter.h"
+
+bool RecentPacketFilter::seen(uint32_t from, uint32_t packetId, uint32_t nowMs) {
+    if (packetId == 0) return false; // Unnumbered packets can't be told apart
+    st.lookups++;
+    size_t base = slotFor(from, packetId);
+    Entry *victim = nullptr;
+    uint32_t victimAge = 0;
+    for (size_t n = 0; n < PROBE; ++n) {
+        Entry &e = slots[(base + n) & (CAPACITY - 1)];
+        // Empty slots rank above everything, then expired ones, then the oldest
+        uint32_t age = e.packetId ? nowMs - e.seenMs : UINT32_MAX;
+        if (e.packetId == packetId && e.from == from && age < MAX_AGE_MS) {
+            st.hits++;
+            return true;
+        }
+        if (!victim || age > victimAge) {
+            victim = &e;
+            victimAge = age;
+        }
+    }
+    if (victimAge < MAX_AGE_MS) st.evictions++;
+    victim->from = from;
+    victim->packetId = packetId;
+    victim->seenMs = nowMs;
+    return false;
+}
+
+void RecentPacketFilter::clear() {
+    for (auto &e : slots) e = Entry();
+}
@@ -0,0 +1,130 @@
+#include "pending_ack.h"
+
+int PendingAckTable::indexOf(uint32_t packetId) const {
+    if (packetId == 0) return -1;
+    size_t i = slotFor(packetId);
+    for (size_t n = 0; n < CAPACITY; ++n) {
+        if (slots[i].packetId == 0) return -1;
+        if (slots[i].packetId == packetId) return (int)i;
+        i = (i + 1) & (CAPACITY - 1);
+    }
+    return -1;
+}
+
+bool PendingAckTable::track(uint32_t packetId, uint32_t toNodeId, uint32_t historySeq, uint32_t nowMs) {
+    if (packetId == 0) return false;
+    // Keep one slot free so probing always terminates at an empty slot
+    if (count >= CAPACITY - 1 && indexOf(packetId) < 0) return false;
+    size_t i = slotFor(packetId);
+    while (slots[i].packetId != 0 && slots[i].packetId != packetId) i = (i + 1) & (CAPACITY - 1);
+    if (slots[i].packetId == 0) count++;
+    PendingAck &e = slots[i];
+    e.packetId = packetId;
+    e.toNodeId = toNodeId;
+    e.historySeq = historySeq;
+    e.sentMs = nowMs;
+    e.retries = 0;
+    e.sent = false;
+    e.relayed = false;
+    return true;
+}
+
+PendingAck *PendingAckTable::find(uint32_t packetId) {
+    int i = indexOf(packetId);
+    return i < 0 ? nullptr : &slots[i];
+}
+
+void PendingAckTable::markSent(uint32_t packetId, uint8_t attempts, uint32_t nowMs) {
+    PendingAck *e = find(packetId);
+    if (!e) return;
+    e->sent = true;
+    e->sentMs = nowMs;
+    e->retries = attempts > 0 ? attempts - 1 : 0;
+}
+
+bool PendingAckTable::take(uint32_t packetId, PendingAck &out) {
+    int i = indexOf(packetId);
+    if (i < 0) return false;
+    out = slots[i];
+    removeAt((size_t)i);
+    return true;
+}
+
+void PendingAckTable::removeAt(size_t i) {
+    // Backward-shift: pull later members of the probe run into the hole
+    size_t hole = i;
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & (CAPACITY - 1);
+        if (slots[j].packetId == 0) break;
+        size_t home = slotFor(slots[j].packetId);
+        // Move j into the hole unless its home lies cyclically in (hole, j]
+        bool homeInRange = (hole <= j) ? (home > hole && home <= j) : (home > hole || home <= j);
+        if (!homeInRange) {
+            slots[hole] = slots[j];
+            hole = j;
+        }
+    }
+    slots[hole] = PendingAck();
+    count--;
+}
+
+size_t PendingAckTable::sweep(uint32_t nowMs, uint32_t timeoutMs, PendingAck *out, size_t maxOut) {
+    size_t n = 0;
+    size_t i = 0;
+    while (i < CAPACITY && n < maxOut) {
+        PendingAck &e = slots[i];
+        if (e.packetId != 0 && e.sent && nowMs - e.sentMs >= timeoutMs) {
+            out[n++] = e;
+            removeAt(i);
+            continue; // A shifted entry may now occupy slot i
+        }
+        ++i;
+    }
+    return n;
+}
+
+void PendingAckTable::clear() {
+    for (auto &e : slots) e = PendingAck();
+    count = 0;
+}
+
+AckRttStats *PendingAckTable::rttSlot(uint32_t nodeId, uint32_t nowMs) {
+    AckRttStats *oldest = &rtt[0];
+    for (auto &r : rtt) {
+        if (r.samples + r.timeouts > 0 && r.nodeId == nodeId) return &r;
+        if (r.updatedMs < oldest->updatedMs || r.samples + r.timeouts == 0) oldest = &r;
+    }
+    // Reuse the least recently updated destination
+    *oldest = AckRttStats();
+    oldest->nodeId = nodeId;
+    oldest->updatedMs = nowMs;
+    return oldest;
+}
+
+void PendingAckTable::recordRtt(uint32_t nodeId, uint32_t rttMs, uint32_t nowMs) {
+    AckRttStats *r = rttSlot(nodeId, nowMs);
+    if (r->samples == 0) {
+        r->minMs = r->maxMs = r->avgMs = rttMs;
+    } else {
+        if (rttMs < r->minMs) r->minMs = rttMs;
+        if (rttMs > r->maxMs) r->maxMs = rttMs;
+        r->avgMs = r->avgMs - r->avgMs / 8 + rttMs / 8;
+    }
+    r->samples++;
+    r->lastMs = rttMs;
+    r->updatedMs = nowMs;
+}
+
+void PendingAckTable::recordTimeout(uint32_t nodeId, uint32_t nowMs) {
+    AckRttStats *r = rttSlot(nodeId, nowMs);
+    r->timeouts++;
+    r->updatedMs = nowMs;
+}
+
+const AckRttStats *PendingAckTable::rttFor(uint32_t nodeId) const {
+    for (const auto &r : rtt) {
+        if (r.samples + r.timeouts > 0 && r.nodeId == nodeId) return &r;
+    }
+    return nullptr;
+}
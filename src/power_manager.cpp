@@ -0,0 +1,125 @@
+#include "power_manager.h"
+#include <M5Cardputer.h>
+#include <Preferences.h>
+#include "driver/gpio.h"
+#include "driver/uart.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+
+PowerManager *g_powerManager = nullptr;
+
+void PowerManager::begin() {
+    loadSettings();
+    resetStats();
+    Serial.printf("[Power] Light sleep when idle: %s\n", sleepEnabled ? "on" : "off");
+}
+
+void PowerManager::setEnabled(bool on) {
+    if (on == sleepEnabled) return;
+    sleepEnabled = on;
+    saveSettings();
+    resetStats();
+}
+
+WakeSource PowerManager::sleep(uint32_t ms, bool uartWake, int uartNum) {
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+    // G0 idles high. Its falling-edge interrupt would fire continuously as a
+    // level wake source, so it is parked until the pin is an edge again.
+    gpio_intr_disable(GPIO_NUM_0);
+    gpio_wakeup_enable(GPIO_NUM_0, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    if (uartWake) {
+        uart_set_wakeup_threshold((uart_port_t)uartNum, UART_WAKE_EDGES);
+        esp_sleep_enable_uart_wakeup(uartNum);
+    }
+
+    uint64_t startUs = esp_timer_get_time();
+    esp_err_t err = esp_light_sleep_start();
+    uint64_t endUs = esp_timer_get_time();
+
+    gpio_wakeup_disable(GPIO_NUM_0);
+    gpio_set_intr_type(GPIO_NUM_0, GPIO_INTR_NEGEDGE);
+    gpio_intr_enable(GPIO_NUM_0);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    if (err != ESP_OK) {
+        // Refused (e.g. a wake source already active); nothing was slept
+        wakeCount[WAKE_OTHER]++;
+        return WAKE_OTHER;
+    }
+
+    WakeSource source;
+    switch (esp_sleep_get_wakeup_cause()) {
+        case ESP_SLEEP_WAKEUP_TIMER: source = WAKE_TIMER; break;
+        case ESP_SLEEP_WAKEUP_UART: source = WAKE_UART; break;
+        case ESP_SLEEP_WAKEUP_GPIO: source = WAKE_BUTTON; break;
+        default: source = WAKE_OTHER; break;
+    }
+    sleepCount++;
+    wakeCount[source]++;
+    sleptUs += endUs - startUs;
+    wakeAtUs = endUs;
+    return source;
+}
+
+void PowerManager::noteProcessed() {
+    if (!wakeAtUs) return;
+    uint64_t us = esp_timer_get_time() - wakeAtUs;
+    wakeAtUs = 0;
+    if (us > (uint64_t)WAKE_SAMPLE_MAX_MS * 1000) return;
+    wakeLatencyLastUs = (uint32_t)us;
+    if (wakeLatencyLastUs > wakeLatencyMaxUs) wakeLatencyMaxUs = wakeLatencyLastUs;
+    wakeLatencyCount++;
+}
+
+void PowerManager::resetStats() {
+    sleepCount = 0;
+    for (auto &n : wakeCount) n = 0;
+    sleptUs = 0;
+    statsStartUs = esp_timer_get_time();
+    statsStartMv = batteryMv();
+    wakeAtUs = 0;
+    wakeLatencyLastUs = 0;
+    wakeLatencyMaxUs = 0;
+    wakeLatencyCount = 0;
+}
+
+uint8_t PowerManager::sleepPercent() const {
+    uint64_t elapsed = esp_timer_get_time() - statsStartUs;
+    return elapsed ? (uint8_t)(sleptUs * 100 / elapsed) : 0;
+}
+
+float PowerManager::estimatedMa() const {
+    uint64_t elapsed = esp_timer_get_time() - statsStartUs;
+    float share = elapsed ? (float)sleptUs / elapsed : 0;
+    return SLEEP_MA * share + ACTIVE_MA * (1 - share);
+}
+
+int16_t PowerManager::batteryMv() const {
+    return M5.Power.getBatteryVoltage();
+}
+
+int32_t PowerManager::batteryMvPerHour() const {
+    // Too noisy to say anything over less than ten minutes
+    uint64_t elapsed = esp_timer_get_time() - statsStartUs;
+    if (elapsed < 600ULL * 1000000 || statsStartMv <= 0) return 0;
+    int16_t mv = batteryMv();
+    if (mv <= 0) return 0;
+    return (int32_t)((int64_t)(mv - statsStartMv) * 3600000000LL / (int64_t)elapsed);
+}
+
+void PowerManager::loadSettings() {
+    Preferences prefs;
+    if (prefs.begin("power", true)) {
+        sleepEnabled = prefs.getBool("lightSleep", false);
+        prefs.end();
+    }
+}
+
+void PowerManager::saveSettings() {
+    Preferences prefs;
+    if (prefs.begin("power", false)) {
+        prefs.putBool("lightSleep", sleepEnabled);
+        prefs.end();
+    }
+}
@@ -0,0 +1,50 @@
+#include "radio_log.h"
+
+void RadioLog::add(uint32_t nowMs, uint8_t level, const char *source, const char *text) {
+    if (!text || !*text) return;
+    RadioLogEntry *e;
+    if (count < CAPACITY) {
+        e = &entries[(start + count) % CAPACITY];
+        count++;
+    } else {
+        e = &entries[start];
+        start = (start + 1) % CAPACITY;
+    }
+    e->ms = nowMs;
+    e->level = level;
+    strlcpy(e->source, source ? source : "", sizeof(e->source));
+    strlcpy(e->text, text, sizeof(e->text));
+    added++;
+}
+
+void RadioLog::clear() {
+    start = 0;
+    count = 0;
+}
+
+uint8_t RadioLog::levelFromConsole(const char *line) {
+    static const struct {
+        const char *tag;
+        uint8_t level;
+    } tags[] = {
+        {"TRACE", RADIO_LOG_TRACE}, {"DEBUG", RADIO_LOG_DEBUG}, {"INFO", RADIO_LOG_INFO},
+        {"WARN", RADIO_LOG_WARNING}, {"ERROR", RADIO_LOG_ERROR}, {"CRIT", RADIO_LOG_CRITICAL},
+    };
+    if (!line) return RADIO_LOG_UNSET;
+    for (const auto &t : tags) {
+        if (strncmp(line, t.tag, strlen(t.tag)) == 0) return t.level;
+    }
+    return RADIO_LOG_UNSET;
+}
+
+const char *RadioLog::levelName(uint8_t level) {
+    switch (level) {
+        case RADIO_LOG_TRACE: return "TRACE";
+        case RADIO_LOG_DEBUG: return "DEBUG";
+        case RADIO_LOG_INFO: return "INFO";
+        case RADIO_LOG_WARNING: return "WARN";
+        case RADIO_LOG_ERROR: return "ERROR";
+        case RADIO_LOG_CRITICAL: return "CRIT";
+        default: return "";
+    }
+}
@@ -0,0 +1,93 @@
+#include "stage_profiler.h"
+#include <string.h>
+
+StageProfiler::Histogram StageProfiler::stages[STAGE_COUNT] = {};
+
+namespace {
+const char *const STAGE_NAMES[STAGE_COUNT] = {"scan", "input", "ui", "lock", "client", "probe", "drain", "parse", "upsert"};
+
+uint8_t bucketFor(uint32_t us) {
+    if (us < 2) return 0;
+    uint8_t b = 31 - __builtin_clz(us);
+    return b < StageProfiler::BUCKETS ? b : StageProfiler::BUCKETS - 1;
+}
+
+// Bucket lower edge as "512us" / "16ms"
+void formatEdge(char *out, size_t cap, uint8_t bucket) {
+    uint32_t us = bucket ? (1u << bucket) : 0;
+    if (us >= 1000) {
+        snprintf(out, cap, "%lums", (unsigned long)(us / 1000));
+    } else {
+        snprintf(out, cap, "%luus", (unsigned long)us);
+    }
+}
+} // namespace
+
+void StageProfiler::record(ProfileStage stage, uint32_t us) {
+    if (stage >= STAGE_COUNT) return;
+    Histogram &h = stages[stage];
+    h.buckets[bucketFor(us)]++;
+    h.count++;
+    if (us > h.maxUs) h.maxUs = us;
+}
+
+void StageProfiler::reset() {
+    memset(stages, 0, sizeof(stages));
+}
+
+const char *StageProfiler::name(ProfileStage stage) {
+    return stage < STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
+
+uint32_t StageProfiler::count(ProfileStage stage) {
+    return stage < STAGE_COUNT ? stages[stage].count : 0;
+}
+
+uint32_t StageProfiler::maxUs(ProfileStage stage) {
+    return stage < STAGE_COUNT ? stages[stage].maxUs : 0;
+}
+
+uint32_t StageProfiler::percentileUs(ProfileStage stage, uint8_t pct) {
+    if (stage >= STAGE_COUNT) return 0;
+    const Histogram &h = stages[stage];
+    if (!h.count) return 0;
+    uint64_t target = ((uint64_t)h.count * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < BUCKETS; b++) {
+        seen += h.buckets[b];
+        if (seen >= target) {
+            uint32_t edge = b + 1 < BUCKETS ? (2u << b) : h.maxUs;
+            return edge < h.maxUs ? edge : h.maxUs;
+        }
+    }
+    return h.maxUs;
+}
+
+void StageProfiler::dump() {
+    Serial.println("[Prof] Stage latency histograms (bucket lower edge: samples)");
+    for (uint8_t s = 0; s < STAGE_COUNT; s++) {
+        const Histogram &h = stages[s];
+        Serial.printf("[Prof] %-6s n=%lu max=%lu us\n", STAGE_NAMES[s], (unsigned long)h.count,
+                      (unsigned long)h.maxUs);
+        if (!h.count) continue;
+        String line = "[Prof]  ";
+        for (uint8_t b = 0; b < BUCKETS; b++) {
+            if (!h.buckets[b]) continue;
+            char edge[12];
+            formatEdge(edge, sizeof(edge), b);
+            line += " " + String(edge) + ":" + String(h.buckets[b]);
+        }
+        Serial.println(line);
+    }
+}
+
+void StageProfiler::printSummary() {
+    String line = "[Prof] p99/max ms:";
+    for (uint8_t s = 0; s < STAGE_COUNT; s++) {
+        ProfileStage stage = (ProfileStage)s;
+        if (!stages[s].count) continue;
+        line += " " + String(STAGE_NAMES[s]) + " " + String(percentileUs(stage, 99) / 1000.0f, 1) + "/" +
+                String(maxUs(stage) / 1000.0f, 1);
+    }
+    Serial.println(line);
+}
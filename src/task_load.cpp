@@ -0,0 +1,48 @@
+#include "task_load.h"
+
+TaskLoad *TaskLoad::registry[TaskLoad::MAX_METERS] = {};
+size_t TaskLoad::registered = 0;
+
+TaskLoad::TaskLoad(const char *name) : taskName(name) {
+    // Meters are created at startup, before the tasks that read them
+    if (registered < MAX_METERS) registry[registered++] = this;
+    windowStart = micros();
+}
+
+void TaskLoad::begin() {
+    busyStart = micros();
+}
+
+void TaskLoad::end() {
+    uint32_t now = micros();
+    uint32_t spent = now - busyStart;
+    busyUs += spent;
+    if (spent > maxUs) maxUs = spent;
+    lastEnd = now;
+    roll(now);
+}
+
+void TaskLoad::roll(uint32_t now) {
+    uint32_t elapsed = now - windowStart;
+    if (elapsed < WINDOW_US) return;
+    uint32_t pct = (uint32_t)((uint64_t)busyUs * 100 / elapsed);
+    lastPercent = (uint8_t)(pct > 100 ? 100 : pct);
+    lastMaxUs = maxUs;
+    windowStart = now;
+    busyUs = 0;
+    maxUs = 0;
+}
+
+uint8_t TaskLoad::percent() const {
+    // A task blocked for a whole window never calls end() to publish a 0
+    if (micros() - lastEnd > 2 * WINDOW_US) return 0;
+    return lastPercent;
+}
+
+void TaskLoad::printAll() {
+    for (size_t i = 0; i < registered; ++i) {
+        const TaskLoad *t = registry[i];
+        Serial.printf("[Load] %-6s %3u%%  max %lu us\n", t->name(), (unsigned)t->percent(),
+                      (unsigned long)t->maxBusyUs());
+    }
+}
@@ -0,0 +1,214 @@
+#include "tcp_transport.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "link_clock.h"
+#include "link_log.h"
+
+namespace {
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;  // A dead peer is reported through errno, not SIGPIPE
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+bool wouldBlock(int err) { return err == EAGAIN || err == EWOULDBLOCK || err == EINPROGRESS; }
+}
+
+bool TcpTransport::isNumericHost(const char *host) {
+    in_addr a;
+    return host && inet_pton(AF_INET, host, &a) == 1;
+}
+
+bool TcpTransport::resolveHost(const char *host, char *ip, size_t ipLen) {
+    if (!host || !*host || !ip || ipLen < INET_ADDRSTRLEN) return false;
+    in_addr a;
+    if (inet_pton(AF_INET, host, &a) != 1) {
+        addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *res = nullptr;
+        if (getaddrinfo(host, nullptr, &hints, &res) != 0 || !res) {
+            LINK_LOGF("[TCP] Cannot resolve %s\n", host);
+            return false;
+        }
+        a = reinterpret_cast<sockaddr_in *>(res->ai_addr)->sin_addr;
+        freeaddrinfo(res);
+    }
+    return inet_ntop(AF_INET, &a, ip, ipLen) != nullptr;
+}
+
+bool TcpTransport::open(const char *host, uint16_t port) {
+    close();
+    failed = false;
+    if (!host || !*host) return false;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        LINK_LOGF("[TCP] %s is not an IPv4 address\n", host);
+        failed = true;
+        return false;
+    }
+
+    sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock < 0) {
+        fail("socket", errno);
+        return false;
+    }
+    int one = 1;
+    // Frames are small and latency-bound; don't let Nagle hold them back
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+    framer.reset();
+    txPending.clear();
+    txPendingOff = 0;
+    connectStart = linkMillis();
+    connecting = true;
+    if (connect(sock, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+        connecting = false;
+    } else if (!wouldBlock(errno)) {
+        fail("connect", errno);
+        return false;
+    }
+    LINK_LOGF("[TCP] Connecting to %s:%u\n", host, (unsigned)port);
+    return true;
+}
+
+void TcpTransport::close() {
+    if (sock >= 0) {
+        ::close(sock);
+        sock = -1;
+    }
+    connecting = false;
+    readErr = 0;
+    framer.reset();
+    txPending.clear();
+    txPendingOff = 0;
+}
+
+void TcpTransport::fail(const char *what, int err) {
+    LINK_LOGF("[TCP] %s failed: %s (%d)\n", what, strerror(err), err);
+    close();
+    failed = true;
+}
+
+TransportState TcpTransport::state() const {
+    if (failed) return TRANSPORT_ERROR;
+    if (sock < 0 || connecting) return TRANSPORT_DOWN;
+    return TRANSPORT_UP;
+}
+
+void TcpTransport::service() {
+    if (sock < 0) return;
+    if (connecting) {
+        fd_set wfds;
+        FD_ZERO(&wfds);
+        FD_SET(sock, &wfds);
+        timeval tv = {0, 0};
+        int r = select(sock + 1, nullptr, &wfds, nullptr, &tv);
+        if (r > 0) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &len);
+            if (err) {
+                fail("connect", err);
+                return;
+            }
+            connecting = false;
+            LINK_LOGF("[TCP] Connected in %lu ms\n", (unsigned long)(linkMillis() - connectStart));
+        } else if (r < 0) {
+            fail("select", errno);
+        } else if (linkMillis() - connectStart > CONNECT_TIMEOUT_MS) {
+            fail("connect", ETIMEDOUT);
+        }
+        return;
+    }
+    flushPending();
+}
+
+bool TcpTransport::flushPending() {
+    while (txPendingOff < txPending.size()) {
+        ssize_t n = ::send(sock, txPending.data() + txPendingOff, txPending.size() - txPendingOff, SEND_FLAGS);
+        if (n > 0) {
+            txPendingOff += n;
+            continue;
+        }
+        if (n < 0 && wouldBlock(errno)) return false;
+        fail("send", n < 0 ? errno : EPIPE);
+        return false;
+    }
+    txPending.clear();
+    txPendingOff = 0;
+    return true;
+}
+
+bool TcpTransport::send(uint8_t *frame, size_t payloadLen) {
+    if (state() != TRANSPORT_UP || !frame || !payloadLen || payloadLen > MAX_PACKET_SIZE) {
+        st.txErrors++;
+        return false;
+    }
+    // The tail of the previous frame has to go first or the stream tears
+    if (!flushPending()) return false;
+
+    StreamFramer::writeHeader(frame, payloadLen);
+    size_t frameLen = STREAM_HEADER_SIZE + payloadLen;
+    ssize_t n = ::send(sock, frame, frameLen, SEND_FLAGS);
+    if (n < 0) {
+        if (wouldBlock(errno)) return false;
+        fail("send", errno);
+        st.txErrors++;
+        return false;
+    }
+    if ((size_t)n < frameLen) txPending.assign(frame + n, frame + frameLen);
+    st.txFrames++;
+    st.txBytes += frameLen;
+    st.lastTxMs = linkMillis();
+    return true;
+}
+
+size_t TcpTransport::poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) {
+    if (state() != TRANSPORT_UP) return 0;
+    uint8_t temp[512];
+    while (!readErr) {
+        ssize_t n = recv(sock, temp, sizeof(temp), 0);
+        if (n > 0) {
+            framer.push(temp, n);
+            st.rxBytes += n;
+            st.lastRxMs = linkMillis();
+            continue;
+        }
+        if (n == 0) {
+            LINK_LOGF("[TCP] Radio closed the connection\n");
+            readErr = ECONNRESET;
+        } else if (!wouldBlock(errno)) {
+            readErr = errno;
+        }
+        break;
+    }
+
+    // Frames that arrived ahead of a close are still good: the socket only
+    // goes once the framer has none left, so a capped read loses nothing
+    size_t count = 0;
+    std::vector<uint8_t> payload;
+    while (count < maxFrames && framer.next(payload)) {
+        out.push_back(std::move(payload));
+        st.rxFrames++;
+        count++;
+    }
+    size_t skipped = framer.takeDiscarded();
+    if (skipped) {
+        st.rxDiscarded += skipped;
+        LINK_LOGF("[TCP] Discarded %u bytes outside framing\n", (unsigned)skipped);
+    }
+    if (readErr && !framer.hasFrame()) fail("recv", readErr);
+    return count;
+}
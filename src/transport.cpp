@@ -0,0 +1,157 @@
+#include "transport.h"
+#include <string.h>
+#include "link_clock.h"
+
+void StreamFramer::push(const uint8_t *data, size_t len) {
+    // Consumed bytes are dropped here, once per read, rather than per frame
+    if (head) {
+        buf.erase(buf.begin(), buf.begin() + head);
+        head = 0;
+    }
+    buf.insert(buf.end(), data, data + len);
+}
+
+bool StreamFramer::next(std::vector<uint8_t> &out) {
+    size_t len;
+    if (!sync(len)) return false;
+    const uint8_t *p = buf.data() + head;
+    out.assign(p + STREAM_HEADER_SIZE, p + STREAM_HEADER_SIZE + len);
+    head += STREAM_HEADER_SIZE + len;
+    if (head == buf.size()) {
+        buf.clear();
+        head = 0;
+    }
+    return true;
+}
+
+bool StreamFramer::hasFrame() {
+    size_t len;
+    return sync(len);
+}
+
+bool StreamFramer::sync(size_t &len) {
+    for (;;) {
+        // Everything ahead of the next START1 is console text or noise
+        const uint8_t *p = buf.data() + head;
+        size_t avail = buf.size() - head;
+        const void *start = avail ? memchr(p, STREAM_START1, avail) : nullptr;
+        size_t skip = start ? (const uint8_t *)start - p : avail;
+        if (skip) {
+            takeText(p, skip);
+            head += skip;
+            avail -= skip;
+        }
+        if (avail == 0) {
+            buf.clear();
+            head = 0;
+            return false;
+        }
+        p = buf.data() + head;
+        if (avail < 2) return false;
+        if (p[1] != STREAM_START2) {
+            head++;
+            discarded++;
+            continue;
+        }
+        if (avail < STREAM_HEADER_SIZE) return false;
+        len = ((size_t)p[2] << 8) | p[3];
+        if (len > MAX_PACKET_SIZE) {
+            // Corrupt header: resync from the byte after START1
+            head++;
+            discarded++;
+            continue;
+        }
+        return avail >= STREAM_HEADER_SIZE + len;
+    }
+}
+
+bool StreamFramer::nextLine(std::string &out) {
+    if (lines.empty()) return false;
+    out = std::move(lines.front());
+    lines.pop_front();
+    return true;
+}
+
+void StreamFramer::reset() {
+    buf.clear();
+    head = 0;
+    line.clear();
+    escState = 0;
+}
+
+void StreamFramer::takeText(const uint8_t *p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint8_t c = p[i];
+        if (escState == 1) {
+            // ESC '[' opens a CSI sequence; any other two-byte escape is dropped whole
+            escState = c == '[' ? 2 : 0;
+            continue;
+        }
+        if (escState == 2) {
+            if (c >= 0x40 && c <= 0x7E) escState = 0;
+            continue;
+        }
+        if (c == 0x1B) {
+            escState = 1;
+        } else if (c == '\n') {
+            endLine();
+        } else if (c == '\r') {
+            // Line endings are CRLF on most firmware builds
+        } else if ((c >= 0x20 && c < 0x7F) || c == '\t') {
+            line.push_back((char)c);
+            if (line.size() >= MAX_LINE) endLine();
+        } else {
+            discarded++;
+        }
+    }
+}
+
+void StreamFramer::endLine() {
+    if (line.empty()) return;
+    if (lines.size() >= MAX_QUEUED_LINES) {
+        lines.pop_front();
+        linesDropped++;
+    }
+    lines.push_back(std::move(line));
+    line.clear();
+}
+
+void StreamFramer::writeHeader(uint8_t *frame, size_t len) {
+    frame[0] = STREAM_START1;
+    frame[1] = STREAM_START2;
+    frame[2] = (uint8_t)(len >> 8);
+    frame[3] = (uint8_t)(len & 0xFF);
+}
+
+bool SimTransport::send(uint8_t *frame, size_t payloadLen) {
+    if (!up || !frame || payloadLen == 0 || payloadLen > MAX_PACKET_SIZE) {
+        st.txErrors++;
+        return false;
+    }
+    if (failSends) {
+        failSends--;
+        st.txErrors++;
+        return false;
+    }
+    sent.emplace_back(frame + STREAM_HEADER_SIZE, frame + STREAM_HEADER_SIZE + payloadLen);
+    st.txBytes += payloadLen;
+    st.txFrames++;
+    st.lastTxMs = linkMillis();
+    return true;
+}
+
+size_t SimTransport::poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) {
+    size_t n = 0;
+    while (up && n < maxFrames && inboundHead < inbound.size()) {
+        st.rxBytes += inbound[inboundHead].size();
+        st.rxFrames++;
+        out.push_back(std::move(inbound[inboundHead++]));
+        n++;
+    }
+    if (inboundHead == inbound.size()) {
+        inbound.clear();
+        inboundHead = 0;
+    }
+    if (n) st.lastRxMs = linkMillis();
+    return n;
+}
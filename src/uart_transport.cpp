@@ -0,0 +1,322 @@
+#include "uart_transport.h"
+#include <driver/uart.h>
+#include <driver/gpio.h>
+
+namespace {
+// Room for a few full frames so uart_write_bytes() only copies and returns
+constexpr int UART_TX_RING_SIZE = 4 * (STREAM_HEADER_SIZE + MAX_PACKET_SIZE);
+// Sized for the faster rates: 921600 baud fills 1 KB in about 11 ms
+constexpr int UART_RX_RING_SIZE = 8 * (STREAM_HEADER_SIZE + MAX_PACKET_SIZE);
+constexpr int UART_EVENT_QUEUE_DEPTH = 16;
+}
+
+bool UartTransport::open(uint32_t baud, int txPin, int rxPin) {
+    if (opened) close();
+    Serial.printf("[UART] Config: baud=%lu, RX=GPIO%d, TX=GPIO%d\n", (unsigned long)baud, rxPin, txPin);
+
+#ifdef USE_ESP_IDF_UART
+    // Use ESP-IDF uart driver (like Bus-Pirate HdUartService)
+    Serial.println("[UART] Using ESP-IDF uart driver");
+
+    // Configure UART parameters
+    uart_config_t uart_config = {
+        .baud_rate = (int)baud,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .rx_flow_ctrl_thresh = 122,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+
+    // Install UART driver
+    // The event queue is only wanted when someone is waiting on RX signals
+    esp_err_t err = uart_driver_install(UART_NUM_1, UART_RX_RING_SIZE, UART_TX_RING_SIZE,
+                                        rxGroup ? UART_EVENT_QUEUE_DEPTH : 0, rxGroup ? &rxEvents : NULL, 0);
+    if (err != ESP_OK) {
+        Serial.printf("[UART] uart_driver_install failed: %d\n", err);
+        return false;
+    }
+
+    // Configure UART parameters
+    err = uart_param_config(UART_NUM_1, &uart_config);
+    if (err != ESP_OK) {
+        Serial.printf("[UART] uart_param_config failed: %d\n", err);
+        uart_driver_delete(UART_NUM_1);
+        return false;
+    }
+
+    // Set UART pins
+    err = uart_set_pin(UART_NUM_1, txPin, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    if (err != ESP_OK) {
+        Serial.printf("[UART] uart_set_pin failed: %d\n", err);
+        uart_driver_delete(UART_NUM_1);
+        return false;
+    }
+
+    // Configure GPIO as input with pullup for RX
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = (1ULL << rxPin);
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    gpio_config(&io_conf);
+
+    Serial.println("[UART] ESP-IDF UART driver installed successfully");
+
+    // Wait for hardware to stabilize
+    delay(200);
+
+    // Clear any junk in both RX and TX buffers
+    uart_flush(UART_NUM_1);
+
+    // Additional cleanup: read and discard any garbage data
+    uint8_t dummy[256];
+    size_t cleared = 0;
+    int len;
+    while ((len = uart_read_bytes(UART_NUM_1, dummy, sizeof(dummy), 10 / portTICK_PERIOD_MS)) > 0) {
+        cleared += len;
+    }
+    if (cleared > 0) {
+        Serial.printf("[UART] Cleared %d bytes of garbage from ESP-IDF buffer\n", cleared);
+    }
+
+    if (rxEvents) {
+        xQueueReset(rxEvents);
+        if (xTaskCreatePinnedToCore(RxEventTask, "uart_evt", 2048, this, 3, &rxEventTask, 0) != pdPASS) {
+            Serial.println("[UART] No RX event task; input will be polled");
+            rxEventTask = nullptr;
+        }
+    }
+#else
+    // Use Arduino Serial1 (original implementation)
+    serialPort = &Serial1;
+    serialPort->end();
+    delay(100);
+
+    Serial.printf("[UART] Calling Serial1.begin(%lu, SERIAL_8N1, %d, %d)\n", (unsigned long)baud, rxPin, txPin);
+
+    // Configure pins BEFORE initializing serial to prevent glitches
+    pinMode(rxPin, INPUT_PULLUP);
+    pinMode(txPin, OUTPUT);
+    digitalWrite(txPin, HIGH);  // Set TX high (idle state) before enabling UART
+    delay(100);  // Longer stabilization time
+
+    serialPort->begin(baud, SERIAL_8N1, rxPin, txPin);
+
+    // Verify Serial1 configuration
+    Serial.printf("[UART] Serial1 initialized: available=%d, baudRate=%d\n", serialPort->available(), serialPort->baudRate());
+    Serial.printf("[UART] GPIO states: RX(GPIO%d)=%d, TX(GPIO%d)=%d\n",
+                  rxPin, digitalRead(rxPin), txPin, digitalRead(txPin));
+
+    // Give it more time to stabilize
+    delay(500);
+
+    if (rxGroup) {
+        serialPort->onReceive([this]() { xEventGroupSetBits(rxGroup, rxBits); });
+    }
+
+    // Flush TX buffer to ensure no garbage is sent
+    serialPort->flush();
+    delay(100); // Extra delay after flush
+
+    // Clear any junk in the RX buffer
+    int cleared = 0;
+    while (serialPort->available()) {
+        serialPort->read();
+        cleared++;
+    }
+    if (cleared > 0) {
+        Serial.printf("[UART] Cleared %d bytes from Arduino Serial1 buffer\n", cleared);
+    }
+#endif
+
+    opened = true;
+    currentBaud = baud;
+    framer.reset();
+    txInFlight = 0;
+    return true;
+}
+
+void UartTransport::close() {
+    if (!opened) return;
+#ifdef USE_ESP_IDF_UART
+    // The task waits on the driver's queue, which goes away with the driver
+    if (rxEventTask) {
+        vTaskDelete(rxEventTask);
+        rxEventTask = nullptr;
+    }
+    uart_driver_delete(UART_NUM_1);
+    rxEvents = nullptr;
+#else
+    if (serialPort) {
+        serialPort->end();
+        serialPort = nullptr;
+    }
+#endif
+    opened = false;
+    framer.reset();
+    txInFlight = 0;
+}
+
+#ifdef USE_ESP_IDF_UART
+void UartTransport::RxEventTask(void *param) {
+    UartTransport *self = static_cast<UartTransport *>(param);
+    uart_event_t event;
+    for (;;) {
+        if (xQueueReceive(self->rxEvents, &event, portMAX_DELAY) != pdTRUE) continue;
+        // Data, and the overflow cases where poll() must read to catch up;
+        // line errors are left to the framer
+        if (event.type == UART_DATA || event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) {
+            xEventGroupSetBits(self->rxGroup, self->rxBits);
+        }
+    }
+}
+#endif
+
+void UartTransport::setBaud(uint32_t baud) {
+    if (!opened) return;
+#ifdef USE_ESP_IDF_UART
+    uart_wait_tx_done(UART_NUM_1, pdMS_TO_TICKS(100));
+    uart_set_baudrate(UART_NUM_1, baud);
+#else
+    serialPort->flush();
+    serialPort->updateBaudRate(baud);
+#endif
+    currentBaud = baud;
+    txInFlight = 0;
+}
+
+void UartTransport::flushInput() {
+    if (!opened) return;
+#ifdef USE_ESP_IDF_UART
+    uart_flush_input(UART_NUM_1);
+#else
+    while (serialPort->available()) serialPort->read();
+#endif
+    framer.reset();
+}
+
+size_t UartTransport::available() const {
+    if (!opened) return 0;
+#ifdef USE_ESP_IDF_UART
+    size_t n = 0;
+    uart_get_buffered_data_len(UART_NUM_1, &n);
+    return n;
+#else
+    return (size_t)serialPort->available();
+#endif
+}
+
+int UartTransport::readRaw(uint8_t *buf, size_t cap, uint32_t timeoutMs) {
+    if (!opened || !buf || !cap) return 0;
+#ifdef USE_ESP_IDF_UART
+    int n = uart_read_bytes(UART_NUM_1, buf, cap, pdMS_TO_TICKS(timeoutMs));
+#else
+    int n = 0;
+    uint32_t start = millis();
+    while (n < (int)cap) {
+        if (serialPort->available()) {
+            buf[n++] = (uint8_t)serialPort->read();
+        } else if (n > 0 || millis() - start >= timeoutMs) {
+            break;
+        } else {
+            delay(1);
+        }
+    }
+#endif
+    if (n > 0) {
+        st.rxBytes += n;
+        st.lastRxMs = millis();
+    }
+    return n < 0 ? 0 : n;
+}
+
+bool UartTransport::send(uint8_t *frame, size_t payloadLen) {
+    if (!opened || !frame || !payloadLen || payloadLen > MAX_PACKET_SIZE) {
+        st.txErrors++;
+        return false;
+    }
+    StreamFramer::writeHeader(frame, payloadLen);
+    size_t frameLen = STREAM_HEADER_SIZE + payloadLen;
+
+    // Never let the driver block us: if the TX ring can't take the whole frame
+    // right now, report busy and let the caller try again later.
+    service();
+#ifdef USE_ESP_IDF_UART
+    if (txInFlight + frameLen > (size_t)UART_TX_RING_SIZE) return false;
+    int written = uart_write_bytes(UART_NUM_1, (const char*)frame, frameLen);
+    if (written != (int)frameLen) {
+        st.txErrors++;
+        return false;
+    }
+#else
+    if (serialPort->availableForWrite() < (int)frameLen) return false;
+    size_t written = serialPort->write(frame, frameLen);
+    if (written != frameLen) {
+        st.txErrors++;
+        return false;
+    }
+#endif
+    if (txInFlight == 0) txStartTime = millis();
+    txInFlight += frameLen;
+    st.txFrames++;
+    st.txBytes += frameLen;
+    st.lastTxMs = millis();
+    return true;
+}
+
+void UartTransport::service() {
+    if (!txInFlight) return;
+#ifdef USE_ESP_IDF_UART
+    // Zero timeout: just asks whether the TX FIFO and ring buffer are empty
+    bool idle = uart_wait_tx_done(UART_NUM_1, 0) == ESP_OK;
+#else
+    // HardwareSerial has no TX-done query; assume 10 bit times per byte
+    bool idle = millis() - txStartTime >= (uint32_t)((uint64_t)txInFlight * 10000 / currentBaud) + 1;
+#endif
+    if (!idle) return;
+    txLastDurationMs = millis() - txStartTime;
+    txInFlight = 0;
+}
+
+void UartTransport::readInput() {
+    uint8_t temp[256];
+    size_t pending;
+    while ((pending = available()) > 0) {
+        int len = readRaw(temp, pending > sizeof(temp) ? sizeof(temp) : pending, 0);
+        if (len <= 0) break;
+        framer.push(temp, len);
+    }
+}
+
+bool UartTransport::frameReady() {
+    if (!opened) return false;
+    readInput();
+    return framer.hasFrame();
+}
+
+size_t UartTransport::poll(std::vector<std::vector<uint8_t>> &out, size_t maxFrames) {
+    if (!opened) return 0;
+    readInput();
+
+    size_t n = 0;
+    std::vector<uint8_t> payload;
+    while (n < maxFrames && framer.next(payload)) {
+        out.push_back(std::move(payload));
+        st.rxFrames++;
+        n++;
+    }
+    size_t skipped = framer.takeDiscarded();
+    if (skipped) {
+        st.rxDiscarded += skipped;
+        // Rate limit this log
+        static uint32_t lastGarbageLog = 0;
+        if (millis() - lastGarbageLog > 1000) {
+            Serial.printf("[UART] Discarded %u bytes of garbage (waiting for 0x%02X)\n", (unsigned)skipped, STREAM_START1);
+            lastGarbageLog = millis();
+        }
+    }
+    return n;
+}
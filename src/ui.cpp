@@ -1,6 +1,9 @@
 #include "ui.h"
 #include "meshtastic_client.h"
 #include "notification.h"
+#include "power_manager.h"
+#include "cpu_governor.h"
+#include "stage_profiler.h"
 #include "hardware_config.h"
 #include <algorithm>
 #include <cstdio>
@@ -28,6 +31,10 @@ constexpr int kMaxVisibleMessages = 8;
 constexpr int kMaxVisibleNodes = 20; // Increase to allow more nodes to be stored
 constexpr uint32_t kStatusDurationMs = 2500;
 const char *kTabTitles[] = {"Messages", "Nodes", "Settings"};
+
+bool bleLinkConnected(const ClientSnapshot &s) {
+	return s.connected && (s.link == TRANSPORT_BLE_MESHTASTIC || s.link == TRANSPORT_BLE_MESHCORE);
+}
 }
 
 MeshtasticUI::MeshtasticUI() {
@@ -86,6 +93,7 @@ void MeshtasticUI::drawSmallText(const String& text, int x, int y) {
 void MeshtasticUI::setClient(MeshtasticClient *c) {
 	client = c;
 	needsRedraw = true;
+	clientEvents = client ? client->eventBus().subscribe() : ClientEventBus::Subscriber();
 	
 	// Set user connection preference based on current UI settings
 	if (client) {
@@ -97,16 +105,250 @@ void MeshtasticUI::setClient(MeshtasticClient *c) {
 			clientPreference = 1; // PREFER_GROVE
 		} else if (currentConnectionType == CONNECTION_BLUETOOTH) {
 			clientPreference = 2; // PREFER_BLUETOOTH  
+		} else if (currentConnectionType == CONNECTION_WIFI) {
+			clientPreference = 3; // PREFER_WIFI
 		} else {
 			clientPreference = 0; // PREFER_AUTO
 		}
 		
-		client->setUserConnectionPreference(clientPreference);
+		client->postValue(MeshtasticClient::CMD_SET_PREFERENCE, clientPreference);
 		Serial.printf("[UI] Set client user preference to: %d (UI type: %d)\n", clientPreference, (int)currentConnectionType);
 		
-		// Attempt auto-connection based on saved preferences
+		// Attempt auto-connection based on saved preferences; begin() has
+		// published, so the first snapshot is there to decide on
+		beginFrame();
 		attemptAutoConnection();
+		endFrame();
+	}
+}
+
+void MeshtasticUI::beginFrame() {
+	if (!client) return;
+	frameSnapshot = client->acquireSnapshot();
+	uint32_t version = frameSnapshot->messagesVersion;
+	if (version != frameMessagesVersion) {
+		frameMessagesVersion = version;
+
+		// Our own sends and clears land in the snapshot a pass later: follow the
+		// conversation if the selection was on its newest message
+		size_t before = filteredValid ? filteredMessages.size() : 0;
+		bool atNewest = messageSelectedIndex >= (int)before - 1;
+		const auto &filtered = getFilteredMessages();
+		if (atNewest && !filtered.empty()) messageSelectedIndex = (int)filtered.size() - 1;
+		if (currentTab == 0 && !isModalActive()) needContentOnlyRedraw = true;
+	}
+	if (frameSnapshot->scanListVersion != frameScanListVersion) {
+		frameScanListVersion = frameSnapshot->scanListVersion;
+		if (modalContext == MODAL_BLE_SCAN) needModalRedraw = true;
+	}
+	if (frameSnapshot->status != frameStatus) {
+		frameStatus = frameSnapshot->status;
+		if (currentTab == 2 && !isModalActive()) needSettingsRedraw = true;
+	}
+	// The report a Radio Log or Diagnostics dialog is waiting on
+	if (reportView != REPORT_NONE && frameSnapshot->reportVersion != reportRequestVersion) {
+		uint8_t view = reportView;
+		reportView = REPORT_NONE;
+		if (modalType == 7 && frameSnapshot->report) {
+			if (view == REPORT_RADIO_LOG) showRadioLog(frameSnapshot->report.get());
+			else showDiagnostics(frameSnapshot->report.get());
+		}
+	}
+	drainClientEvents();
+}
+
+void MeshtasticUI::drainClientEvents() {
+	// Everything posted since the last frame is handled in one go: a burst
+	// ends up as one repaint, one popup and the newest notice
+	bool redraw = clientEvents.takeMissed() > 0 || deferredRedraw;
+	uint32_t alertSeq = deferredAlertSeq, toastSeq = 0;
+	deferredRedraw = false;
+	deferredAlertSeq = 0;
+	// What came in while headless; a pending PIN dialog ends up on top
+	if (haveDeferredTrace) {
+		haveDeferredTrace = false;
+		showTraceRouteEvent(deferredTrace);
+	}
+	if (deferredCloseModal) onUiRequest(UI_REQ_CLOSE_MODAL, nullptr);
+	if (deferredPinEntry) onUiRequest(UI_REQ_BLE_PIN_ENTRY, nullptr);
+	deferredCloseModal = deferredPinEntry = false;
+	bool haveNotice = false;
+	ClientEvent notice;
+	ClientEvent e;
+	while (clientEvents.next(e)) {
+		switch (e.type) {
+			case EVT_NODE_CHANGED:
+				if (e.node.mask & NODE_CHANGE_ADDED) {
+					redraw = true;
+				} else {
+					onNodeChanged(e.node.id, e.node.mask);
+				}
+				break;
+			case EVT_NODE_LIST_CHANGED:
+			case EVT_CONNECTION_STATE_CHANGED:
+				redraw = true;
+				break;
+			case EVT_MESSAGE_ADDED:
+				if (e.message.flags & MSG_EVENT_ALERT) alertSeq = e.message.historySeq;
+				if (e.message.flags & MSG_EVENT_TOAST) toastSeq = e.message.historySeq;
+				break;
+			case EVT_ACK_UPDATED:
+				// Status icons follow the messages version, see beginFrame()
+				break;
+			case EVT_TRACE_ROUTE_RESULT:
+				showTraceRouteEvent(e);
+				break;
+			case EVT_NOTICE:
+				notice = e;
+				haveNotice = true;
+				break;
+			case EVT_UI_REQUEST:
+				onUiRequest(e.request.kind, e.request.text);
+				break;
+		}
+	}
+
+	if (haveNotice) {
+		String text(notice.notice.text);
+		if (notice.notice.level == NOTICE_ERROR) {
+			showError(text);
+		} else if (notice.notice.level == NOTICE_SUCCESS) {
+			showSuccess(text);
+		} else {
+			showMessage(text);
+		}
+	}
+	if (toastSeq && currentTab != 0) {
+		if (const MeshtasticMessage *msg = findMessage(toastSeq)) {
+			showMessage("New: " + msg->content.substring(0, 20) + (msg->content.length() > 20 ? "..." : ""));
+		}
+	}
+	if (alertSeq) {
+		if (const MeshtasticMessage *msg = findMessage(alertSeq)) {
+			// Channel messages only get a preview
+			bool broadcast = msg->toNodeId == 0xFFFFFFFF;
+			openNewMessagePopup(msg->fromName, broadcast ? msg->content.substring(0, 30) : msg->content, msg->snr);
+		}
+	}
+	if (redraw) forceRedraw();
+}
+
+void MeshtasticUI::drainEventsHeadless() {
+	if (clientEvents.takeMissed() > 0) deferredRedraw = true;
+	ClientEvent e;
+	while (clientEvents.next(e)) {
+		switch (e.type) {
+			case EVT_MESSAGE_ADDED:
+				if (e.message.flags & MSG_EVENT_ALERT) deferredAlertSeq = e.message.historySeq;
+				deferredRedraw = true;
+				break;
+			case EVT_TRACE_ROUTE_RESULT:
+				deferredTrace = e;
+				haveDeferredTrace = true;
+				break;
+			case EVT_UI_REQUEST:
+				// Closing a dialog goes by the frame's snapshot, so that waits
+				// for the frame; a close after a PIN request cancels it
+				if (e.request.kind == UI_REQ_CLOSE_MODAL) {
+					deferredCloseModal = true;
+					deferredPinEntry = false;
+				} else if (e.request.kind == UI_REQ_BLE_PIN_ENTRY) {
+					deferredPinEntry = true;
+				} else {
+					onUiRequest(e.request.kind, e.request.text);
+				}
+				break;
+			case EVT_NOTICE:
+				// A status line would be stale by the time anyone sees it
+				break;
+			default:
+				deferredRedraw = true;
+				break;
+		}
+	}
+}
+
+void MeshtasticUI::showTraceRouteEvent(const ClientEvent &e) {
+	const auto &t = e.trace;
+	openTraceRouteResult(t.target, std::vector<uint32_t>(t.route, t.route + t.hops),
+	                     std::vector<float>(t.snr, t.snr + t.snrCount),
+	                     std::vector<uint32_t>(t.routeBack, t.routeBack + t.hopsBack),
+	                     std::vector<float>(t.snrBack, t.snrBack + t.snrBackCount));
+}
+
+void MeshtasticUI::onUiRequest(uint8_t kind, const char *text) {
+	switch (kind) {
+		case UI_REQ_CLOSE_MODAL:
+			if (isModalActive()) closeModal();
+			break;
+		case UI_REQ_BLE_PIN_ENTRY:
+			showPinInputModal();
+			break;
+		case UI_REQ_BLE_TARGET:
+			preferredBluetoothAddress = text;
+			preferredBluetoothDevice = text;
+			break;
+	}
+}
+
+const MeshtasticMessage *MeshtasticUI::findMessage(uint32_t historySeq) const {
+	const auto &history = messages();
+	for (auto it = history.rbegin(); it != history.rend(); ++it) {
+		if (it->historySeq == historySeq) return &*it;
 	}
+	return nullptr;
+}
+
+void MeshtasticUI::endFrame() {
+	frameSnapshot.release();
+}
+
+void MeshtasticUI::copyScanList() {
+	const ClientSnapshot &snap = snapshot();
+	bleScanListVersion = snap.scanListVersion;
+	if (snap.scanList) {
+		bleDeviceNames = snap.scanList->names;
+		bleDeviceAddresses = snap.scanList->addresses;
+		bleDevicePaired = snap.scanList->paired;
+	} else {
+		bleDeviceNames.clear();
+		bleDeviceAddresses.clear();
+		bleDevicePaired.clear();
+	}
+}
+
+const ClientSnapshot &MeshtasticUI::snapshot() const {
+	static const ClientSnapshot none;
+	return frameSnapshot ? *frameSnapshot : none;
+}
+
+const std::vector<MeshtasticNode> &MeshtasticUI::nodes() const {
+	static const std::vector<MeshtasticNode> none;
+	return snapshot().nodes ? *snapshot().nodes : none;
+}
+
+const std::vector<MeshtasticMessage> &MeshtasticUI::messages() const {
+	static const std::vector<MeshtasticMessage> none;
+	return snapshot().messages ? *snapshot().messages : none;
+}
+
+const MeshtasticNode *MeshtasticUI::findNode(uint32_t nodeId) const {
+	for (const auto &node : nodes()) {
+		if (node.nodeId == nodeId) return &node;
+	}
+	return nullptr;
+}
+
+uint32_t MeshtasticUI::myNodeId() const {
+	return snapshot().myNodeId;
+}
+
+uint32_t MeshtasticUI::nodesVersion() const {
+	return snapshot().nodesVersion;
+}
+
+uint32_t MeshtasticUI::messagesVersion() const {
+	return snapshot().messagesVersion;
 }
 
 void MeshtasticUI::handleInput() {
@@ -568,8 +810,8 @@ void MeshtasticUI::handleInput() {
 
 	if (composeShortcut && client) {
 		uint32_t target = activeNodeId;
-		if (target == 0xFFFFFFFF && !client->getNodeList().empty()) {
-			target = client->getNodeList()[0].nodeId;
+		if (target == 0xFFFFFFFF && !nodes().empty()) {
+			target = nodes()[0].nodeId;
 			activeNodeId = target;
 		}
 		openMessageComposer(target);
@@ -626,7 +868,7 @@ void MeshtasticUI::update() {
 	if (!configPrinted && millis() - uiStartTime > 3000 && client) {
 		configPrinted = true;
 		Serial.println("[UI] ========== DELAYED CONFIG PRINT ==========");
-		client->printStartupConfig();
+		client->postCommand(MeshtasticClient::CMD_PRINT_CONFIG);
 		Serial.println("[UI] ========== END DELAYED CONFIG ==========");
 	}
 	
@@ -646,7 +888,7 @@ void MeshtasticUI::update() {
 	// Handle background BLE connection
 	if (bleConnectionPending && client) {
 		// Only check for Grove/UART connection conflict if current connection type is Grove
-		if (currentConnectionType == CONNECTION_GROVE && client->isUARTAvailable()) {
+		if (currentConnectionType == CONNECTION_GROVE && snapshot().status.uartAvailable) {
 			bleConnectionPending = false;
 			bleConnectionAttempted = false;
 			showError("Cannot connect BLE while Grove is active");
@@ -656,7 +898,7 @@ void MeshtasticUI::update() {
 		
 		uint32_t now = millis();
 		// Extend timeout and avoid false timeout if client is already in a post-connect state
-		auto state = client->getConnectionState();
+		auto state = snapshot().connectionState;
 		bool postConnect = (state == CONN_CONNECTED || state == CONN_REQUESTING_CONFIG || state == CONN_WAITING_CONFIG || state == CONN_NODE_DISCOVERY || state == CONN_READY);
 		uint32_t timeoutMs = 25000; // 25s to allow pairing/subscription
 		if (!postConnect && now - bleConnectStartTime > timeoutMs) {
@@ -670,10 +912,11 @@ void MeshtasticUI::update() {
 			bool ok = false;
 			Serial.printf("[UI] Attempting BLE connection to %s...\n", bleConnectTargetDevice.c_str());
 			
+			// Queued: a connect that can't start comes back as an error notice
 			if (!bleConnectTargetDevice.isEmpty()) {
-				ok = client->beginAsyncConnectByName(bleConnectTargetDevice);
+				ok = client->postText(MeshtasticClient::CMD_BLE_CONNECT_NAME, bleConnectTargetDevice);
 			} else if (!bleConnectTargetAddress.isEmpty()) {
-				ok = client->beginAsyncConnectByAddress(bleConnectTargetAddress);
+				ok = client->postText(MeshtasticClient::CMD_BLE_CONNECT_ADDRESS, bleConnectTargetAddress);
 			}
 			
 			if (ok) {
@@ -709,7 +952,7 @@ void MeshtasticUI::update() {
 
 	// Check if background connection completed successfully
 	if (bleConnectionPending && bleConnectionAttempted && client && 
-		client->isDeviceConnected() && client->getConnectionType() == "BLE") {
+		bleLinkConnected(snapshot())) {
 		bleConnectionPending = false;
 		bleConnectionAttempted = false;
 		// Clear any lingering status overlay before showing success
@@ -734,7 +977,7 @@ void MeshtasticUI::update() {
 	// Only run this startup BLE flow when the selected connection type is Bluetooth
 	// AND Auto Connect is not set to Never AND devices weren't just cleared.
 	// Consider "connected" here only for BLE connections to avoid false positives from UART.
-	if (!startupBleScanTried && client && !(client->isDeviceConnected() && client->getConnectionType() == "BLE") &&
+	if (!startupBleScanTried && client && !bleLinkConnected(snapshot()) &&
 	    mainInterfaceStartTime > 0 && currentConnectionType == CONNECTION_BLUETOOTH &&
 	    bleAutoConnectMode != BLE_AUTO_NEVER && !allDevicesCleared) {
 		uint32_t now = millis();
@@ -752,7 +995,7 @@ void MeshtasticUI::update() {
 		// Start scan after message is shown (1s delay for message visibility)
 		if (startupBleScanMessageShown && timeSinceMainInterface > 3000 && startupBleScanStart == 0) {
 			// If Grove/UART is active, skip BLE scan
-			if (client->isUARTAvailable()) {
+			if (snapshot().status.uartAvailable) {
 				Serial.printf("[UI] Grove connection is active, skipping BLE scan\n");
 				startupBleScanTried = true; // Mark as tried to avoid retrying
 				displayInfo("Grove connection active");
@@ -760,7 +1003,7 @@ void MeshtasticUI::update() {
 			}
 			
 			Serial.printf("[UI] Starting BLE scan at %lu ms\n", now);
-			client->startBleScan();
+			client->postCommand(MeshtasticClient::CMD_BLE_SCAN_START);
 			startupBleScanStart = now;
 			// Keep showing search message during scanning
 			// Don't set startupBleScanTried = true yet, wait until we show results
@@ -791,7 +1034,7 @@ void MeshtasticUI::update() {
 	// Check if we should start BLE scan after UART failure (but not during startup scan)
 	// Periodic scan check: only if Auto Connect is not Never and using Bluetooth and devices weren't just cleared.
 	// Consider "connected" here only for BLE connections.
-	if (!bleScanRequested && startupBleScanTried && client && !(client->isDeviceConnected() && client->getConnectionType() == "BLE") && 
+	if (!bleScanRequested && startupBleScanTried && client && !bleLinkConnected(snapshot()) && 
 	    currentConnectionType == CONNECTION_BLUETOOTH &&
 	    bleAutoConnectMode != BLE_AUTO_NEVER && !allDevicesCleared) {
 		static uint32_t lastUartCheckTime = 0;
@@ -806,6 +1049,22 @@ void MeshtasticUI::update() {
 		}
 	}
 
+	if (headless) {
+		// One pending full redraw stands in for all the partial ones
+		if (needImmediateModalRedraw || needModalRedraw || needSettingsRedraw || needContentOnlyRedraw ||
+		    !dirtyNodeRows.empty() || inputDirty || needCursorRepaint) {
+			needsRedraw = true;
+		}
+		needImmediateModalRedraw = false;
+		needModalRedraw = false;
+		needSettingsRedraw = false;
+		needContentOnlyRedraw = false;
+		dirtyNodeRows.clear();
+		inputDirty = false;
+		needCursorRepaint = false;
+		return;
+	}
+
 	// Handle urgent modal redraw (e.g., PIN input dialog)
 	if (needImmediateModalRedraw && isModalActive()) {
 		M5.Lcd.fillScreen(BLACK);
@@ -841,6 +1100,7 @@ void MeshtasticUI::update() {
 		needModalRedraw = false;  // Full redraw includes modal
 		needSettingsRedraw = false;  // Full redraw includes settings
 		needContentOnlyRedraw = false;  // Full redraw includes content
+		dirtyNodeRows.clear();
 	} else if (needContentOnlyRedraw && !isModalActive()) {
 		// Only redraw the content area without header/tabs
 		drawContentOnly();
@@ -853,6 +1113,11 @@ void MeshtasticUI::update() {
 		// Only redraw the settings content area to avoid screen flicker
 		drawSettingsContentOnly();
 		needSettingsRedraw = false;
+	} else if (!dirtyNodeRows.empty() && !isModalActive()) {
+		if (currentTab == 1) {
+			for (uint32_t nodeId : dirtyNodeRows) showNodesTab(nodeId);
+		}
+		dirtyNodeRows.clear();
 	}
 
 	if (isModalActive() && modalType == 4 && needCursorRepaint) {
@@ -871,7 +1136,18 @@ void MeshtasticUI::update() {
 	}
 }
 
+void MeshtasticUI::setHeadless(bool on) {
+	if (on == headless) return;
+	headless = on;
+	// Whatever happened while dark, the panel's contents are out of date
+	if (!on) needsRedraw = true;
+}
+
 void MeshtasticUI::draw() {
+	if (headless) {
+		needsRedraw = true;
+		return;
+	}
 	// Show splash screen if enabled and within duration
 	if (showSplash) {
 		uint32_t now = millis();
@@ -938,6 +1214,8 @@ void MeshtasticUI::drawHeader() {
 		} else {
 			headerText = "To: " + currentDestinationName;
 		}
+	} else if (client && snapshot().nodeSyncInProgress) {
+		headerText = "Syncing nodes " + String(snapshot().nodeSyncCount);
 	} else {
 		headerText = "MeshClient";
 	}
@@ -971,11 +1249,11 @@ void MeshtasticUI::drawHeader() {
 	// Draw connection text based on user preference, not actual connection
 	bool showBluetoothText = (currentConnectionType == CONNECTION_BLUETOOTH);
 	bool showGroveText = (currentConnectionType == CONNECTION_GROVE);
-	bool bleTransportReady = client && client->getConnectionType() == "BLE" && client->hasActiveTransport();
-	bool uartTransportReady = client && (
-		client->isUARTAvailable() ||
-		(client->getConnectionType() == "UART" && client->hasActiveTransport())
-	);
+	bool showTcpText = (currentConnectionType == CONNECTION_WIFI);
+	const ClientSnapshot &snap = snapshot();
+	bool bleTransportReady = bleLinkConnected(snap);
+	bool uartTransportReady = snap.status.uartAvailable || (snap.link == TRANSPORT_UART && snap.connected);
+	bool tcpTransportReady = snap.link == TRANSPORT_TCP && snap.connected;
 	
 	// Draw connection type text (white when connected, brighter grey when not connected, no border)
 	if (showBluetoothText) {
@@ -1005,6 +1283,15 @@ void MeshtasticUI::drawHeader() {
 		M5.Lcd.drawString("UART", centeredX, textCenterY);
 		M5.Lcd.setFont(nullptr);
 	}
+
+	if (showTcpText) {
+		M5.Lcd.setFont(&fonts::DejaVu12);
+		int tcpTextWidth = M5.Lcd.textWidth("TCP");
+		int centeredX = connectionTextX + (connectionTextWidth - tcpTextWidth) / 2;
+		M5.Lcd.setTextColor(tcpTransportReady ? WHITE : GREY);
+		M5.Lcd.drawString("TCP", centeredX, textCenterY);
+		M5.Lcd.setFont(nullptr);
+	}
 	
 	// Reset text color to white
 	M5.Lcd.setTextColor(WHITE);
@@ -1089,18 +1376,17 @@ void MeshtasticUI::showMessagesTab() {
 	
 	// Update current destination name if it's broadcast (to reflect current channel)
 	if (currentDestinationId == 0xFFFFFFFF) {
-		String channelName = client->getPrimaryChannelName();
+		String channelName = snapshot().primaryChannelName;
 		if (channelName.isEmpty()) channelName = "Primary";
 		currentDestinationName = channelName;  // Store channel name only, "To:" prefix added in header
 	}
 	
 	// Auto-focus latest active conversation if Broadcast has no messages
 	if (client) {
-		auto filteredForCurrent = getFilteredMessages();
-		const auto &allMessages = client->getMessageHistory();
-		if (filteredForCurrent.empty() && !allMessages.empty()) {
+		const auto &allMessages = messages();
+		if (getFilteredMessages().empty() && !allMessages.empty()) {
 			const auto &latest = allMessages.back();
-			uint32_t myId = client->getMyNodeId();
+			uint32_t myId = myNodeId();
 			uint32_t prefer = 0xFFFFFFFF;
 			if (latest.toNodeId == 0xFFFFFFFF) {
 				prefer = 0xFFFFFFFF; // keep broadcast
@@ -1112,11 +1398,11 @@ void MeshtasticUI::showMessagesTab() {
 			currentDestinationId = prefer;
 			if (prefer == 0xFFFFFFFF) {
 				// Update broadcast name with current channel
-				String channelName = client ? client->getPrimaryChannelName() : "Primary";
+				String channelName = snapshot().primaryChannelName;
 				if (channelName.isEmpty()) channelName = "Primary";
 				currentDestinationName = channelName;  // Store channel name only
 			} else {
-				const MeshtasticNode *node = client->getNodeById(prefer);
+				const MeshtasticNode *node = findNode(prefer);
 				if (node) {
 					currentDestinationName = node->longName.length() ? node->longName : node->shortName;
 					if (currentDestinationName.isEmpty()) {
@@ -1147,7 +1433,7 @@ void MeshtasticUI::showMessagesTab() {
 	}
 }
 
-void MeshtasticUI::showNodesTab() {
+void MeshtasticUI::showNodesTab(uint32_t onlyNodeId) {
 	int y = HEADER_HEIGHT + 6;
 	M5.Lcd.setTextColor(WHITE);
 
@@ -1157,7 +1443,7 @@ void MeshtasticUI::showNodesTab() {
 	}
 
 	// Text message mode does not support node list functionality
-	if (client->isTextMessageMode()) {
+	if (snapshot().status.messageMode == MODE_TEXTMSG) {
 		drawText("Text message mode:", BORDER_PAD, y);
 		drawText("Only supports broadcast", BORDER_PAD, y + 20);
 		drawText("and receiving messages.", BORDER_PAD, y + 40);
@@ -1167,14 +1453,13 @@ void MeshtasticUI::showNodesTab() {
 		return;
 	}
 
-	const auto &nodes = client->getNodeList();
-	if (nodes.empty()) {
+	if (nodes().empty()) {
 		// Clear area where node list would appear to avoid ghosting
 		M5.Lcd.setFont(&fonts::DejaVu12);
 		M5.Lcd.fillRect(BORDER_PAD - 2, y - 2, M5.Lcd.width() - BORDER_PAD * 2, 40, BLACK);
 		// Show scanning status with more detail
 		drawText("Loading node list...", BORDER_PAD, y);
-		if (client && client->isDeviceConnected()) {
+		if (client && snapshot().connected) {
 			drawText("Connected, waiting for response", BORDER_PAD, y + 18);
 		} else {
 			drawText("Waiting for connection...", BORDER_PAD, y + 18);
@@ -1193,7 +1478,7 @@ void MeshtasticUI::showNodesTab() {
 	int rightColumnWidth = screenWidth - rightColumnX - BORDER_PAD;
 
 	// Draw vertical separator (end above tab bar)
-	M5.Lcd.drawLine(dividerX, y - 4, dividerX, screenHeight - TAB_BAR_HEIGHT, DARKGREY);
+	if (!onlyNodeId) M5.Lcd.drawLine(dividerX, y - 4, dividerX, screenHeight - TAB_BAR_HEIGHT, DARKGREY);
 
 	// Calculate node list display parameters
 	int lineHeight = 16; // Reduce line height from 18 to 16 for more nodes
@@ -1208,9 +1493,8 @@ void MeshtasticUI::showNodesTab() {
 	int nodeY = y;
 	int displayedNodes = min(maxVisibleNodes, totalNodes);
 	
-	// Cache node list for better performance
-	const auto &nodeList = client->getNodeList();
-	const bool meshCoreIds = client && client->getDeviceType() == DEVICE_MESHCORE;
+	const auto &nodeList = nodes();
+	const bool meshCoreIds = snapshot().deviceType == DEVICE_MESHCORE;
 	auto formatId = [&](uint32_t id) -> String {
 		char buf[9];
 		uint8_t width = meshCoreIds ? 8 : 4;
@@ -1232,6 +1516,10 @@ void MeshtasticUI::showNodesTab() {
 		if (i >= visibleNodeIds.size()) break;
 		
 		uint32_t nodeId = visibleNodeIds[i];
+		if (onlyNodeId && nodeId != onlyNodeId) {
+			nodeY += lineHeight;
+			continue;
+		}
 		
 		// Direct lookup in the node list for better performance
 		const MeshtasticNode *node = nullptr;
@@ -1268,7 +1556,7 @@ void MeshtasticUI::showNodesTab() {
 	}
 
 	// Draw scrollbar if needed
-	if (needsScrollbar) {
+	if (needsScrollbar && !onlyNodeId) {
 		int scrollbarX = dividerX - 5;
 		int scrollbarY = y;
 		// Fix scrollbar height to extend to bottom of screen minus tab bar
@@ -1277,7 +1565,8 @@ void MeshtasticUI::showNodesTab() {
 	}
 
 	// Right column: Node details for selected node
-	if (nodeSelectedIndex < visibleNodeIds.size()) {
+	if (nodeSelectedIndex < visibleNodeIds.size() &&
+	    (!onlyNodeId || visibleNodeIds[nodeSelectedIndex] == onlyNodeId)) {
 		uint32_t selectedNodeId = visibleNodeIds[nodeSelectedIndex];
 		
 		// Use the cached node list for better performance
@@ -1313,7 +1602,7 @@ void MeshtasticUI::showNodesTab() {
 			// Last heard
 			if (selectedNode->lastHeard > 0) {
 				uint32_t secondsAgo = (millis() / 1000) - selectedNode->lastHeard;
-				String ago = client->formatLastHeard(secondsAgo);
+				String ago = MeshtasticClient::formatLastHeard(secondsAgo);
 				drawText("Last heard:", rightColumnX, detailY);
 				drawText(ago + " ago", rightColumnX, detailY + 12);
 				detailY += 30;
@@ -1370,19 +1659,19 @@ void MeshtasticUI::showSettingsTab() {
 		switch (key) {
 			case SETTING_ABOUT: line = "About MeshClient"; break;
 			case SETTING_CONNECTION: {
-				line = "Connection: " + String(currentConnectionType == CONNECTION_GROVE ? "Grove" : "Bluetooth");
+				line = "Connection: " + connectionTypeLabel();
 				break;
 			}
 			case SETTING_UART_BAUD: 
 				if (client) {
-					line = "UART Baud: " + String(client->getUARTBaud()); 
+					line = "UART Baud: " + String(snapshot().status.uartBaud); 
 				} else {
 					line = "UART Baud: Unknown";
 				}
 				break;
 			case SETTING_UART_TX: {
 				if (client) {
-					int tx = client->getUARTTxPin();
+					int tx = snapshot().status.uartTxPin;
 					line = "UART TX: " + String(tx) + (tx == 1 ? " (G1)" : "");
 				} else {
 					line = "UART TX: Unknown";
@@ -1391,7 +1680,7 @@ void MeshtasticUI::showSettingsTab() {
 			}
 			case SETTING_UART_RX: {
 				if (client) {
-					int rx = client->getUARTRxPin();
+					int rx = snapshot().status.uartRxPin;
 					line = "UART RX: " + String(rx) + (rx == 2 ? " (G2)" : "");
 				} else {
 					line = "UART RX: Unknown";
@@ -1400,7 +1689,7 @@ void MeshtasticUI::showSettingsTab() {
 			}
 			case SETTING_BRIGHTNESS: {
 				if (client) {
-					int brightness = client->getBrightness();
+					int brightness = snapshot().status.brightness;
 					int percentage = (brightness * 100) / 255;
 					line = "Brightness: " + String(percentage) + "%";
 				} else {
@@ -1410,7 +1699,7 @@ void MeshtasticUI::showSettingsTab() {
 			}
 			case SETTING_MESSAGE_MODE: {
 				if (client) {
-					line = "Message Mode: " + client->getMessageModeString();
+					line = "Message Mode: " + MeshtasticClient::formatMessageMode(snapshot().status.messageMode);
 				} else {
 					line = "Message Mode: Unknown";
 				}
@@ -1418,7 +1707,7 @@ void MeshtasticUI::showSettingsTab() {
 			}
 			case SETTING_SCREEN_TIMEOUT: {
 				if (client) {
-					line = "Screen Timeout: " + client->getScreenTimeoutString();
+					line = "Screen Timeout: " + MeshtasticClient::formatScreenTimeout(snapshot().status.screenTimeoutMs);
 				} else {
 					line = "Screen Timeout: Unknown";
 				}
@@ -1436,6 +1725,36 @@ void MeshtasticUI::showSettingsTab() {
 				line = "Notification Settings";
 				break;
 			}
+			case SETTING_UART_SPEED: {
+				line = snapshot().status.uartUpgradeActive ? "Link Speed: Switching..." : "Link Speed Upgrade";
+				break;
+			}
+			case SETTING_WIFI_SSID: {
+				String ssid = snapshot().status.wifiSsid;
+				line = "WiFi: " + (ssid.isEmpty() ? String("(not set)") : ssid);
+				break;
+			}
+			case SETTING_WIFI_PASSWORD: {
+				line = "WiFi Password: " + String(snapshot().status.hasWifiPassword ? "****" : "(none)");
+				break;
+			}
+			case SETTING_TCP_HOST: {
+				String host = snapshot().status.tcpHost;
+				line = "Radio Host: " + (host.isEmpty() ? String("(not set)") : host);
+				break;
+			}
+			case SETTING_TCP_CONNECT: {
+				line = snapshot().status.tcpConnecting ? "Connecting via WiFi..." : "Connect via WiFi";
+				break;
+			}
+			case SETTING_RADIO_LOG: {
+				line = "Radio Log (" + String((int)snapshot().status.radioLogLines) + ")";
+				break;
+			}
+			case SETTING_DIAGNOSTICS: line = "Diagnostics"; break;
+			case SETTING_POWER_SAVE:
+				line = String("Power Save: ") + (g_powerManager && g_powerManager->enabled() ? "On" : "Off");
+				break;
 			default: 
 				Serial.printf("[UI] Unknown setting key: %d\n", key);
 				line = "Unknown (key=" + String(key) + ")"; 
@@ -1518,16 +1837,16 @@ void MeshtasticUI::drawSettingsContentOnly() {
 		switch (key) {
 			case SETTING_ABOUT: line = "About MeshClient"; break;
 			case SETTING_CONNECTION: {
-				line = "Connection: " + String(currentConnectionType == CONNECTION_GROVE ? "Grove" : "Bluetooth");
+				line = "Connection: " + connectionTypeLabel();
 				break;
 			}
 			case SETTING_UART_BAUD:
-				if (client) { line = "UART Baud: " + String(client->getUARTBaud()); }
+				if (client) { line = "UART Baud: " + String(snapshot().status.uartBaud); }
 				else { line = "UART Baud: Unknown"; }
 				break;
 			case SETTING_UART_TX: {
 				if (client) {
-					int tx = client->getUARTTxPin();
+					int tx = snapshot().status.uartTxPin;
 					line = "UART TX: " + String(tx) + (tx == 1 ? " (G1)" : "");
 				} else {
 					line = "UART TX: Unknown";
@@ -1536,7 +1855,7 @@ void MeshtasticUI::drawSettingsContentOnly() {
 			}
 			case SETTING_UART_RX: {
 				if (client) {
-					int rx = client->getUARTRxPin();
+					int rx = snapshot().status.uartRxPin;
 					line = "UART RX: " + String(rx) + (rx == 2 ? " (G2)" : "");
 				} else {
 					line = "UART RX: Unknown";
@@ -1545,7 +1864,7 @@ void MeshtasticUI::drawSettingsContentOnly() {
 			}
 			case SETTING_BRIGHTNESS: {
 				if (client) {
-					int brightness = client->getBrightness();
+					int brightness = snapshot().status.brightness;
 					int percentage = (brightness * 100) / 255;
 					line = "Brightness: " + String(percentage) + "%";
 				} else {
@@ -1554,12 +1873,12 @@ void MeshtasticUI::drawSettingsContentOnly() {
 				break;
 			}
 			case SETTING_MESSAGE_MODE: {
-				if (client) { line = "Message Mode: " + client->getMessageModeString(); }
+				if (client) { line = "Message Mode: " + MeshtasticClient::formatMessageMode(snapshot().status.messageMode); }
 				else { line = "Message Mode: Unknown"; }
 				break;
 			}
 			case SETTING_SCREEN_TIMEOUT: {
-				if (client) { line = "Screen Timeout: " + client->getScreenTimeoutString(); }
+				if (client) { line = "Screen Timeout: " + MeshtasticClient::formatScreenTimeout(snapshot().status.screenTimeoutMs); }
 				else { line = "Screen Timeout: Unknown"; }
 				break;
 			}
@@ -1575,6 +1894,36 @@ void MeshtasticUI::drawSettingsContentOnly() {
 				line = "Notification Settings";
 				break;
 			}
+			case SETTING_UART_SPEED: {
+				line = snapshot().status.uartUpgradeActive ? "Link Speed: Switching..." : "Link Speed Upgrade";
+				break;
+			}
+			case SETTING_WIFI_SSID: {
+				String ssid = snapshot().status.wifiSsid;
+				line = "WiFi: " + (ssid.isEmpty() ? String("(not set)") : ssid);
+				break;
+			}
+			case SETTING_WIFI_PASSWORD: {
+				line = "WiFi Password: " + String(snapshot().status.hasWifiPassword ? "****" : "(none)");
+				break;
+			}
+			case SETTING_TCP_HOST: {
+				String host = snapshot().status.tcpHost;
+				line = "Radio Host: " + (host.isEmpty() ? String("(not set)") : host);
+				break;
+			}
+			case SETTING_TCP_CONNECT: {
+				line = snapshot().status.tcpConnecting ? "Connecting via WiFi..." : "Connect via WiFi";
+				break;
+			}
+			case SETTING_RADIO_LOG: {
+				line = "Radio Log (" + String((int)snapshot().status.radioLogLines) + ")";
+				break;
+			}
+			case SETTING_DIAGNOSTICS: line = "Diagnostics"; break;
+			case SETTING_POWER_SAVE:
+				line = String("Power Save: ") + (g_powerManager && g_powerManager->enabled() ? "On" : "Off");
+				break;
 			default:
 				Serial.printf("[UI] Unknown setting key (content-only): %d\n", key);
 				line = "Unknown (key=" + String(key) + ")";
@@ -1716,7 +2065,7 @@ void MeshtasticUI::drawModal() {
 		M5.Lcd.setFont(&fonts::DejaVu12);
 		M5.Lcd.setTextColor(WHITE);
 		M5.Lcd.drawString(modalTitle, 8, 6);
-		auto filtered = getFilteredMessages();
+		const auto &filtered = getFilteredMessages();
 		if (!filtered.empty()) {
 			int current = std::clamp(messageSelectedIndex, 0, (int)filtered.size() - 1) + 1;
 			String idx = String(current) + "/" + String(filtered.size());
@@ -1738,13 +2087,13 @@ void MeshtasticUI::drawModal() {
 		return;
 	}
 	
-	// About dialog (modalType=7)
+	// About / Radio Log dialog (modalType=7)
 	if (modalType == 7) {
 		M5.Lcd.fillScreen(BLACK);
 		
 		// Draw title at top
 		M5.Lcd.setTextColor(WHITE);
-		drawText("About MeshClient", 8, 6);
+		drawText(modalTitle, 8, 6);
 		
 		// Draw scrollable About content
 		int contentY = 30;
@@ -1995,27 +2344,18 @@ void MeshtasticUI::drawModalList() {
 		if (client && (now - lastScanUpdate > 1000)) { // Update max once per second
 			lastScanUpdate = now;
 			
-			// Get scan results size first to check if update needed
-			size_t currentSize = client->getScannedDeviceNames().size();
-			bool needsUpdate = (currentSize != bleDeviceNames.size());
+			// The scan list version says whether anything was found since the last copy
+			bool needsUpdate = snapshot().scanListVersion != bleScanListVersion;
 			
 			if (needsUpdate) {
-				// Clear old data first to prevent memory leaks
-				bleDeviceNames.clear();
-				bleDeviceAddresses.clear();
-				bleDevicePaired.clear();
 				bleDisplayIndices.clear();
 				modalItems.clear();
-				
-				// Copy new data safely
-				bleDeviceNames = client->getScannedDeviceNames();
-				bleDeviceAddresses = client->getScannedDeviceAddresses();
-				bleDevicePaired = client->getScannedDevicePairedStatus();
+				copyScanList();
 			}
 			
 			// Update scan active status
 			uint32_t elapsed = now - bleScanStartTime;
-			bool clientScanning = client->isBleScanning();
+			bool clientScanning = snapshot().status.bleScanning;
 			const uint32_t minScanDisplayMs = 3000; // keep scanning state for at least 3s
 			bool scanningActive = clientScanning || (elapsed < minScanDisplayMs);
 			
@@ -2184,13 +2524,10 @@ void MeshtasticUI::openDeviceListMenu() {
 	if (!client) {
 		modalItems.push_back("<Client not ready>");
 	} else {
-		if (client->scanForDevicesOnly()) {
-			const auto &names = client->getLastScanDevices();
-			if (names.empty()) modalItems.push_back("<None>");
-			else modalItems.assign(names.begin(), names.end());
-		} else {
-			modalItems.push_back("<None found>");
-		}
+		// Whatever the last scan found; scanning is the scan modal's job
+		const auto &list = snapshot().scanList;
+		if (!list || list->names.empty()) modalItems.push_back("<None found>");
+		else modalItems.assign(list->names.begin(), list->names.end());
 	}
 	modalSelected = 0;
 }
@@ -2216,7 +2553,7 @@ void MeshtasticUI::openOkActionMenu() { openMessageActionMenu(); }
 
 void MeshtasticUI::openNodeActionMenu() {
 	// Check if in text message mode first
-	if (client && client->isTextMessageMode()) {
+	if (snapshot().status.messageMode == MODE_TEXTMSG) {
 		showMessage("Only available in ProtoBuf Mode");
 		return;
 	}
@@ -2235,12 +2572,12 @@ void MeshtasticUI::openNodeActionMenu() {
 	modalItems.push_back("Send Message");
 
 	// Add Ping Repeater for MeshCore devices
-	if (client && client->getDeviceType() == DEVICE_MESHCORE) {
+	if (snapshot().deviceType == DEVICE_MESHCORE) {
 		modalItems.push_back("Ping Repeater");
 	}
 
 	// Trace Route only supported on Meshtastic devices
-	if (!client || client->getDeviceType() != DEVICE_MESHCORE) {
+	if (snapshot().deviceType != DEVICE_MESHCORE) {
 		modalItems.push_back("Trace Route");
 	}
 	modalItems.push_back("Add to Favorite");
@@ -2254,7 +2591,7 @@ void MeshtasticUI::openSettingsActionMenu() {
 	modalType = 1;
 	modalContext = MODAL_SETTINGS;
 	modalTitle = "Settings";
-	const bool textMode = client ? client->isTextMessageMode() : true;
+	const bool textMode = client ? snapshot().status.messageMode == MODE_TEXTMSG : true;
 	String modeLabel = textMode ? "Switch to Protobuf" : "Switch to TextMsg";
 	modalItems = {"Set Baud", "Set TX", "Set RX", modeLabel, "Set Brightness", "Close"};
 	modalSelected = 0;
@@ -2277,17 +2614,17 @@ void MeshtasticUI::openDirectSetting() {
 			case SETTING_GROVE_CONNECT:
 				// Manually trigger Grove connection
 				if (client) {
-					client->startGroveConnection();
+					client->postCommand(MeshtasticClient::CMD_CONNECT_GROVE);
 				}
 				break;
 			case SETTING_UART_BAUD:
-				openInputDialog("Baud Rate", INPUT_SET_BAUD, 0xFFFFFFFF, String(client->getUARTBaud()));
+				openInputDialog("Baud Rate", INPUT_SET_BAUD, 0xFFFFFFFF, String(snapshot().status.uartBaud));
 				break;
 			case SETTING_UART_TX:
-				openInputDialog("TX Pin", INPUT_SET_TX, 0xFFFFFFFF, String(client->getUARTTxPin()));
+				openInputDialog("TX Pin", INPUT_SET_TX, 0xFFFFFFFF, String(snapshot().status.uartTxPin));
 				break;
 			case SETTING_UART_RX:
-				openInputDialog("RX Pin", INPUT_SET_RX, 0xFFFFFFFF, String(client->getUARTRxPin()));
+				openInputDialog("RX Pin", INPUT_SET_RX, 0xFFFFFFFF, String(snapshot().status.uartRxPin));
 				break;
 			case SETTING_BRIGHTNESS:
 				openBrightnessMenu();
@@ -2304,6 +2641,33 @@ void MeshtasticUI::openDirectSetting() {
 			case SETTING_NOTIFICATION:
 				openNotificationMenu();
 				break;
+			case SETTING_UART_SPEED:
+				openUARTSpeedMenu();
+				break;
+			case SETTING_WIFI_SSID:
+				openInputDialog("WiFi Network", INPUT_SET_WIFI_SSID, 0xFFFFFFFF, snapshot().status.wifiSsid);
+				break;
+			case SETTING_WIFI_PASSWORD:
+				openInputDialog("WiFi Password", INPUT_SET_WIFI_PASSWORD, 0xFFFFFFFF, "");
+				break;
+			case SETTING_TCP_HOST:
+				openInputDialog("Radio IP / Host", INPUT_SET_TCP_HOST, 0xFFFFFFFF, snapshot().status.tcpHost);
+				break;
+			case SETTING_TCP_CONNECT:
+				startWifiConnection();
+				break;
+			case SETTING_RADIO_LOG:
+				openRadioLogDialog();
+				break;
+			case SETTING_DIAGNOSTICS:
+				openDiagnosticsDialog();
+				break;
+			case SETTING_POWER_SAVE:
+				if (g_powerManager) {
+					g_powerManager->setEnabled(!g_powerManager->enabled());
+					showMessage(g_powerManager->enabled() ? "Light sleep when screen is off" : "Power Save: Off");
+				}
+				break;
 
 			default:
 				break;
@@ -2320,7 +2684,7 @@ void MeshtasticUI::openBrightnessMenu() {
 	
 	// Set current selection based on current brightness
 	if (client) {
-		int currentBrightness = client->getBrightness();
+		int currentBrightness = snapshot().status.brightness;
 		int percentage = (currentBrightness * 100) / 255;
 		// Find closest percentage
 		int closestIndex = 0;
@@ -2344,7 +2708,7 @@ void MeshtasticUI::openMessageModeMenu() {
 	
 	// Set current selection based on current mode
 	if (client) {
-		modalSelected = (int)client->getMessageMode();
+		modalSelected = (int)snapshot().status.messageMode;
 	} else {
 		modalSelected = 1; // Default to Protobufs
 	}
@@ -2358,7 +2722,7 @@ void MeshtasticUI::openScreenTimeoutMenu() {
 	
 	// Set current selection based on current timeout
 	if (client) {
-		uint32_t timeout = client->getScreenTimeout();
+		uint32_t timeout = snapshot().status.screenTimeoutMs;
 		if (timeout == 30000) modalSelected = 0;
 		else if (timeout == 120000) modalSelected = 1;
 		else if (timeout == 300000) modalSelected = 2;
@@ -2368,11 +2732,40 @@ void MeshtasticUI::openScreenTimeoutMenu() {
 	}
 }
 
+void MeshtasticUI::openUARTSpeedMenu() {
+	modalType = 1;
+	modalContext = MODAL_UART_SPEED;
+	modalTitle = "Radio Baud";
+	modalItems = {"115200", "921600", "Cancel"};
+	modalSelected = 0;
+}
+
+String MeshtasticUI::connectionTypeLabel() const {
+	switch (currentConnectionType) {
+		case CONNECTION_GROVE: return "Grove";
+		case CONNECTION_WIFI: return "WiFi TCP";
+		case CONNECTION_BLUETOOTH:
+		default: return "Bluetooth";
+	}
+}
+
+void MeshtasticUI::startWifiConnection() {
+	if (!client) return;
+	if (snapshot().status.wifiSsid.isEmpty() || snapshot().status.tcpHost.isEmpty()) {
+		showError("Set WiFi and radio host first");
+		return;
+	}
+	// A failure comes back as an error notice
+	client->postCommand(MeshtasticClient::CMD_CONNECT_TCP);
+	showMessage("Connecting via WiFi...");
+	needSettingsRedraw = true;
+}
+
 void MeshtasticUI::openConnectionTypeMenu() {
 	modalType = 1;
 	modalContext = MODAL_CONNECTION_TYPE;
 	modalTitle = "Connection Type";
-	modalItems = {"Grove", "Bluetooth", "Cancel"};
+	modalItems = {"Grove", "Bluetooth", "WiFi TCP", "Cancel"};
 	
 	// Set current selection based on current connection type
 	modalSelected = (int)currentConnectionType;
@@ -2394,9 +2787,9 @@ void MeshtasticUI::openBleDevicesMenu() {
 	modalItems.push_back(autoConnectOption);
 	
 	// Get list of paired BLE devices
-	if (client) {
-		std::vector<String> pairedDevices = client->getScannedDeviceNames();
-		std::vector<bool> pairedStatus = client->getScannedDevicePairedStatus();
+	if (const auto &list = snapshot().scanList) {
+		const std::vector<String> &pairedDevices = list->names;
+		const std::vector<bool> &pairedStatus = list->paired;
 		
 		// Add paired devices to the list
 		for (size_t i = 0; i < pairedDevices.size(); i++) {
@@ -2478,6 +2871,8 @@ void MeshtasticUI::openMessageActionMenu() {
 			modalItems.push_back("Search Device");
 			modalItems.push_back("Paired Devices");
 			// Don't show Grove options when in Bluetooth mode
+		} else if (currentConnectionType == CONNECTION_WIFI) {
+			modalItems.push_back("Connect via WiFi");
 		} else {
 			modalItems.push_back("Connect via Grove");
 			// Don't show Bluetooth options when in Grove mode
@@ -2495,7 +2890,7 @@ void MeshtasticUI::openMessageActionMenu() {
 	modalItems.clear();
 	modalItems.push_back("Compose");
 
-	if (client && !client->isTextMessageMode()) {
+	if (client && snapshot().status.messageMode != MODE_TEXTMSG) {
 		modalItems.push_back("Select Destination");
 	}
 
@@ -2505,7 +2900,7 @@ void MeshtasticUI::openMessageActionMenu() {
 		modalItems.push_back("View Full Msg");
 	}
 
-	if (client && client->getMessageHistory().size() > 3) {
+	if (client && messages().size() > 3) {
 		modalItems.push_back("Clear All");
 	}
 
@@ -2520,7 +2915,7 @@ void MeshtasticUI::openMessageComposer(uint32_t nodeId) {
 		title = "Broadcast Message";
 	} else {
 		// Get the actual node name
-		const MeshtasticNode* node = client ? client->getNodeById(nodeId) : nullptr;
+		const MeshtasticNode* node = findNode(nodeId);
 		if (node) {
 			String nodeName = node->longName.length() ? node->longName : node->shortName;
 			if (nodeName.isEmpty()) {
@@ -2565,12 +2960,11 @@ void MeshtasticUI::openDestinationSelect() {
 	
 	// Add all available nodes (except self)
 	if (client) {
-		const auto &nodes = client->getNodeList();
-		uint32_t myNodeId = client->getMyNodeId();
+		uint32_t myId = myNodeId();
 		
-		for (const auto &node : nodes) {
+		for (const auto &node : nodes()) {
 			// Skip our own node
-			if (node.nodeId == myNodeId) {
+			if (node.nodeId == myId) {
 				continue;
 			}
 			
@@ -2591,13 +2985,14 @@ void MeshtasticUI::openDestinationSelect() {
 
 void MeshtasticUI::closeModal() {
 	// Stop BLE scan if it's active to free resources
-	if (modalContext == MODAL_BLE_SCAN && client && client->isBleScanning()) {
-		client->stopBleScan();
+	if (modalContext == MODAL_BLE_SCAN && client && snapshot().status.bleScanning) {
+		client->postCommand(MeshtasticClient::CMD_BLE_SCAN_STOP);
 		Serial.println("[UI] Stopped BLE scan on modal close");
 	}
 	
 	modalType = 0;
 	modalContext = MODAL_NONE;
+	reportView = REPORT_NONE;
 	modalItems.clear();
 	modalNodeIds.clear();
 	modalTitle = "";
@@ -2681,9 +3076,8 @@ bool MeshtasticUI::performPendingInputAction() {
 			Serial.printf("[UI] SEND action: node=0x%08X len=%d preview='%s'\n",
 						  pendingNodeId, inputBuffer.length(),
 						  inputBuffer.substring(0, std::min<int>(inputBuffer.length(), 40)).c_str());
-			bool ok = false;
-			if (pendingNodeId == 0xFFFFFFFF) ok = client->broadcastMessage(inputBuffer, client->getCurrentChannel());
-			else ok = client->sendDirectMessage(pendingNodeId, inputBuffer);
+			// Sent on the protocol task; a send that fails there comes back as a notice
+			bool ok = client->postText(MeshtasticClient::CMD_SEND_TEXT, inputBuffer, pendingNodeId);
 			Serial.printf("[UI] SEND result: %s\n", ok ? "OK" : "FAIL");
 			if (ok) {
 				showSuccess("Message queued");
@@ -2691,7 +3085,7 @@ bool MeshtasticUI::performPendingInputAction() {
 				if (pendingNodeId != 0xFFFFFFFF) {
 					currentDestinationId = pendingNodeId;
 					// Update destination name
-					const MeshtasticNode *node = client->findNode(pendingNodeId);
+					const MeshtasticNode *node = findNode(pendingNodeId);
 					if (node) {
 						currentDestinationName = node->longName.length() ? node->longName : node->shortName;
 						if (currentDestinationName.isEmpty()) {
@@ -2703,14 +3097,14 @@ bool MeshtasticUI::performPendingInputAction() {
 						currentDestinationName = (fullHex.length() > 4 ? fullHex.substring(fullHex.length() - 4) : fullHex);
 					}
 				} else {
-					String channelName = client ? client->getPrimaryChannelName() : "Primary";
+					String channelName = snapshot().primaryChannelName;
 					if (channelName.isEmpty()) channelName = "Primary";
 					currentDestinationName = channelName;  // Store channel name only
 				}
 				currentTab = 0; // Switch to Messages tab
 				
 				// Auto-scroll to latest message after sending
-				auto filtered = getFilteredMessages();
+				const auto &filtered = getFilteredMessages();
 				if (!filtered.empty()) {
 					messageSelectedIndex = (int)filtered.size() - 1;
 				}
@@ -2724,19 +3118,19 @@ bool MeshtasticUI::performPendingInputAction() {
 				showError("Invalid baud");
 				return false;
 			}
-			client->setUARTConfig(baud, client->getUARTTxPin(), client->getUARTRxPin());
+			client->postValue(MeshtasticClient::CMD_SET_UART_BAUD, baud);
 			showSuccess("Baud -> " + String(baud));
 			return true;
 		}
 		case INPUT_SET_TX: {
 			int pin = inputBuffer.toInt();
-			client->setUARTConfig(client->getUARTBaud(), pin, client->getUARTRxPin());
+			client->postValue(MeshtasticClient::CMD_SET_UART_TX_PIN, (uint32_t)pin);
 			showSuccess("TX pin -> " + String(pin));
 			return true;
 		}
 		case INPUT_SET_RX: {
 			int pin = inputBuffer.toInt();
-			client->setUARTConfig(client->getUARTBaud(), client->getUARTTxPin(), pin);
+			client->postValue(MeshtasticClient::CMD_SET_UART_RX_PIN, (uint32_t)pin);
 			showSuccess("RX pin -> " + String(pin));
 			return true;
 		}
@@ -2746,12 +3140,13 @@ bool MeshtasticUI::performPendingInputAction() {
 				showError("Invalid brightness (0-255)");
 				return false;
 			}
-			client->setBrightness((uint8_t)brightness);
+			M5.Display.setBrightness((uint8_t)brightness);
+			client->postValue(MeshtasticClient::CMD_SET_BRIGHTNESS, (uint32_t)brightness);
 			showSuccess("Brightness -> " + String(brightness));
 			return true;
 		}
 		case INPUT_ENTER_BLE_PIN: {
-			// BLE PIN input - store in blePinInput for pairing logic to pick up
+			// BLE PIN input - handed to the pairing waiting on it
 			if (inputBuffer.length() < 4 || inputBuffer.length() > 6) {
 				showError("PIN must be 4-6 digits");
 				return false;
@@ -2763,8 +3158,8 @@ bool MeshtasticUI::performPendingInputAction() {
 					return false;
 				}
 			}
-			blePinInput = inputBuffer;
-			Serial.printf("[UI] BLE PIN entered: %s (length=%d)\n", blePinInput.c_str(), blePinInput.length());
+			Serial.printf("[UI] BLE PIN entered: %s (length=%d)\n", inputBuffer.c_str(), inputBuffer.length());
+			client->postValue(MeshtasticClient::CMD_BLE_PIN, (uint32_t)inputBuffer.toInt());
 			
 			// Close modal immediately to prevent UI freezing - don't show success message
 			closeModal();
@@ -2774,6 +3169,26 @@ bool MeshtasticUI::performPendingInputAction() {
 			
 			return true;
 		}
+		case INPUT_SET_WIFI_SSID: {
+			String ssid = inputBuffer;
+			ssid.trim();
+			// Changing networks invalidates the saved password (done client side)
+			client->postText(MeshtasticClient::CMD_SET_WIFI_SSID, ssid);
+			showSuccess(ssid.isEmpty() ? String("WiFi cleared") : "WiFi -> " + ssid);
+			return true;
+		}
+		case INPUT_SET_WIFI_PASSWORD: {
+			client->postText(MeshtasticClient::CMD_SET_WIFI_PASSWORD, inputBuffer);
+			showSuccess("WiFi password saved");
+			return true;
+		}
+		case INPUT_SET_TCP_HOST: {
+			String host = inputBuffer;
+			host.trim();
+			client->postText(MeshtasticClient::CMD_SET_TCP_HOST, host);
+			showSuccess("Radio host -> " + host);
+			return true;
+		}
 		default: break;
 	}
 	return false;
@@ -2788,14 +3203,14 @@ void MeshtasticUI::handleModalSelection() {
 			if (name.startsWith("<")) { closeModal(); break; }
 			
 			// Only check for Grove/UART connection conflict if current connection type is Grove
-			if (currentConnectionType == CONNECTION_GROVE && client->isUARTAvailable()) {
+			if (currentConnectionType == CONNECTION_GROVE && snapshot().status.uartAvailable) {
 				closeModal();
 				showError("Cannot connect BLE while Grove is active");
 				Serial.println("[UI] ERROR: Attempted BLE device connection while Grove/UART is active");
 				break;
 			}
 			
-			client->connectToDeviceByName(name);
+			client->postText(MeshtasticClient::CMD_BLE_CONNECT_NAME, name);
 			closeModal();
 			break;
 		}
@@ -2807,13 +3222,13 @@ void MeshtasticUI::handleModalSelection() {
 				openMessageComposer(nodeId);
 				return;
 			} else if (choice == "Ping Repeater") {
-				client->sendMeshCorePing(nodeId);
+				client->postCommand(MeshtasticClient::CMD_MESHCORE_PING, nodeId);
 				showMessage("Ping sent to " + String(nodeId, HEX));
 			} else if (choice == "Trace Route") {
-				if (client->getDeviceType() == DEVICE_MESHCORE) {
+				if (snapshot().deviceType == DEVICE_MESHCORE) {
 					showError("Trace Route not supported on MeshCore");
 				} else {
-					client->sendTraceRoute(nodeId, 5); // Default hop limit of 5
+					client->postCommand(MeshtasticClient::CMD_TRACE_ROUTE, nodeId, 5); // Default hop limit of 5
 					showMessage("Trace route sent");
 				}
 			} else if (choice == "Add to Favorite") {
@@ -2831,13 +3246,13 @@ void MeshtasticUI::handleModalSelection() {
 			if (!client) { closeModal(); break; }
 			String choice = modalItems[modalSelected];
 			if (choice == "Set Baud") {
-				openInputDialog("Baud Rate", INPUT_SET_BAUD, 0xFFFFFFFF, String(client->getUARTBaud()));
+				openInputDialog("Baud Rate", INPUT_SET_BAUD, 0xFFFFFFFF, String(snapshot().status.uartBaud));
 				return;
 			} else if (choice == "Set TX") {
-				openInputDialog("TX Pin", INPUT_SET_TX, 0xFFFFFFFF, String(client->getUARTTxPin()));
+				openInputDialog("TX Pin", INPUT_SET_TX, 0xFFFFFFFF, String(snapshot().status.uartTxPin));
 				return;
 			} else if (choice == "Set RX") {
-				openInputDialog("RX Pin", INPUT_SET_RX, 0xFFFFFFFF, String(client->getUARTRxPin()));
+				openInputDialog("RX Pin", INPUT_SET_RX, 0xFFFFFFFF, String(snapshot().status.uartRxPin));
 				return;
 			} else if (choice == "Set Brightness") {
 				// Open brightness percentage menu instead of text input
@@ -2845,7 +3260,7 @@ void MeshtasticUI::handleModalSelection() {
 				return;
 			} else if (choice.startsWith("Switch to")) {
 				bool targetTextMode = (choice.indexOf("TextMsg") >= 0);
-				client->setTextMessageMode(targetTextMode);
+				client->postValue(MeshtasticClient::CMD_SET_TEXT_MODE, targetTextMode ? 1 : 0);
 				String newMode = targetTextMode ? "TextMsg" : "Protobuf";
 				showMessage("Mode: " + newMode);
 			}
@@ -2860,18 +3275,18 @@ void MeshtasticUI::handleModalSelection() {
 				return;
 			} else if (choice == "View Full") {
 				// Show full message content in current conversation (filtered)
-				auto filteredMessages = getFilteredMessages();
+				const auto &filteredMessages = getFilteredMessages();
 				if (messageSelectedIndex >= 0 && messageSelectedIndex < (int)filteredMessages.size()) {
 					const auto &msg = filteredMessages[messageSelectedIndex];
 					String detailFrom = msg.fromName;
-					if (client && client->getDeviceType() == DEVICE_MESHCORE && msg.fromNodeId == 0xFFFFFFFF) {
+					if (snapshot().deviceType == DEVICE_MESHCORE && msg.fromNodeId == 0xFFFFFFFF) {
 						detailFrom = ""; // Suppress channel name for MeshCore broadcast messages
 					}
 					openMessageDetail(detailFrom, msg.content);
 					return;
 				}
 			} else if (choice == "Clear All") {
-				client->clearMessageHistory();
+				client->postCommand(MeshtasticClient::CMD_CLEAR_HISTORY);
 				showSuccess("Messages cleared");
 				closeModal();
 				return;
@@ -2892,7 +3307,8 @@ void MeshtasticUI::handleModalSelection() {
 			if (choice.endsWith("%")) {
 				int percentage = choice.substring(0, choice.length() - 1).toInt();
 				int brightness = (percentage * 255) / 100;
-				client->setBrightness(brightness);
+				M5.Display.setBrightness((uint8_t)brightness);
+				client->postValue(MeshtasticClient::CMD_SET_BRIGHTNESS, (uint32_t)brightness);
 				showMessage("Brightness: " + String(percentage) + "%");
 			}
 			closeModal();
@@ -2911,11 +3327,22 @@ void MeshtasticUI::handleModalSelection() {
 			else if (choice == "Protobufs") newMode = MODE_PROTOBUFS;
 			else { closeModal(); break; }
 			
-			client->setMessageMode(newMode);
+			client->postValue(MeshtasticClient::CMD_SET_MESSAGE_MODE, newMode);
 			showMessage("Message Mode: " + choice);
 			closeModal();
 			break;
 		}
+		case MODAL_UART_SPEED: {
+			if (!client) { closeModal(); break; }
+			String choice = modalItems[modalSelected];
+			closeModal();
+			if (choice == "Cancel") break;
+			uint32_t baud = (uint32_t)atol(choice.c_str());
+			// A link that can't be upgraded comes back as an error notice
+			client->postValue(MeshtasticClient::CMD_UART_SPEED_UPGRADE, baud);
+			showMessage("Switching radio to " + choice);
+			break;
+		}
 		case MODAL_SCREEN_TIMEOUT: {
 			if (!client) { closeModal(); break; }
 			String choice = modalItems[modalSelected];
@@ -2931,7 +3358,7 @@ void MeshtasticUI::handleModalSelection() {
 			else if (choice == "Never") timeoutMs = 0;
 			else { closeModal(); break; }
 			
-			client->setScreenTimeout(timeoutMs);
+			client->postValue(MeshtasticClient::CMD_SET_SCREEN_TIMEOUT, timeoutMs);
 			showMessage("Screen Timeout: " + choice);
 			closeModal();
 			break;
@@ -2947,18 +3374,18 @@ void MeshtasticUI::handleModalSelection() {
 				return;
 			} else if (choice == "View Full Msg") {
 				// Show full message content in fullscreen view
-				auto filteredMessages = getFilteredMessages();
+				const auto &filteredMessages = getFilteredMessages();
 				if (messageSelectedIndex >= 0 && messageSelectedIndex < (int)filteredMessages.size()) {
 					const auto &msg = filteredMessages[messageSelectedIndex];
 					String detailFrom = msg.fromName;
-					if (client && client->getDeviceType() == DEVICE_MESHCORE && msg.fromNodeId == 0xFFFFFFFF) {
+					if (snapshot().deviceType == DEVICE_MESHCORE && msg.fromNodeId == 0xFFFFFFFF) {
 						detailFrom = ""; // Suppress channel name for MeshCore broadcast messages
 					}
 					openMessageDetail(detailFrom, msg.content);
 					return;
 				}
 			} else if (choice == "Clear All") {
-				client->clearMessageHistory();
+				client->postCommand(MeshtasticClient::CMD_CLEAR_HISTORY);
 				showSuccess("Messages cleared");
 				closeModal();
 				return;
@@ -2981,11 +3408,11 @@ void MeshtasticUI::handleModalSelection() {
 				currentDestinationId = selectedNodeId;
 				
 				if (selectedNodeId == 0xFFFFFFFF) {
-					String channelName = client ? client->getPrimaryChannelName() : "Primary";
+					String channelName = snapshot().primaryChannelName;
 					if (channelName.isEmpty()) channelName = "Primary";
 					currentDestinationName = channelName;  // Store channel name only
 				} else {
-					const MeshtasticNode *node = client->findNode(selectedNodeId);
+					const MeshtasticNode *node = findNode(selectedNodeId);
 					if (node) {
 						currentDestinationName = node->longName.length() ? node->longName : node->shortName;
 						if (currentDestinationName.isEmpty()) {
@@ -3014,10 +3441,10 @@ void MeshtasticUI::handleModalSelection() {
 				}
 			} else if (choice == "Trace Route") {
 				if (!modalNodeIds.empty()) {
-					if (client->getDeviceType() == DEVICE_MESHCORE) {
+					if (snapshot().deviceType == DEVICE_MESHCORE) {
 						showError("Trace Route not supported on MeshCore");
 					} else {
-						client->sendTraceRoute(modalNodeIds[0], 5); // Default hop limit of 5
+						client->postCommand(MeshtasticClient::CMD_TRACE_ROUTE, modalNodeIds[0], 5); // Default hop limit of 5
 						showMessage("Trace route sent");
 					}
 				}
@@ -3027,8 +3454,8 @@ void MeshtasticUI::handleModalSelection() {
 					showMessage("Node removed");
 				}
 			} else if (choice == "Refresh") {
-				if (client && client->isDeviceConnected()) {
-					client->requestNodeList();
+				if (client && snapshot().connected) {
+					client->postCommand(MeshtasticClient::CMD_REQUEST_NODES);
 					showMessage("Refreshing nodes...");
 				}
 			}
@@ -3073,8 +3500,8 @@ void MeshtasticUI::handleModalSelection() {
 				// "Press OK to retry" option
 				bleScanRequested = true;
 				if (client) {
-					client->stopBleScan();
-					client->startBleScan();
+					// Restarts a running scan, with the list cleared
+					client->postCommand(MeshtasticClient::CMD_BLE_SCAN_START);
 				}
 				bleScanStartTime = millis();
 				bleScanning = true;
@@ -3091,24 +3518,20 @@ void MeshtasticUI::handleModalSelection() {
 			if (!client) { closeModal(); break; }
 			
 			// Only check for Grove/UART connection conflict if current connection type is Grove
-			if (currentConnectionType == CONNECTION_GROVE && client->isUARTAvailable()) {
+			if (currentConnectionType == CONNECTION_GROVE && snapshot().status.uartAvailable) {
 				closeModal();
 				showError("Cannot pair BLE while Grove is active");
 				Serial.println("[UI] ERROR: Attempted BLE pairing while Grove/UART is active");
 				break;
 			}
 			
-			// PIN input is handled in input processing section
-			// This case is for when user presses Enter
-			String pin = inputBuffer.length() >= 4 ? inputBuffer.substring(0, 6) : inputBuffer;  // Max 6 digit PIN
-			
-			showMessage("Pairing with " + selectedBleDevice + "...");
-			
-			if (client->connectToDeviceWithPin(selectedBleAddress, pin)) {
+			// The PIN itself goes in when the radio asks for it (CMD_BLE_PIN);
+			// this starts the connect that leads there
+			if (client->postText(MeshtasticClient::CMD_BLE_CONNECT_ADDRESS, selectedBleAddress)) {
 				preferredBluetoothDevice = selectedBleDevice;
 				currentConnectionType = CONNECTION_BLUETOOTH;
-				saveConnectionSettings(); // Save connection after successful pairing
-				showSuccess("Paired and connected to " + selectedBleDevice);
+				saveConnectionSettings();
+				showMessage("Pairing with " + selectedBleDevice + "...");
 			} else {
 				showError("Failed to pair with " + selectedBleDevice);
 			}
@@ -3138,11 +3561,12 @@ void MeshtasticUI::handleModalSelection() {
 			ConnectionType newType;
 			if (choice == "Grove") newType = CONNECTION_GROVE;
 			else if (choice == "Bluetooth") newType = CONNECTION_BLUETOOTH;
+			else if (choice == "WiFi TCP") newType = CONNECTION_WIFI;
 			else { closeModal(); break; }
 			
 			// If switching connection types, disconnect from current device
 			if (newType != currentConnectionType && client) {
-				client->disconnectFromDevice();
+				client->postCommand(MeshtasticClient::CMD_DISCONNECT);
 			}
 			
 			currentConnectionType = newType;
@@ -3154,12 +3578,14 @@ void MeshtasticUI::handleModalSelection() {
 					clientPreference = 1; // PREFER_GROVE
 				} else if (newType == CONNECTION_BLUETOOTH) {
 					clientPreference = 2; // PREFER_BLUETOOTH  
+				} else if (newType == CONNECTION_WIFI) {
+					clientPreference = 3; // PREFER_WIFI
 				} else {
 					clientPreference = 0; // PREFER_AUTO
 				}
 				
 				Serial.printf("[UI] Updating connection preference from UI type %d to client pref %d\n", (int)newType, clientPreference);
-				client->setUserConnectionPreference(clientPreference);
+				client->postValue(MeshtasticClient::CMD_SET_PREFERENCE, clientPreference);
 				Serial.printf("[UI] Updated client preference to: %d\n", clientPreference);
 			}
 			
@@ -3168,7 +3594,7 @@ void MeshtasticUI::handleModalSelection() {
 
 			// 如果切换到 Grove，强制进入 protobuf 模式，保证 Grove/UART 能正常通信
 			if (newType == CONNECTION_GROVE && client) {
-				client->setMessageMode(MODE_PROTOBUFS);
+				client->postValue(MeshtasticClient::CMD_SET_MESSAGE_MODE, MODE_PROTOBUFS);
 			}
 
 			// Refresh settings to show appropriate options
@@ -3192,7 +3618,7 @@ void MeshtasticUI::handleModalSelection() {
 				// Clear all paired devices
 				if (client) {
 					// Use client method to clear all paired devices
-					client->clearPairedDevices();
+					client->postCommand(MeshtasticClient::CMD_BLE_CLEAR_PAIRED);
 					
 					// Clear preferences
 					Preferences prefs;
@@ -3261,9 +3687,14 @@ void MeshtasticUI::handleModalSelection() {
 				// This option only appears in Grove mode
 				closeModal();
 				if (client) {
-					client->startGroveConnection();
+					client->postCommand(MeshtasticClient::CMD_CONNECT_GROVE);
 				}
 				break;
+			} else if (choice == "Connect via WiFi") {
+				// This option only appears in WiFi mode
+				closeModal();
+				startWifiConnection();
+				break;
 			} else if (choice == "Search Device") {
 				// This option only appears in Bluetooth mode
 				closeModal();
@@ -3436,7 +3867,7 @@ void MeshtasticUI::navigateSelection(int delta) {
 				}
 			} else {
 				// Navigate through messages for current destination
-				auto filteredMessages = getFilteredMessages();
+				const auto &filteredMessages = getFilteredMessages();
 				if (!filteredMessages.empty()) {
 					messageSelectedIndex = std::clamp(messageSelectedIndex + delta, 0, (int)filteredMessages.size() - 1);
 				}
@@ -3476,9 +3907,31 @@ void MeshtasticUI::navigateSelection(int delta) {
 }
 
 void MeshtasticUI::updateVisibleMessages() {
-	visibleMessageIndices.clear();
-	if (!client) return;
-	const auto &messages = client->getMessageHistory();
+	if (!client) {
+		visibleMessageIndices.clear();
+		return;
+	}
+	// Line fitting walks the whole history; only redo it when the history changed
+	uint32_t version = messagesVersion();
+	if (!visibleMessagesValid || visibleMessagesVersion != version) {
+		visibleMessagesValid = true;
+		visibleMessagesVersion = version;
+		visibleMessageIndices.clear();
+		fitVisibleMessages();
+	}
+
+	if (visibleMessageIndices.empty()) return;
+	// Clamp selection against the size of the filtered conversation, not just visible range
+	const auto &filtered = getFilteredMessages();
+	if (!filtered.empty()) {
+		messageSelectedIndex = std::clamp(messageSelectedIndex, 0, (int)filtered.size() - 1);
+	} else {
+		messageSelectedIndex = 0;
+	}
+}
+
+void MeshtasticUI::fitVisibleMessages() {
+	const auto &messages = this->messages();
 	if (messages.empty()) return;
 	
 	// Calculate available height for messages
@@ -3496,7 +3949,7 @@ void MeshtasticUI::updateVisibleMessages() {
 	for (int i = total - 1; i >= 0; i--) {
 		const auto &msg = messages[i];
 		const bool isMeshCoreBroadcast = client &&
-			(client->getDeviceType() == DEVICE_MESHCORE) &&
+			(snapshot().deviceType == DEVICE_MESHCORE) &&
 			(msg.fromNodeId == 0xFFFFFFFF);
 		String prefix = isMeshCoreBroadcast ? String("") : msg.fromName;
 		String fullText = prefix.isEmpty() ? msg.content : prefix + ": " + msg.content;
@@ -3536,33 +3989,42 @@ void MeshtasticUI::updateVisibleMessages() {
 	for (int i = startIndex; i < total; ++i) {
 		visibleMessageIndices.push_back(i);
 	}
-	
-	if (visibleMessageIndices.empty()) return;
-	// Clamp selection against the size of the filtered conversation, not just visible range
-	auto filtered = getFilteredMessages();
-	if (!filtered.empty()) {
-		messageSelectedIndex = std::clamp(messageSelectedIndex, 0, (int)filtered.size() - 1);
-	} else {
-		messageSelectedIndex = 0;
-	}
 }
 
 void MeshtasticUI::scrollToLatestMessage() {
 	if (!client) return;
 	// Select the very last message in the current filtered conversation
-	auto filtered = getFilteredMessages();
+	const auto &filtered = getFilteredMessages();
 	if (!filtered.empty()) {
 		messageSelectedIndex = (int)filtered.size() - 1;
 	}
 }
 
+void MeshtasticUI::onNodeChanged(uint32_t nodeId, uint8_t changeMask) {
+	// Other tabs show nothing per node; switching to Nodes repaints in full
+	if (currentTab != 1) return;
+	bool selected = nodeSelectedIndex < (int)visibleNodeIds.size() && visibleNodeIds[nodeSelectedIndex] == nodeId;
+	// An unselected row shows only the name
+	if (!selected && !(changeMask & NODE_CHANGE_NAME)) return;
+	if (std::find(dirtyNodeRows.begin(), dirtyNodeRows.end(), nodeId) == dirtyNodeRows.end()) {
+		dirtyNodeRows.push_back(nodeId);
+	}
+}
+
 void MeshtasticUI::updateVisibleNodes() {
-	visibleNodeIds.clear();
-	if (!client) return;
-	const auto &nodes = client->getNodeList();
-	if (nodes.empty()) return;
-	size_t start = nodes.size() > (size_t)kMaxVisibleNodes ? nodes.size() - kMaxVisibleNodes : 0;
-	for (size_t i = start; i < nodes.size(); ++i) visibleNodeIds.push_back(nodes[i].nodeId);
+	if (!client) {
+		visibleNodeIds.clear();
+		return;
+	}
+	uint32_t version = nodesVersion();
+	if (!visibleNodesValid || visibleNodesVersion != version) {
+		visibleNodesValid = true;
+		visibleNodesVersion = version;
+		visibleNodeIds.clear();
+		const auto &nodes = this->nodes();
+		size_t start = nodes.size() > (size_t)kMaxVisibleNodes ? nodes.size() - kMaxVisibleNodes : 0;
+		for (size_t i = start; i < nodes.size(); ++i) visibleNodeIds.push_back(nodes[i].nodeId);
+	}
 	if (!visibleNodeIds.empty()) {
 		nodeSelectedIndex = std::clamp(nodeSelectedIndex, 0, (int)visibleNodeIds.size() - 1);
 	}
@@ -3577,15 +4039,24 @@ void MeshtasticUI::updateVisibleSettings() {
 	if (currentConnectionType == CONNECTION_GROVE) {
 		visibleSettingsKeys.push_back(SETTING_GROVE_CONNECT);  // Manual Grove connection trigger
 		visibleSettingsKeys.push_back(SETTING_UART_BAUD);
+		visibleSettingsKeys.push_back(SETTING_UART_SPEED);
 		visibleSettingsKeys.push_back(SETTING_UART_TX);
 		visibleSettingsKeys.push_back(SETTING_UART_RX);
 		visibleSettingsKeys.push_back(SETTING_MESSAGE_MODE);
 	} else if (currentConnectionType == CONNECTION_BLUETOOTH) {
 		visibleSettingsKeys.push_back(SETTING_BLE_DEVICES);
+	} else if (currentConnectionType == CONNECTION_WIFI) {
+		visibleSettingsKeys.push_back(SETTING_TCP_CONNECT);
+		visibleSettingsKeys.push_back(SETTING_WIFI_SSID);
+		visibleSettingsKeys.push_back(SETTING_WIFI_PASSWORD);
+		visibleSettingsKeys.push_back(SETTING_TCP_HOST);
 	}
 	
+	visibleSettingsKeys.push_back(SETTING_RADIO_LOG);
+	visibleSettingsKeys.push_back(SETTING_DIAGNOSTICS);
 	visibleSettingsKeys.push_back(SETTING_NOTIFICATION);
 	visibleSettingsKeys.push_back(SETTING_SCREEN_TIMEOUT);
+	visibleSettingsKeys.push_back(SETTING_POWER_SAVE);
 	visibleSettingsKeys.push_back(SETTING_BRIGHTNESS);
 	settingsSelectedIndex = std::clamp(settingsSelectedIndex, 0, (int)visibleSettingsKeys.size() - 1);
 }
@@ -3897,6 +4368,7 @@ void MeshtasticUI::drawScrollbar(int x, int y, int width, int height, int totalI
 
 void MeshtasticUI::openAboutDialog() {
 	modalType = 7; // New modal type for About dialog
+	modalTitle = "About MeshClient";
 	scrollOffset = 0; // Reset scroll position
 	// Pre-compute text lines for About content
 	// Append build version and date info at the end
@@ -3919,13 +4391,138 @@ void MeshtasticUI::openAboutDialog() {
 	needsRedraw = true;
 }
 
+void MeshtasticUI::requestReport(uint8_t view) {
+	// Filled in by beginFrame() once the client publishes a newer report
+	reportView = client ? view : REPORT_NONE;
+	reportRequestVersion = snapshot().reportVersion;
+	if (client) client->postCommand(MeshtasticClient::CMD_REPORT);
+}
+
+void MeshtasticUI::openRadioLogDialog() {
+	modalType = 7; // Same scrollable text view as About
+	modalTitle = "Radio Log";
+	requestReport(REPORT_RADIO_LOG);
+	showRadioLog(nullptr);
+}
+
+void MeshtasticUI::showRadioLog(const ClientReport *report) {
+	String text;
+	if (report) {
+		const RadioLog &log = report->radioLog;
+		for (size_t i = 0; i < log.size(); i++) {
+			const RadioLogEntry &e = log.at(i);
+			// Console lines carry their own level prefix; log_record entries don't
+			if (e.source[0]) {
+				text += String(RadioLog::levelName(e.level)) + " [" + e.source + "] ";
+			}
+			text += e.text;
+			text += "\n";
+		}
+	}
+	if (!report && reportView == REPORT_RADIO_LOG) {
+		text = "Loading...";
+	} else if (text.isEmpty()) {
+		text = "No radio log output yet.\nEnable debug logging on the radio's serial console, or debug_log_api over BLE/WiFi.";
+	}
+	computeTextLines(text, M5.Lcd.width() - 32, true);
+	// Open on the newest lines; same layout as the modalType 7 draw
+	int maxLines = (M5.Lcd.height() - 40) / 18;
+	scrollOffset = std::max(0, totalLines - maxLines);
+	needModalRedraw = true;
+	needsRedraw = true;
+}
+
+void MeshtasticUI::openDiagnosticsDialog() {
+	modalType = 7; // Same scrollable text view as About
+	modalTitle = "Diagnostics";
+	scrollOffset = 0;
+	requestReport(REPORT_DIAGNOSTICS);
+	showDiagnostics(nullptr);
+	StageProfiler::dump();
+}
+
+void MeshtasticUI::showDiagnostics(const ClientReport *report) {
+	String text;
+	if (!client) {
+		text = "No client\n";
+	} else if (!report) {
+		text = "Link: loading...\n";
+	} else {
+		text += "Link: " + report->linkName + (report->linkUp ? " (up)" : " (down)") + "\n";
+		if (report->haveLink) {
+			const TransportStats &ls = report->linkStats;
+			text += "RX: " + String(ls.rxFrames) + " frames, " + String(ls.rxBytes) + " B\n";
+			text += "TX: " + String(ls.txFrames) + " frames, " + String(ls.txBytes) + " B\n";
+			text += "TX errors: " + String(ls.txErrors) + "  Discarded: " + String(ls.rxDiscarded) + " B\n";
+		}
+		if (report->radioQueueMax) {
+			text += "Radio queue: " + String(report->radioQueueFree) + "/" + String(report->radioQueueMax) +
+			        " free";
+		} else {
+			text += "Radio queue: unknown";
+		}
+		text += ", rejected " + String(report->radioQueueRejects) + "\n";
+		text += "Awaiting ack: " + String((int)report->pendingAcks) + "\n";
+
+		const PacketFilterStats &dup = report->duplicates;
+		int hitPct = dup.lookups ? (int)((uint64_t)dup.hits * 100 / dup.lookups) : 0;
+		text += "Duplicates: " + String(dup.hits) + "/" + String(dup.lookups) + " (" + String(hitPct) + "%)\n";
+		text += "Dup filter evictions: " + String(dup.evictions) + "\n";
+		text += "Radio log lines: " + String(report->radioLog.total()) + "\n";
+	}
+	// Per-task busy share over the last second, plus the longest single pass
+	for (size_t i = 0; i < TaskLoad::count(); ++i) {
+		const TaskLoad *t = TaskLoad::at(i);
+		text += String("CPU ") + t->name() + ": " + String(t->percent()) + "%, max " +
+		        String(t->maxBusyUs() / 1000) + " ms\n";
+	}
+	// Loop stages: p50 / p99 / max, and the full histograms to serial
+	text += "Stage p50/p99/max ms:\n";
+	for (uint8_t s = 0; s < STAGE_COUNT; s++) {
+		ProfileStage stage = (ProfileStage)s;
+		if (!StageProfiler::count(stage)) continue;
+		text += String(" ") + StageProfiler::name(stage) + ": " + String(StageProfiler::percentileUs(stage, 50) / 1000.0f, 1) +
+		        " / " + String(StageProfiler::percentileUs(stage, 99) / 1000.0f, 1) + " / " +
+		        String(StageProfiler::maxUs(stage) / 1000.0f, 1) + "\n";
+	}
+	if (g_cpuGovernor) {
+		const CpuGovernor &gov = *g_cpuGovernor;
+		float saved = gov.fixedHighMa() - gov.estimatedMa();
+		text += "Clock: " + String(gov.currentMhz()) + " MHz, " + String(CpuGovernor::HIGH_MHZ) + " MHz " +
+		        String(gov.highPercent()) + "% (" + String(gov.switches()) + " switches)\n";
+		text += "Est. CPU draw: " + String(gov.estimatedMa(), 1) + " mA, " + String(saved, 1) + " mA under fixed " +
+		        String(CpuGovernor::HIGH_MHZ) + " MHz\n";
+	}
+	// Idle light sleep; the current is estimated, the battery trend measured
+	if (g_powerManager) {
+		const PowerManager &pm = *g_powerManager;
+		text += String("Power save: ") + (pm.enabled() ? "on" : "off") + ", asleep " + String(pm.sleepPercent()) +
+		        "% (" + String(pm.sleeps()) + " sleeps)\n";
+		text += "Wakes: UART " + String(pm.wakes(WAKE_UART)) + ", G0 " + String(pm.wakes(WAKE_BUTTON)) + ", timer " +
+		        String(pm.wakes(WAKE_TIMER)) + "\n";
+		text += "Wake to handled: " + String(pm.lastWakeLatencyUs() / 1000.0f, 1) + " ms, max " +
+		        String(pm.maxWakeLatencyUs() / 1000.0f, 1) + " ms\n";
+		text += "Est. current: " + String(pm.estimatedMa(), 1) + " mA\n";
+		int16_t mv = pm.batteryMv();
+		if (mv > 0) {
+			text += "Battery: " + String(mv) + " mV";
+			int32_t trend = pm.batteryMvPerHour();
+			if (trend) text += " (" + String(trend) + " mV/h)";
+			text += "\n";
+		}
+	}
+	computeTextLines(text, M5.Lcd.width() - 32, true);
+	needModalRedraw = true;
+	needsRedraw = true;
+}
+
 void MeshtasticUI::openNewMessagePopup(const String &fromName, const String &content, float snr) {
 	String popupFrom = fromName;
 	String popupContent = content;
 
 	// Always prefer the latest entry in message history to avoid stale popups
 	if (client) {
-		const auto &all = client->getMessageHistory();
+		const auto &all = messages();
 		if (!all.empty()) {
 			const auto &latest = all.back();
 			popupFrom = latest.fromName;
@@ -3933,7 +4530,7 @@ void MeshtasticUI::openNewMessagePopup(const String &fromName, const String &con
 
 			// For MeshCore broadcast messages, the channel name (e.g., Primary)
 			// is already embedded in the message text, so skip prefixing it.
-			if (latest.fromNodeId == 0xFFFFFFFF && client->getDeviceType() == DEVICE_MESHCORE) {
+			if (latest.fromNodeId == 0xFFFFFFFF && snapshot().deviceType == DEVICE_MESHCORE) {
 				popupFrom = "";
 			}
 		}
@@ -3947,9 +4544,9 @@ void MeshtasticUI::openNewMessagePopup(const String &fromName, const String &con
 	// Decide whether the message belongs to the currently viewed conversation
 	bool isMessageForCurrentConversation = false;
 	if (client) {
-		const auto &messages = client->getMessageHistory();
-		if (!messages.empty()) {
-			const auto &latestMsg = messages.back();
+		const auto &history = messages();
+		if (!history.empty()) {
+			const auto &latestMsg = history.back();
 			if (currentDestinationId == 0xFFFFFFFF) {
 				// Broadcast conversation
 				isMessageForCurrentConversation = (latestMsg.toNodeId == 0xFFFFFFFF);
@@ -3975,7 +4572,7 @@ void MeshtasticUI::openNewMessagePopup(const String &fromName, const String &con
 
 void MeshtasticUI::openNodesMenu() {
 	// Check if in text message mode first
-	if (client && client->isTextMessageMode()) {
+	if (snapshot().status.messageMode == MODE_TEXTMSG) {
 		showMessage("Only available in ProtoBuf Mode");
 		return;
 	}
@@ -3996,12 +4593,12 @@ void MeshtasticUI::openNodesMenu() {
 		uint32_t nodeId = visibleNodeIds[nodeSelectedIndex];
 		modalNodeIds = {nodeId};
 		
-		bool isMyNode = (client && nodeId == client->getMyNodeId());
+		bool isMyNode = (client && nodeId == myNodeId());
 		
 		// Don't allow sending messages to self
 		if (!isMyNode) {
 			modalItems.push_back("Send Message");
-			if (client->getDeviceType() != DEVICE_MESHCORE) {
+			if (snapshot().deviceType != DEVICE_MESHCORE) {
 				modalItems.push_back("Trace Route");
 			}
 			modalItems.push_back("Remove");
@@ -4033,7 +4630,7 @@ void MeshtasticUI::openTraceRouteResult(uint32_t targetNodeId, const std::vector
 	// Helper function to get node name with fallback to last 4 hex digits
 	auto getNodeName = [this](uint32_t nodeId) -> String {
 		if (client) {
-			auto* node = client->getNodeById(nodeId);
+			auto* node = findNode(nodeId);
 			if (node) {
 				// Use valid display name logic from client
 				if (!node->shortName.isEmpty() && node->shortName.length() > 0) {
@@ -4117,7 +4714,7 @@ void MeshtasticUI::openTraceRouteResult(uint32_t targetNodeId, const std::vector
 	
 	if (route.size() == 0 && client) {
 		// Direct connection
-		uint32_t myNodeId = client->getMyNodeId();
+		uint32_t myNodeId = this->myNodeId();
 		String directRoute = getNodeName(myNodeId) + " > " + getNodeName(targetNodeId);
 		if (snrValues.size() > 0) {
 			directRoute += "(" + String(snrValues[0], 1) + "dB)";
@@ -4128,7 +4725,7 @@ void MeshtasticUI::openTraceRouteResult(uint32_t targetNodeId, const std::vector
 			modalItems.push_back(line);
 		}
 	} else if (route.size() > 0 && client) {
-		uint32_t myNodeId = client->getMyNodeId();
+		uint32_t myNodeId = this->myNodeId();
 		
 		// Show forward route: Me -> route nodes -> target
 		String forwardRoute = getNodeName(myNodeId);
@@ -4189,14 +4786,14 @@ void MeshtasticUI::openTraceRouteResult(uint32_t targetNodeId, const std::vector
 
 void MeshtasticUI::openBleScanModal() {
 	// Check for Grove/UART connection conflict regardless of selected mode
-	if (client && client->isUARTAvailable()) {
+	if (client && snapshot().status.uartAvailable) {
 		Serial.println("[UI] ERROR: Cannot start BLE scan while Grove/UART connection is active");
 		showError("Cannot scan BLE while Grove is connected");
 		return;
 	}
 
 	// Check if we're already connected via BLE (only block in that case)
-	if (client && client->isDeviceConnected() && client->getConnectionType() == "BLE") {
+	if (client && bleLinkConnected(snapshot())) {
 		Serial.println("[UI] WARNING: Already connected via BLE");
 		showMessage("Already connected to BLE device");
 		return;
@@ -4228,17 +4825,12 @@ void MeshtasticUI::openBleScanModal() {
 	bleLastUiRefresh = bleScanStartTime;
 	bleSelectedIndex = 0;
 	
-	// Start BLE scan through client
+	// Start BLE scan through client; it clears its list first, so only
+	// lists published after this one are fresh
+	bleScanListVersion = snapshot().scanListVersion;
 	if (client) {
-	// Clear client's scan results first to start fresh
-		client->scannedDeviceNames.clear();
-		client->scannedDeviceAddresses.clear();
-		client->scannedDevicePaired.clear();
-	client->scannedDeviceAddrTypes.clear();
-		
 		Serial.println("[UI] Starting BLE scan with cleared state");
-		delay(100); // Shorter delay to reduce blocking
-		client->startBleScan();
+		client->postCommand(MeshtasticClient::CMD_BLE_SCAN_START);
 	}
 	
 	needsRedraw = true;
@@ -4255,10 +4847,8 @@ void MeshtasticUI::openBleScanResultsModal(bool stopScanFirst) {
 	bleScanning = false;
 	bleDisplayIndices.clear();
 	if (client) {
-		if (stopScanFirst) client->stopBleScan();
-		bleDeviceNames = client->getScannedDeviceNames();
-		bleDeviceAddresses = client->getScannedDeviceAddresses();
-		bleDevicePaired = client->getScannedDevicePairedStatus();
+		if (stopScanFirst) client->postCommand(MeshtasticClient::CMD_BLE_SCAN_STOP);
+		copyScanList();
 	}
 
 	// Build display items like drawModal uses
@@ -4290,14 +4880,14 @@ void MeshtasticUI::openBleScanResultsModal(bool stopScanFirst) {
 
 void MeshtasticUI::openManualBleScanModal() {
 	// Check connection type preference - only block if user chose Grove mode AND Grove is active
-	if (currentConnectionType == CONNECTION_GROVE && client && client->isUARTAvailable()) {
+	if (currentConnectionType == CONNECTION_GROVE && client && snapshot().status.uartAvailable) {
 		Serial.println("[UI] ERROR: Cannot start manual BLE scan while in Grove mode with active connection");
 		showError("Switch to Bluetooth mode to scan for BLE devices");
 		return;
 	}
 
 	// Check if we're already connected via BLE (only block in that case)
-	if (client && client->isDeviceConnected() && client->getConnectionType() == "BLE") {
+	if (client && bleLinkConnected(snapshot())) {
 		Serial.println("[UI] WARNING: Already connected via BLE");
 		showMessage("Already connected to BLE device");
 		return;
@@ -4308,23 +4898,15 @@ void MeshtasticUI::openManualBleScanModal() {
 	// Show scanning message with 5.5 second auto-dismiss
 	displayInfo("Scanning for devices (5s)...", 5500);
 	
-	// Start BLE scan through client
+	// Start BLE scan through client; it clears its list first, and a scan
+	// that can't start comes back as an error notice
 	if (client) {
-	// Clear client's scan results first to start fresh
-		client->scannedDeviceNames.clear();
-		client->scannedDeviceAddresses.clear();
-		client->scannedDevicePaired.clear();
-	client->scannedDeviceAddrTypes.clear();
-		
 		Serial.println("[UI] Starting manual BLE scan with cleared state");
-		if (client->startBleScan()) {
-			// Set a flag to show results after 5 seconds
-			manualBleScanActive = true;
-			manualBleScanStartTime = millis();
-			Serial.println("[UI] Manual BLE scan started, will show results after 5s");
-		} else {
-			showError("Failed to start BLE scan");
-		}
+		client->postCommand(MeshtasticClient::CMD_BLE_SCAN_START);
+		// Set a flag to show results after 5 seconds
+		manualBleScanActive = true;
+		manualBleScanStartTime = millis();
+		Serial.println("[UI] Manual BLE scan started, will show results after 5s");
 	} else {
 		showError("Client not available");
 	}
@@ -4336,7 +4918,6 @@ void MeshtasticUI::openBlePinInputModal(const String &deviceName) {
 	modalTitle = "Enter PIN for " + deviceName;
 	
 	// Initialize PIN input
-	blePinInput = "";
 	inputBuffer = "";
 	pendingInputAction = INPUT_NONE;
 	
@@ -4345,17 +4926,25 @@ void MeshtasticUI::openBlePinInputModal(const String &deviceName) {
 
 // Message destination management methods
 void MeshtasticUI::updateMessageDestinations() {
+	if (!client) {
+		messageDestinations.assign(1, 0xFFFFFFFF);
+		return;
+	}
+	uint32_t version = messagesVersion();
+	uint32_t myNodeId = this->myNodeId();
+	if (destinationsValid && destinationsVersion == version && destinationsMyNodeId == myNodeId) return;
+	destinationsValid = true;
+	destinationsVersion = version;
+	destinationsMyNodeId = myNodeId;
+
 	messageDestinations.clear();
 	
 	// Always add broadcast as first option
 	messageDestinations.push_back(0xFFFFFFFF);
 	
-	if (!client) return;
-	
 	// Get all unique destination/source nodes from message history
-	const auto& messages = client->getMessageHistory();
+	const auto& messages = this->messages();
 	std::set<uint32_t> uniqueNodes;
-	uint32_t myNodeId = client->getMyNodeId();
 	
 	for (const auto& msg : messages) {
 		// Add sender if it's not us and not broadcast
@@ -4377,7 +4966,7 @@ void MeshtasticUI::updateMessageDestinations() {
 void MeshtasticUI::showDestinationList() {
 	int y = HEADER_HEIGHT + 6;
 	M5.Lcd.setTextColor(WHITE);
-	const bool meshCoreIds = client && client->getDeviceType() == DEVICE_MESHCORE;
+	const bool meshCoreIds = snapshot().deviceType == DEVICE_MESHCORE;
 	auto formatId = [&](uint32_t id) -> String {
 		char buf[9];
 		uint8_t width = meshCoreIds ? 8 : 4;
@@ -4402,11 +4991,11 @@ void MeshtasticUI::showDestinationList() {
 		String destName;
 		
 		if (nodeId == 0xFFFFFFFF) {
-			String channelName = client ? client->getPrimaryChannelName() : "Default";
+			String channelName = snapshot().primaryChannelName;
 			if (channelName.isEmpty()) channelName = "Default";
 			destName = "Broadcast: " + channelName;
 		} else {
-			const MeshtasticNode* node = client->getNodeById(nodeId);
+			const MeshtasticNode* node = findNode(nodeId);
 			if (node) {
 				// Prefer full (long) name for destination display
 				destName = node->longName.length() ? node->longName : node->shortName;
@@ -4420,7 +5009,9 @@ void MeshtasticUI::showDestinationList() {
 		}
 		
 		// Add message count to destination name
-		int messageCount = client->getMessageCountForDestination(nodeId);
+		int messageCount = (int)std::count_if(messages().begin(), messages().end(), [nodeId](const MeshtasticMessage &m) {
+			return m.toNodeId == nodeId || m.fromNodeId == nodeId;
+		});
 		if (messageCount > 0) {
 			destName += " (" + String(messageCount) + ")";
 		}
@@ -4453,8 +5044,8 @@ void MeshtasticUI::showMessagesForDestination() {
 	M5.Lcd.setTextColor(WHITE);
 	
 	// Get filtered messages for current destination
-	auto filteredMessages = getFilteredMessages();
-	const bool useMeshCoreIds = client && client->getDeviceType() == DEVICE_MESHCORE;
+	const auto &filteredMessages = getFilteredMessages();
+	const bool useMeshCoreIds = snapshot().deviceType == DEVICE_MESHCORE;
 	auto formatId = [&](uint32_t nodeId) -> String {
 		char buf[9];
 		uint8_t width = useMeshCoreIds ? 8 : 4;
@@ -4474,8 +5065,7 @@ void MeshtasticUI::showMessagesForDestination() {
 			drawText("connect device", BORDER_PAD, y + 55);
 		} else {
 			// Device is connected, but no messages for current destination
-			const auto& allMessages = client->getMessageHistory();
-			if (allMessages.empty()) {
+			if (messages().empty()) {
 				// No messages at all
 				drawText("No messages yet", BORDER_PAD, y + 20);
 				drawText("Press OK to send a message", BORDER_PAD, y + 45);
@@ -4510,7 +5100,7 @@ void MeshtasticUI::showMessagesForDestination() {
 	for (size_t i = 0; i < filteredMessages.size(); ++i) {
 		const auto &msg = filteredMessages[i];
 		const bool isMeshCoreBroadcast = client &&
-			(client->getDeviceType() == DEVICE_MESHCORE) &&
+			(snapshot().deviceType == DEVICE_MESHCORE) &&
 			(msg.fromNodeId == 0xFFFFFFFF);
 
 		String senderLabel;
@@ -4584,7 +5174,7 @@ void MeshtasticUI::showMessagesForDestination() {
 	}
 	
 	// Draw message selection indicator at bottom-right in list view
-	auto filteredMessages2 = getFilteredMessages();
+	const auto &filteredMessages2 = getFilteredMessages();
 	if (!filteredMessages2.empty()) {
 		messageSelectedIndex = std::clamp(messageSelectedIndex, 0, (int)filteredMessages2.size() - 1);
 		String indicator = String(messageSelectedIndex + 1) + "/" + String(filteredMessages2.size());
@@ -4619,7 +5209,7 @@ void MeshtasticUI::selectDestination(int index) {
 	
 	// Reset message selection when switching destinations
 	messageSelectedIndex = 0;
-	const bool meshCoreIds = client && client->getDeviceType() == DEVICE_MESHCORE;
+	const bool meshCoreIds = snapshot().deviceType == DEVICE_MESHCORE;
 	auto formatId = [&](uint32_t id) -> String {
 		char buf[9];
 		uint8_t width = meshCoreIds ? 8 : 4;
@@ -4634,11 +5224,11 @@ void MeshtasticUI::selectDestination(int index) {
 	};
 	
 	if (currentDestinationId == 0xFFFFFFFF) {
-		String channelName = client ? client->getPrimaryChannelName() : "Primary";
+		String channelName = snapshot().primaryChannelName;
 		if (channelName.isEmpty()) channelName = "Primary";
 		currentDestinationName = channelName;  // Store channel name only
 	} else {
-		const MeshtasticNode* node = client->getNodeById(currentDestinationId);
+		const MeshtasticNode* node = findNode(currentDestinationId);
 		if (node) {
 			currentDestinationName = node->longName.length() ? node->longName : node->shortName;
 			if (currentDestinationName.isEmpty()) {
@@ -4650,13 +5240,26 @@ void MeshtasticUI::selectDestination(int index) {
 	}
 }
 
-std::vector<struct MeshtasticMessage> MeshtasticUI::getFilteredMessages() {
-	std::vector<struct MeshtasticMessage> filtered;
+const std::vector<MeshtasticMessage> &MeshtasticUI::getFilteredMessages() {
+	// Called several times per frame; the copy is only rebuilt when the
+	// history, the conversation or our own node ID changed
+	uint32_t version = messagesVersion();
+	uint32_t myNodeId = this->myNodeId();
+	if (filteredValid && filteredVersion == version && filteredDestination == currentDestinationId &&
+	    filteredMyNodeId == myNodeId) {
+		return filteredMessages;
+	}
+	filteredValid = true;
+	filteredVersion = version;
+	filteredDestination = currentDestinationId;
+	filteredMyNodeId = myNodeId;
+
+	std::vector<MeshtasticMessage> &filtered = filteredMessages;
+	filtered.clear();
 	
 	if (!client) return filtered;
 	
-	const auto& allMessages = client->getMessageHistory();
-	uint32_t myNodeId = client->getMyNodeId();
+	const auto& allMessages = messages();
 	
 	for (const auto& msg : allMessages) {
 		bool shouldInclude = false;
@@ -4705,6 +5308,8 @@ void MeshtasticUI::openConnectionMenu() {
 		modalItems.push_back("Search Device");
 		modalItems.push_back("Paired Devices");
 		// Don't show Grove options when in Bluetooth mode
+	} else if (currentConnectionType == CONNECTION_WIFI) {
+		modalItems.push_back("Connect via WiFi");
 	} else {
 		modalItems.push_back("Connect via Grove");
 		// Don't show Bluetooth options when in Grove mode
@@ -4769,11 +5374,13 @@ void MeshtasticUI::loadConnectionSettings() {
 			clientPreference = 1; // PREFER_GROVE
 		} else if (currentConnectionType == CONNECTION_BLUETOOTH) {
 			clientPreference = 2; // PREFER_BLUETOOTH  
+		} else if (currentConnectionType == CONNECTION_WIFI) {
+			clientPreference = 3; // PREFER_WIFI
 		} else {
 			clientPreference = 0; // PREFER_AUTO
 		}
 		
-		client->setUserConnectionPreference(clientPreference);
+		client->postValue(MeshtasticClient::CMD_SET_PREFERENCE, clientPreference);
 		Serial.printf("[UI] Set client user preference to: %d (UI type: %d)\n", clientPreference, (int)currentConnectionType);
 	}
 }
@@ -4792,7 +5399,7 @@ void MeshtasticUI::attemptAutoConnection() {
 		
 		// Grove/UART auto-connection - client.begin() already initializes UART
 		Serial.println("[UI] Grove mode - UART will auto-initialize");
-		if (client->isUARTAvailable()) {
+		if (snapshot().status.uartAvailable) {
 			Serial.println("[UI] UART already connected");
 			displaySuccess("Grove connected");
 		} else {
@@ -4819,27 +5426,45 @@ void MeshtasticUI::attemptAutoConnection() {
 			displayInfo("Search Bluetooth...");
 		}
 		// 让启动序列负责在 2s 后显示提示并开始扫描，5s 后展示结果
+	} else if (currentConnectionType == CONNECTION_WIFI) {
+		connectionInfo += "WiFi TCP";
+		displayInfo(connectionInfo);
+		// Reconnect to the saved radio if there is one; otherwise wait for Settings
+		if (!snapshot().status.wifiSsid.isEmpty() && !snapshot().status.tcpHost.isEmpty()) {
+			Serial.printf("[UI] WiFi mode - connecting to %s via '%s'\n",
+					  snapshot().status.tcpHost.c_str(), snapshot().status.wifiSsid.c_str());
+			client->postCommand(MeshtasticClient::CMD_CONNECT_TCP);
+		} else {
+			Serial.println("[UI] WiFi mode - no network/host saved yet");
+		}
 	}
 }
 
 bool MeshtasticUI::hasUsableConnection() const {
-	return client && client->hasActiveTransport();
+	return client && snapshot().connected;
 }
 
 // ========== BLE PIN Dialog Methods ==========
 
 void MeshtasticUI::showPinInputModal() {
 	Serial.println("[UI] Showing PIN input dialog for BLE pairing");
+	// Whatever dialog is open makes way for the PIN
+	if (isModalActive()) closeModal();
+	// Clear any pending connection states that might interfere
+	bleConnectionPending = false;
+
 	modalType = 5;  // Use fullscreen input style  
 	modalContext = MODAL_BLE_PIN_INPUT;
 	modalTitle = "Enter BLE PIN";
+	modalInfo = "Enter 6-digit PIN shown on Meshtastic device";
 	
 	// Initialize PIN input
-	blePinInput = "";
 	inputBuffer = "";
-	pendingInputAction = INPUT_NONE;
+	pendingInputAction = INPUT_ENTER_BLE_PIN;  // Set action for Enter key
 	
+	needModalRedraw = true;
 	needsRedraw = true;
+	needImmediateModalRedraw = true;  // Urgent display needed
 }
 
 void MeshtasticUI::showPinConfirmModal(uint32_t passkey) {
@@ -0,0 +1,94 @@
+// Host benchmark for the receive path: StreamFramer over a serial-like byte
+// stream, and draining SimTransport in poll() chunks. Numbers are for
+// comparing changes on one machine, not for predicting the ESP32.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "transport.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Frames of mixed sizes, like a node DB download, with a console line every
+// so often, as with the radio's serial logging on
+std::vector<uint8_t> makeStream(size_t frames, bool withText) {
+    static const size_t SIZES[] = {24, 60, 96, 180, 240, 320};
+    static const char LINE[] = "INFO  | 12:00:00 42 [Router] Received packet\r\n";
+    std::vector<uint8_t> bytes;
+    uint8_t payload[MAX_PACKET_SIZE];
+    for (size_t i = 0; i < MAX_PACKET_SIZE; i++) payload[i] = (uint8_t)(i * 7);
+    for (size_t i = 0; i < frames; i++) {
+        size_t len = SIZES[i % (sizeof(SIZES) / sizeof(SIZES[0]))];
+        uint8_t header[STREAM_HEADER_SIZE];
+        StreamFramer::writeHeader(header, len);
+        bytes.insert(bytes.end(), header, header + STREAM_HEADER_SIZE);
+        bytes.insert(bytes.end(), payload, payload + len);
+        if (withText && i % 8 == 0) bytes.insert(bytes.end(), LINE, LINE + sizeof(LINE) - 1);
+    }
+    return bytes;
+}
+
+// Pushes the stream readSize bytes at a time, taking frames after each read
+void benchFramer(const char *label, const std::vector<uint8_t> &stream, size_t readSize, size_t expect) {
+    const int rounds = 20;
+    size_t frames = 0;
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        StreamFramer fr;
+        std::vector<uint8_t> out;
+        std::string line;
+        for (size_t off = 0; off < stream.size(); off += readSize) {
+            size_t n = stream.size() - off < readSize ? stream.size() - off : readSize;
+            fr.push(stream.data() + off, n);
+            while (fr.next(out)) frames++;
+            while (fr.nextLine(line)) {
+            }
+        }
+    }
+    double s = secondsSince(start);
+    double mb = (double)stream.size() * rounds / 1e6;
+    std::printf("framer %-14s read=%4zu B  %8.1f MB/s  %6.0f ns/frame%s\n", label, readSize, mb / s,
+                s * 1e9 / frames, frames == expect * rounds ? "" : "  (frame count mismatch!)");
+}
+
+// Drains n injected frames chunk frames per poll()
+void benchDrain(size_t n, size_t chunk) {
+    std::vector<uint8_t> payload(96, 0x5A);
+    const int rounds = 20;
+    size_t polls = 0;
+    double total = 0;
+    for (int r = 0; r < rounds; r++) {
+        SimTransport sim;
+        for (size_t i = 0; i < n; i++) sim.inject(payload);
+        std::vector<std::vector<uint8_t>> out;
+        out.reserve(chunk);
+        auto start = Clock::now();
+        for (;;) {
+            out.clear();
+            size_t got = sim.poll(out, chunk);
+            polls++;
+            if (!got) break;
+        }
+        total += secondsSince(start);
+    }
+    std::printf("drain  %zu frames chunk=%-3zu  %6.0f ns/frame  %5zu polls/round\n", n, chunk,
+                total * 1e9 / (n * rounds), polls / rounds);
+}
+} // namespace
+
+int main() {
+    const size_t frames = 20000;
+    auto clean = makeStream(frames, false);
+    auto noisy = makeStream(frames, true);
+    for (size_t readSize : {64, 256, 1024}) {
+        benchFramer("frames", clean, readSize, frames);
+        benchFramer("frames+console", noisy, readSize, frames);
+    }
+    for (size_t chunk : {1, 4, 16, 64}) benchDrain(4096, chunk);
+    return 0;
+}
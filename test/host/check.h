@@ -0,0 +1,30 @@
+// Minimal assertions for the host tests: a failed CHECK reports and counts,
+// the test binary exits non-zero if any failed.
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <cstdio>
+
+inline int &checkFailures() {
+    static int n = 0;
+    return n;
+}
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            checkFailures()++;                                                \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+
+#define RUN_TEST(fn)                             \
+    do {                                         \
+        int before = checkFailures();            \
+        fn();                                    \
+        std::printf("%s %s\n", checkFailures() == before ? "PASS" : "FAIL", #fn); \
+    } while (0)
+
+#endif // HOST_CHECK_H
@@ -0,0 +1,72 @@
+// Stand-in for a WiFi radio's TCP API on 127.0.0.1: accepts one client,
+// writes raw bytes to it and collects what it sends. Blocking sockets; the
+// tests drive both ends from one thread.
+#ifndef FAKE_RADIO_H
+#define FAKE_RADIO_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdint>
+#include <vector>
+
+class FakeRadio {
+public:
+    FakeRadio() {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;  // Any free port
+        bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        listen(listener, 1);
+        socklen_t len = sizeof(addr);
+        getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &len);
+        boundPort = ntohs(addr.sin_port);
+    }
+    ~FakeRadio() {
+        drop();
+        if (listener >= 0) ::close(listener);
+    }
+
+    uint16_t port() const { return boundPort; }
+    bool accept() {
+        client = ::accept(listener, nullptr, nullptr);
+        return client >= 0;
+    }
+    void write(const std::vector<uint8_t> &bytes) {
+        size_t off = 0;
+        while (off < bytes.size()) {
+            ssize_t n = ::send(client, bytes.data() + off, bytes.size() - off, 0);
+            if (n <= 0) return;
+            off += n;
+        }
+    }
+    // Reads until want bytes have arrived (or the client closes)
+    std::vector<uint8_t> read(size_t want) {
+        std::vector<uint8_t> got(want);
+        size_t off = 0;
+        while (off < want) {
+            ssize_t n = recv(client, got.data() + off, want - off, 0);
+            if (n <= 0) break;
+            off += n;
+        }
+        got.resize(off);
+        return got;
+    }
+    // Closes the accepted connection, as a radio rebooting would
+    void drop() {
+        if (client >= 0) ::close(client);
+        client = -1;
+    }
+
+private:
+    int listener = -1;
+    int client = -1;
+    uint16_t boundPort = 0;
+};
+
+#endif // FAKE_RADIO_H
@@ -0,0 +1,151 @@
+// TcpTransport against a local stand-in radio
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "check.h"
+#include "fake_radio.h"
+#include "tcp_transport.h"
+
+namespace {
+std::vector<uint8_t> framed(size_t len, uint8_t first) {
+    std::vector<uint8_t> f(STREAM_HEADER_SIZE + len);
+    StreamFramer::writeHeader(f.data(), len);
+    for (size_t i = 0; i < len; i++) f[STREAM_HEADER_SIZE + i] = (uint8_t)(first + i);
+    return f;
+}
+
+void sleepMs(int ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// Services the transport until the connect resolves either way
+TransportState waitConnect(TcpTransport &t) {
+    for (int i = 0; i < 200 && t.isConnecting(); i++) {
+        t.service();
+        if (t.isConnecting()) sleepMs(5);
+    }
+    return t.state();
+}
+
+bool connectTo(TcpTransport &t, FakeRadio &radio) {
+    if (!t.open("127.0.0.1", radio.port())) return false;
+    if (!radio.accept()) return false;
+    return waitConnect(t) == TRANSPORT_UP;
+}
+
+void testSendAndReceive() {
+    FakeRadio radio;
+    TcpTransport t;
+    CHECK(connectTo(t, radio));
+    CHECK(t.isUp());
+
+    uint8_t frame[STREAM_HEADER_SIZE + 3] = {0, 0, 0, 0, 7, 8, 9};
+    CHECK(t.send(frame, 3));
+    auto got = radio.read(STREAM_HEADER_SIZE + 3);
+    CHECK_EQ(got.size(), (size_t)(STREAM_HEADER_SIZE + 3));
+    CHECK_EQ(got[0], STREAM_START1);
+    CHECK_EQ(got[1], STREAM_START2);
+    CHECK_EQ(got[3], 3);
+    CHECK_EQ(got[6], 9);
+
+    radio.write(framed(20, 1));
+    std::vector<std::vector<uint8_t>> out;
+    for (int i = 0; i < 100 && out.empty(); i++) {
+        t.poll(out, 4);
+        if (out.empty()) sleepMs(5);
+    }
+    CHECK_EQ(out.size(), 1u);
+    if (!out.empty()) {
+        CHECK_EQ(out[0].size(), 20u);
+        CHECK_EQ(out[0][19], 20);
+    }
+    CHECK(t.isUp());
+}
+
+void testFramesAheadOfCloseAreDelivered() {
+    FakeRadio radio;
+    TcpTransport t;
+    CHECK(connectTo(t, radio));
+    std::vector<uint8_t> burst;
+    for (uint8_t i = 0; i < 5; i++) {
+        auto f = framed(10, i);
+        burst.insert(burst.end(), f.begin(), f.end());
+    }
+    radio.write(burst);
+    radio.drop();
+    sleepMs(20);
+
+    // One frame per poll, as a capped drain would take them
+    std::vector<std::vector<uint8_t>> out;
+    for (int i = 0; i < 100 && t.state() == TRANSPORT_UP; i++) {
+        if (!t.poll(out, 1)) sleepMs(5);
+    }
+    CHECK_EQ(out.size(), 5u);
+    for (size_t i = 0; i < out.size(); i++) CHECK_EQ(out[i][0], (uint8_t)i);
+    CHECK_EQ(t.state(), TRANSPORT_ERROR);
+    CHECK(!t.isOpen());
+}
+
+void testPartialFrameAtCloseIsDropped() {
+    FakeRadio radio;
+    TcpTransport t;
+    CHECK(connectTo(t, radio));
+    auto f = framed(30, 0);
+    f.resize(f.size() - 5);
+    radio.write(f);
+    radio.drop();
+    sleepMs(20);
+
+    std::vector<std::vector<uint8_t>> out;
+    for (int i = 0; i < 100 && t.state() == TRANSPORT_UP; i++) {
+        if (!t.poll(out, 4)) sleepMs(5);
+    }
+    CHECK(out.empty());
+    CHECK_EQ(t.state(), TRANSPORT_ERROR);
+}
+
+void testHostnamesRefused() {
+    CHECK(TcpTransport::isNumericHost("192.168.1.50"));
+    CHECK(!TcpTransport::isNumericHost("meshtastic.local"));
+    CHECK(!TcpTransport::isNumericHost(""));
+    CHECK(!TcpTransport::isNumericHost(nullptr));
+    TcpTransport t;
+    CHECK(!t.open("localhost", MESHTASTIC_TCP_PORT));
+    CHECK_EQ(t.state(), TRANSPORT_ERROR);
+}
+
+void testResolveHost() {
+    char ip[16];
+    CHECK(TcpTransport::resolveHost("192.168.1.50", ip, sizeof(ip)));
+    CHECK(strcmp(ip, "192.168.1.50") == 0);
+    CHECK(TcpTransport::resolveHost("localhost", ip, sizeof(ip)));
+    CHECK(TcpTransport::isNumericHost(ip));
+    CHECK(!TcpTransport::resolveHost("", ip, sizeof(ip)));
+    char small[8];
+    CHECK(!TcpTransport::resolveHost("127.0.0.1", small, sizeof(small)));
+}
+
+void testRefusedConnect() {
+    uint16_t port;
+    {
+        FakeRadio gone;
+        port = gone.port();
+    }
+    TcpTransport t;
+    // Loopback may refuse at once or report it through service()
+    bool started = t.open("127.0.0.1", port);
+    if (started) waitConnect(t);
+    CHECK_EQ(t.state(), TRANSPORT_ERROR);
+    uint8_t frame[STREAM_HEADER_SIZE + 1] = {0, 0, 0, 0, 1};
+    CHECK(!t.send(frame, 1));
+}
+} // namespace
+
+int main() {
+    RUN_TEST(testSendAndReceive);
+    RUN_TEST(testFramesAheadOfCloseAreDelivered);
+    RUN_TEST(testPartialFrameAtCloseIsDropped);
+    RUN_TEST(testHostnamesRefused);
+    RUN_TEST(testResolveHost);
+    RUN_TEST(testRefusedConnect);
+    return checkFailures() ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+// StreamFramer and SimTransport on the host
+#include <cstring>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "transport.h"
+
+namespace {
+// A framed payload of len bytes counting up from first
+std::vector<uint8_t> framed(size_t len, uint8_t first = 0) {
+    std::vector<uint8_t> f(STREAM_HEADER_SIZE + len);
+    StreamFramer::writeHeader(f.data(), len);
+    for (size_t i = 0; i < len; i++) f[STREAM_HEADER_SIZE + i] = (uint8_t)(first + i);
+    return f;
+}
+
+void push(StreamFramer &fr, const std::vector<uint8_t> &bytes) { fr.push(bytes.data(), bytes.size()); }
+
+void push(StreamFramer &fr, const char *text) { fr.push((const uint8_t *)text, strlen(text)); }
+
+void testSingleFrame() {
+    StreamFramer fr;
+    push(fr, framed(5, 10));
+    std::vector<uint8_t> out;
+    CHECK(fr.next(out));
+    CHECK_EQ(out.size(), 5u);
+    CHECK_EQ(out[0], 10);
+    CHECK_EQ(out[4], 14);
+    CHECK(!fr.next(out));
+    CHECK(fr.empty());
+}
+
+void testFrameSplitAcrossPushes() {
+    StreamFramer fr;
+    auto f = framed(300);
+    std::vector<uint8_t> out;
+    // One byte at a time, header included
+    for (size_t i = 0; i + 1 < f.size(); i++) {
+        fr.push(&f[i], 1);
+        CHECK(!fr.hasFrame());
+    }
+    fr.push(&f.back(), 1);
+    CHECK(fr.next(out));
+    CHECK_EQ(out.size(), 300u);
+    CHECK_EQ(out[299], (uint8_t)299);
+}
+
+void testBackToBackFrames() {
+    StreamFramer fr;
+    std::vector<uint8_t> bytes;
+    for (uint8_t i = 0; i < 8; i++) {
+        auto f = framed(1 + i, i);
+        bytes.insert(bytes.end(), f.begin(), f.end());
+    }
+    push(fr, bytes);
+    std::vector<uint8_t> out;
+    for (uint8_t i = 0; i < 8; i++) {
+        CHECK(fr.next(out));
+        CHECK_EQ(out.size(), (size_t)(1 + i));
+        CHECK_EQ(out[0], i);
+    }
+    CHECK(!fr.next(out));
+}
+
+void testHasFrameLeavesFrameBuffered() {
+    StreamFramer fr;
+    push(fr, framed(3));
+    CHECK(fr.hasFrame());
+    CHECK(fr.hasFrame());
+    CHECK_EQ(fr.buffered(), (size_t)(STREAM_HEADER_SIZE + 3));
+    std::vector<uint8_t> out;
+    CHECK(fr.next(out));
+    CHECK_EQ(out.size(), 3u);
+    CHECK(!fr.hasFrame());
+}
+
+void testConsoleTextBetweenFrames() {
+    StreamFramer fr;
+    push(fr, "\x1b[34mINFO\x1b[0m | boot\r\n");
+    push(fr, framed(2));
+    push(fr, "DEBUG | tail\n");
+    std::vector<uint8_t> out;
+    CHECK(fr.next(out));
+    CHECK_EQ(out.size(), 2u);
+    CHECK(!fr.next(out));
+    std::string line;
+    CHECK(fr.nextLine(line));
+    CHECK_EQ(line, std::string("INFO | boot"));
+    CHECK(fr.nextLine(line));
+    CHECK_EQ(line, std::string("DEBUG | tail"));
+    CHECK(!fr.nextLine(line));
+    CHECK_EQ(fr.takeDiscarded(), 0u);
+}
+
+void testLongLinesSplitAndOldestDropped() {
+    StreamFramer fr;
+    std::string longLine(StreamFramer::MAX_LINE + 10, 'x');
+    longLine += "\n";
+    push(fr, longLine.c_str());
+    for (size_t i = 0; i < StreamFramer::MAX_QUEUED_LINES; i++) push(fr, "more\n");
+    std::vector<uint8_t> out;
+    CHECK(!fr.next(out));
+    // MAX_LINE chars, the 10 left over, then the short lines; the first two dropped
+    CHECK_EQ(fr.droppedLines(), 2u);
+    std::string line;
+    size_t n = 0;
+    while (fr.nextLine(line)) {
+        CHECK_EQ(line, std::string("more"));
+        n++;
+    }
+    CHECK_EQ(n, StreamFramer::MAX_QUEUED_LINES);
+}
+
+void testResyncAfterCorruptHeader() {
+    StreamFramer fr;
+    // START1 with a bad second byte, then a header claiming an impossible length
+    std::vector<uint8_t> bytes = {STREAM_START1, 0x00, STREAM_START1, STREAM_START2, 0xFF, 0xFF};
+    auto f = framed(4, 7);
+    bytes.insert(bytes.end(), f.begin(), f.end());
+    push(fr, bytes);
+    std::vector<uint8_t> out;
+    CHECK(fr.next(out));
+    CHECK_EQ(out.size(), 4u);
+    CHECK_EQ(out[0], 7);
+    CHECK(fr.takeDiscarded() >= 2u);
+}
+
+void testResetDropsPartialFrame() {
+    StreamFramer fr;
+    auto f = framed(10);
+    fr.push(f.data(), 6);
+    fr.reset();
+    fr.push(f.data() + 6, f.size() - 6);
+    std::vector<uint8_t> out;
+    CHECK(!fr.next(out));
+    push(fr, framed(1));
+    CHECK(fr.next(out));
+    CHECK_EQ(out.size(), 1u);
+}
+
+void testSimLoopback() {
+    SimTransport sim;
+    CHECK(sim.isUp());
+    uint8_t frame[STREAM_HEADER_SIZE + 3] = {0, 0, 0, 0, 1, 2, 3};
+    CHECK(sim.send(frame, 3));
+    CHECK_EQ(sim.sent.size(), 1u);
+    CHECK_EQ(sim.sent[0].size(), 3u);
+    CHECK_EQ(sim.sent[0][2], 3);
+    CHECK_EQ(sim.stats().txFrames, 1u);
+
+    for (uint8_t i = 0; i < 5; i++) sim.inject(std::vector<uint8_t>{i, i});
+    std::vector<std::vector<uint8_t>> out;
+    CHECK_EQ(sim.poll(out, 3), 3u);
+    CHECK_EQ(sim.poll(out, 8), 2u);
+    CHECK_EQ(sim.poll(out, 8), 0u);
+    CHECK_EQ(out.size(), 5u);
+    CHECK_EQ(out[4][0], 4);
+    CHECK_EQ(sim.stats().rxFrames, 5u);
+    CHECK_EQ(sim.stats().rxBytes, 10u);
+}
+
+void testSimFailuresAndDown() {
+    SimTransport sim;
+    uint8_t frame[STREAM_HEADER_SIZE + 1] = {0, 0, 0, 0, 9};
+    sim.failNextSends(2);
+    CHECK(!sim.send(frame, 1));
+    CHECK(!sim.send(frame, 1));
+    CHECK(sim.send(frame, 1));
+    CHECK_EQ(sim.stats().txErrors, 2u);
+    CHECK(!sim.send(frame, 0));
+    CHECK(!sim.send(frame, MAX_PACKET_SIZE + 1));
+
+    sim.inject(std::vector<uint8_t>{1});
+    sim.setUp(false);
+    CHECK(!sim.isUp());
+    CHECK(!sim.send(frame, 1));
+    std::vector<std::vector<uint8_t>> out;
+    CHECK_EQ(sim.poll(out, 4), 0u);
+    // Input waits for the link to come back
+    sim.setUp(true);
+    CHECK_EQ(sim.poll(out, 4), 1u);
+}
+} // namespace
+
+int main() {
+    RUN_TEST(testSingleFrame);
+    RUN_TEST(testFrameSplitAcrossPushes);
+    RUN_TEST(testBackToBackFrames);
+    RUN_TEST(testHasFrameLeavesFrameBuffered);
+    RUN_TEST(testConsoleTextBetweenFrames);
+    RUN_TEST(testLongLinesSplitAndOldestDropped);
+    RUN_TEST(testResyncAfterCorruptHeader);
+    RUN_TEST(testResetDropsPartialFrame);
+    RUN_TEST(testSimLoopback);
+    RUN_TEST(testSimFailuresAndDown);
+    return checkFailures() ? 1 : 0;
+}